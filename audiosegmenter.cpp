@@ -19,10 +19,15 @@ AudioSegmenter::~AudioSegmenter() {
 
 void AudioSegmenter::writeAudio(const QVector<sample> &data) {
     if (data.size() > m_bufferSize) {
+        PE_COUNT(DroppedSamples, data.size());
         emit error("AudioSegmenter: Přijatá data jsou větší než buffer. V lepším případě to skončí špatně, v horším to padne na SIGSEGV.");
         return;
     }
 
+    PE_COUNT(ReceivedSamples, data.size());
+    if (bufferedCount() + data.size() >= m_bufferSize)
+        PE_COUNT(BufferOverruns, 1);
+
     int newPosition = m_next + data.size();
     if (newPosition > m_bufferSize) {
         int restCount = m_bufferSize - m_next;
@@ -34,6 +39,8 @@ void AudioSegmenter::writeAudio(const QVector<sample> &data) {
     else memcpy(m_buffer + m_next, data.constData(), static_cast<size_t>(data.size()) * sizeof(sample));
 
     m_next = newPosition % m_bufferSize;
+
+    PE_BUFFER_FILL(SegmenterBuffer, bufferedCount(), m_bufferSize - 1);
 }
 
 bool AudioSegmenter::hasNextSegment() {
@@ -66,6 +73,8 @@ QVector<sample> AudioSegmenter::nextSegment() {
 
     m_first = (m_first + m_overlapSupp) % m_bufferSize;
 
+    PE_BUFFER_FILL(SegmenterBuffer, bufferedCount(), m_bufferSize - 1);
+
     return segment;
 }
 
@@ -91,3 +100,7 @@ QVector<sample> AudioSegmenter::flush() {
 bool AudioSegmenter::isEmpty() {
     return m_first == m_next;
 }
+
+int AudioSegmenter::bufferedCount() const {
+    return (m_first <= m_next) ? m_next - m_first : m_bufferSize - m_first + m_next;
+}
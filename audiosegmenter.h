@@ -5,6 +5,7 @@
 #include <QVector>
 
 #include "pe_config.h"
+#include "instrumentation.h"
 
 /*!
  * \brief Třída AudioSegmenter
@@ -66,6 +67,12 @@ private:
     int m_segmentSize;              //!< Velikost vytvářených oken.
     int m_overlapSupp;              //!< Počet prvků tvořící první část výsledného segmentu (m_segmentSize - overlap).
 
+    /*!
+     * \brief bufferedCount Metoda vrací počet vzorků, které jsou v bufferu připraveny ke zpracování.
+     * \return Počet připravených vzorků.
+     */
+    int bufferedCount() const;
+
     /*!
      * \brief flush Metoda z bufferu extrahuje zbývající data, která doloží nulami na požadovanou velikost segmentu a vyprázdní
      *              buffer. Tato metoda je vnitřně volána metodou AudioSegmenter::nextSegment.
@@ -0,0 +1,59 @@
+#include "benchdata.h"
+
+#include <QFile>
+#include <QDataStream>
+#include <QtMath>
+
+QVector<sample> syntheticSignal(int size) {
+    QVector<sample> signal(size);
+    quint32 seed = 12345;
+
+    for (int i = 0; i < size; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = static_cast<float>(static_cast<int>(seed >> 16) - 32768) / 32768.0f;
+        float tone = qSin(2.0f * static_cast<float>(M_PI) * 440.0f * i / SAMPLE_RATE);
+
+        signal[i] = static_cast<sample>(8000.0f * tone + 2000.0f * noise);
+    }
+
+    return signal;
+}
+
+QVector<sample> whiteNoise(int segmentSize, int size) {
+    QFile file(QString("%1/noise_%2.raw").arg(PE_BENCH_DATA_DIR).arg(segmentSize));
+    if (!file.open(QIODevice::ReadOnly))
+        return syntheticSignal(size);
+
+    /* Stejné čtení jako v SegmentRecover::loadWhiteNoise. */
+    QDataStream reader(&file);
+    QVector<sample> noise;
+    noise.reserve(static_cast<int>(file.size() / static_cast<qint64>(sizeof(sample))));
+
+    sample val;
+    while (!reader.atEnd()) {
+        reader >> val;
+        noise.append(val);
+    }
+
+    if (noise.isEmpty())
+        return syntheticSignal(size);
+
+    QVector<sample> signal(size);
+    for (int i = 0; i < size; i++)
+        signal[i] = noise[i % noise.size()];
+
+    return signal;
+}
+
+QVector<QVector<float>> syntheticMfccs(int count) {
+    QVector<QVector<float>> mfccs(count);
+
+    for (int i = 0; i < count; i++) {
+        mfccs[i].resize(MFCC_COUNT);
+
+        for (int j = 0; j < MFCC_COUNT; j++)
+            mfccs[i][j] = qSin(static_cast<float>(i * MFCC_COUNT + j));
+    }
+
+    return mfccs;
+}
@@ -0,0 +1,41 @@
+#ifndef BENCHDATA_H
+#define BENCHDATA_H
+
+#include <QVector>
+#include <QString>
+
+#include "../pe_config.h"
+
+/*!
+ * Adresář se soubory bílého šumu (noise_<velikost>.raw). Při sestavení jej lze přepsat
+ * definicí PE_BENCH_DATA_DIR, jinak se hledá relativně k pracovnímu adresáři.
+ */
+#ifndef PE_BENCH_DATA_DIR
+#define PE_BENCH_DATA_DIR "reconstruction/white_noise"
+#endif
+
+/*!
+ * \brief syntheticSignal Vytvoří deterministický syntetický signál (tón 440 Hz s pseudonáhodným šumem).
+ * \param size Počet vzorků signálu.
+ * \return Vektor vzorků signálu.
+ */
+QVector<sample> syntheticSignal(int size);
+
+/*!
+ * \brief whiteNoise Načte bílý šum ze souboru noise_<segmentSize>.raw v adresáři PE_BENCH_DATA_DIR a zopakuje
+ *                   jej na požadovanou délku. Pokud soubor neexistuje, vrátí syntetický signál, aby bylo možné
+ *                   měřit i bez přiložených dat.
+ * \param segmentSize Velikost segmentu, podle které je vybrán soubor bílého šumu.
+ * \param size Počet vzorků výsledného signálu.
+ * \return Vektor vzorků signálu.
+ */
+QVector<sample> whiteNoise(int segmentSize, int size);
+
+/*!
+ * \brief syntheticMfccs Vytvoří vektory MFC koeficientů (po MFCC_COUNT prvcích) pro měření souborových operací.
+ * \param count Počet vektorů.
+ * \return Vektory MFC koeficientů.
+ */
+QVector<QVector<float>> syntheticMfccs(int count);
+
+#endif
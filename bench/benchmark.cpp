@@ -0,0 +1,144 @@
+#include "benchmark.h"
+
+#include <QCoreApplication>
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+namespace {
+
+struct Registration {
+    const char *name;
+    BenchmarkFunction function;
+    QVector<int> args;
+};
+
+QVector<Registration> &registry() {
+    static QVector<Registration> benchmarks;
+    return benchmarks;
+}
+
+QString argsToString(const QVector<int> &args) {
+    QString result;
+
+    for (int arg : args)
+        result += QString("/%1").arg(arg);
+
+    return result;
+}
+
+}
+
+BenchmarkState::BenchmarkState(const QVector<int> &args, qint64 iterations) {
+    m_args = args;
+    m_iterations = iterations;
+    m_remaining = iterations;
+    m_frames = 0;
+    m_elapsed = 0;
+    m_started = false;
+}
+
+bool BenchmarkState::keepRunning() {
+    if (!m_started) {
+        m_started = true;
+        m_start = Clock::now();
+    }
+
+    if (m_remaining-- > 0)
+        return true;
+
+    pauseTiming();
+    return false;
+}
+
+int BenchmarkState::range(int i) const {
+    return (i >= 0 && i < m_args.size()) ? m_args[i] : 0;
+}
+
+qint64 BenchmarkState::iterations() const {
+    return m_iterations;
+}
+
+void BenchmarkState::setFramesProcessed(qint64 frames) {
+    m_frames = frames;
+}
+
+qint64 BenchmarkState::framesProcessed() const {
+    return m_frames;
+}
+
+void BenchmarkState::pauseTiming() {
+    m_elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_start).count();
+}
+
+void BenchmarkState::resumeTiming() {
+    m_start = Clock::now();
+}
+
+qint64 BenchmarkState::elapsedNs() const {
+    return m_elapsed;
+}
+
+int registerBenchmark(const char *name, BenchmarkFunction function, const QVector<QVector<int>> &args) {
+    if (args.isEmpty()) {
+        registry().append({ name, function, QVector<int>() });
+        return 0;
+    }
+
+    for (const QVector<int> &set : args)
+        registry().append({ name, function, set });
+
+    return 0;
+}
+
+/*
+ * Spuštění: bench [filtr] [--min-time=sekundy]
+ * Filtr je podřetězec názvu měření, měří se pouze odpovídající měření. Měření rekonstrukce
+ * (SegmentRecover) očekává soubory bílého šumu v adresáři se spustitelným souborem.
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv); // kvůli QCoreApplication::applicationDirPath (SegmentRecover)
+
+    const char *filter = nullptr;
+    double minTime = 0.5;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--min-time=", 11) == 0)
+            minTime = atof(argv[i] + 11);
+        else
+            filter = argv[i];
+    }
+
+    printf("%-48s %14s %14s %14s\n", "Benchmark", "Iterations", "ns/frame", "frames/s");
+
+    for (const Registration &reg : registry()) {
+        QString name = QString(reg.name) + argsToString(reg.args);
+
+        if (filter && !strstr(qPrintable(name), filter))
+            continue;
+
+        /* Zvyšování počtu iterací, dokud měření netrvá alespoň minTime. */
+        qint64 iterations = 1;
+        qint64 minTimeNs = static_cast<qint64>(minTime * 1e9);
+
+        while (true) {
+            BenchmarkState state(reg.args, iterations);
+            reg.function(state);
+
+            if (state.elapsedNs() >= minTimeNs || iterations >= (1LL << 40)) {
+                qint64 frames = state.framesProcessed() > 0 ? state.framesProcessed() : state.iterations();
+                double nsPerFrame = static_cast<double>(state.elapsedNs()) / static_cast<double>(frames);
+
+                printf("%-48s %14lld %14.1f %14.0f\n", qPrintable(name), static_cast<long long>(state.iterations()),
+                       nsPerFrame, 1e9 / nsPerFrame);
+                break;
+            }
+
+            qint64 multiplier = (state.elapsedNs() > 0) ? (minTimeNs * 14 / 10) / state.elapsedNs() : 10;
+            iterations *= qBound<qint64>(2, multiplier, 10);
+        }
+    }
+
+    return 0;
+}
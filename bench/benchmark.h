@@ -0,0 +1,115 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QVector>
+#include <QString>
+
+#include <chrono>
+
+/*!
+ * \brief Třída BenchmarkState
+ *
+ * Stav jednoho běhu měřené funkce. Rozhraní vychází z knihovny Google Benchmark: měřená funkce v cyklu
+ * volá keepRunning() a po jeho skončení nastaví počet zpracovaných segmentů (framů) metodou setFramesProcessed.
+ * Z nich se pak počítají hodnoty ns/frame a frames/s.
+ */
+class BenchmarkState {
+public:
+    /*!
+     * \brief BenchmarkState Konstruktor třídy.
+     * \param args Parametry měření (velikost segmentu, překryv, ...).
+     * \param iterations Požadovaný počet iterací měřené smyčky.
+     */
+    BenchmarkState(const QVector<int> &args, qint64 iterations);
+
+    /*!
+     * \brief keepRunning Metoda řídí měřenou smyčku. Při prvním volání spustí měření času, při posledním jej zastaví.
+     * \return True, pokud má smyčka pokračovat, jinak false.
+     */
+    bool keepRunning();
+
+    /*!
+     * \brief range Vrací zadaný parametr měření.
+     * \param i Index parametru.
+     * \return Hodnota parametru nebo 0, pokud parametr neexistuje.
+     */
+    int range(int i) const;
+
+    /*!
+     * \brief iterations Vrací počet iterací měřené smyčky.
+     * \return Počet iterací.
+     */
+    qint64 iterations() const;
+
+    /*!
+     * \brief setFramesProcessed Nastaví celkový počet zpracovaných segmentů během měření.
+     * \param frames Počet zpracovaných segmentů.
+     */
+    void setFramesProcessed(qint64 frames);
+
+    /*!
+     * \brief framesProcessed Vrací celkový počet zpracovaných segmentů během měření.
+     * \return Počet zpracovaných segmentů.
+     */
+    qint64 framesProcessed() const;
+
+    /*!
+     * \brief pauseTiming Pozastaví měření času (například kvůli přípravě dat uvnitř smyčky).
+     */
+    void pauseTiming();
+
+    /*!
+     * \brief resumeTiming Obnoví pozastavené měření času.
+     */
+    void resumeTiming();
+
+    /*!
+     * \brief elapsedNs Vrací naměřený čas v nanosekundách.
+     * \return Naměřený čas.
+     */
+    qint64 elapsedNs() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    QVector<int> m_args;            //!< Parametry měření.
+    qint64 m_iterations;            //!< Požadovaný počet iterací.
+    qint64 m_remaining;             //!< Počet zbývajících iterací.
+    qint64 m_frames;                //!< Počet zpracovaných segmentů.
+    qint64 m_elapsed;               //!< Naměřený čas v nanosekundách.
+    bool m_started;                 //!< True, pokud již bylo měření spuštěno.
+    Clock::time_point m_start;      //!< Čas spuštění (obnovení) měření.
+};
+
+/*!
+ * \brief BenchmarkFunction Typ měřené funkce.
+ */
+typedef void (*BenchmarkFunction)(BenchmarkState &state);
+
+/*!
+ * \brief registerBenchmark Zaregistruje měřenou funkci se seznamem sad parametrů. Pro každou sadu parametrů
+ *                          proběhne samostatné měření.
+ * \param name Název měření.
+ * \param function Měřená funkce.
+ * \param args Sady parametrů měření.
+ * \return Vždy 0 (kvůli použití v makru PE_BENCHMARK).
+ */
+int registerBenchmark(const char *name, BenchmarkFunction function, const QVector<QVector<int>> &args);
+
+/*!
+ * \brief doNotOptimize Zabrání překladači odstranit výpočet, jehož výsledek se dále nevyužívá.
+ * \param value Hodnota, která má být považována za využitou.
+ */
+template <typename T>
+inline void doNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/*!
+ * Makro pro registraci měřené funkce. Za názvem funkce následují sady parametrů, např.
+ * PE_BENCHMARK(bmFft, {512}, {1024}).
+ */
+#define PE_BENCHMARK(function, ...) \
+    static int function##_registered = registerBenchmark(#function, function, {__VA_ARGS__})
+
+#endif
@@ -0,0 +1,214 @@
+#include "benchmark.h"
+#include "benchdata.h"
+
+#include "../pe_config.h"
+#include "../hammingwindow.h"
+#include "../fft.h"
+#include "../mfcc.h"
+#include "../framekernel.h"
+#include "../voiceactivitydetector.h"
+
+/*
+ * Porovnání sloučeného výpočtu (FrameKernel) s řetězcem tříd HammingWindow -> FFT -> MFCC.
+ * Parametry: velikost segmentu, překryv, počet filtrů, počet koeficientů (u bmFusedKernel navíc FFT::SizePolicy,
+ * u bmFusedKernelOutput FrameKernel::OutputMode, u bmFusedKernelPreEmphasis 0 = bez preemfáze, 1 = preemfáze,
+ * 2 = preemfáze s ditherem, u bmFusedKernelVad podíl ticha v %, u bmSpectrumBand horní mezní frekvence v Hz
+ * pásma od 300 Hz s 16 filtry HTK (0 = celé spektrum s výchozí bankou) a FrameKernel::SpectrumMethod,
+ * u bmFusedKernelDescriptors 0 = bez deskriptorů, 1 = deskriptory ze spektra výpočtu MFCC, 2 = deskriptory
+ * z vlastní FFT).
+ */
+
+namespace {
+
+void bmStagedPipeline(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    int hop = segmentSize - state.range(1);
+    int framesCount = 64;
+
+    QVector<sample> signal = syntheticSignal(segmentSize + hop * framesCount);
+    HammingWindow window(segmentSize);
+    FFT fft(segmentSize);
+    MFCC mfcc(SAMPLE_RATE, state.range(2), fft.espdSize());
+
+    while (state.keepRunning()) {
+        for (int f = 0; f < framesCount; f++) {
+            QVector<sample> segment = signal.mid(f * hop, segmentSize);
+            QVector<float> coefs = mfcc.calculate(fft.transformEucl(window.normalize(segment)), state.range(3));
+            doNotOptimize(coefs.constData());
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * framesCount);
+}
+
+void bmFusedKernel(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    int hop = segmentSize - state.range(1);
+    int framesCount = 64;
+
+    QVector<sample> signal = syntheticSignal(segmentSize + hop * framesCount);
+    FrameKernel kernel(segmentSize, SAMPLE_RATE, state.range(2), state.range(3),
+                       static_cast<FFT::SizePolicy>(state.range(4)));
+    QVector<float> coefs(kernel.coefsCount());
+
+    while (state.keepRunning()) {
+        for (int f = 0; f < framesCount; f++) {
+            kernel.process(signal.constData() + f * hop, coefs.data());
+            doNotOptimize(coefs.constData());
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * framesCount);
+}
+
+void bmFusedKernelOutput(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    int hop = segmentSize - state.range(1);
+    int framesCount = 64;
+
+    QVector<sample> signal = syntheticSignal(segmentSize + hop * framesCount);
+    FrameKernel kernel(segmentSize, SAMPLE_RATE, state.range(2), state.range(3));
+    kernel.setOutputMode(static_cast<FrameKernel::OutputMode>(state.range(4)));
+    QVector<float> output(kernel.outputSize());
+
+    while (state.keepRunning()) {
+        for (int f = 0; f < framesCount; f++) {
+            kernel.process(signal.constData() + f * hop, output.data());
+            doNotOptimize(output.constData());
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * framesCount);
+}
+
+void bmFusedKernelPreEmphasis(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    int hop = segmentSize - state.range(1);
+    int framesCount = 64;
+
+    QVector<sample> signal = syntheticSignal(segmentSize + hop * framesCount);
+    FrameKernel kernel(segmentSize, SAMPLE_RATE, state.range(2), state.range(3));
+    PreEmphasis preEmphasis(segmentSize, hop, (state.range(4) > 0) ? PREEMPHASIS_COEFFICIENT : 0.0f);
+    preEmphasis.setDither((state.range(4) > 1) ? 1.0f : 0.0f);
+    kernel.setPreEmphasis(&preEmphasis);
+    QVector<float> coefs(kernel.coefsCount());
+
+    while (state.keepRunning()) {
+        preEmphasis.reset();
+
+        for (int f = 0; f < framesCount; f++) {
+            kernel.process(signal.constData() + f * hop, coefs.data());
+            doNotOptimize(coefs.constData());
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * framesCount);
+}
+
+void bmSpectrumBand(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    int hop = segmentSize - state.range(1);
+    int framesCount = 64;
+    int filtersCount = (state.range(4) > 0) ? 16 : state.range(2);
+
+    QVector<sample> signal = syntheticSignal(segmentSize + hop * framesCount);
+    FrameKernel kernel(segmentSize, SAMPLE_RATE, filtersCount, qMin(filtersCount, state.range(3)));
+    if (state.range(4) > 0)
+        kernel.setFilterBank(FilterBank(kernel.espdSize(), filtersCount, SAMPLE_RATE, FilterBank::HtkMel, 300.0f,
+                                        state.range(4)));
+    kernel.setSpectrumMethod(static_cast<FrameKernel::SpectrumMethod>(state.range(5)));
+    QVector<float> coefs(kernel.coefsCount());
+
+    while (state.keepRunning()) {
+        for (int f = 0; f < framesCount; f++) {
+            kernel.process(signal.constData() + f * hop, coefs.data());
+            doNotOptimize(coefs.constData());
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * framesCount);
+}
+
+void bmFusedKernelDescriptors(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    int hop = segmentSize - state.range(1);
+    int framesCount = 64;
+
+    QVector<sample> signal = syntheticSignal(segmentSize + hop * framesCount);
+    FrameKernel kernel(segmentSize, SAMPLE_RATE, state.range(2), state.range(3));
+    SpectralDescriptors descriptors(kernel.espdSize(), SAMPLE_RATE);
+    if (state.range(4) == 1)
+        kernel.setSpectralDescriptors(&descriptors);
+
+    /* Samostatný průchod: druhá FFT jen kvůli deskriptorům. */
+    FrameKernel spectrum(segmentSize, SAMPLE_RATE, state.range(2), state.range(3));
+    spectrum.setOutputMode(FrameKernel::Magnitude);
+    QVector<float> coefs(kernel.outputSize()), espd(spectrum.outputSize()), values(descriptors.count());
+
+    while (state.keepRunning()) {
+        for (int f = 0; f < framesCount; f++) {
+            kernel.process(signal.constData() + f * hop, coefs.data());
+
+            if (state.range(4) == 2) {
+                spectrum.process(signal.constData() + f * hop, espd.data());
+                descriptors.compute(espd.constData(), values.data());
+            }
+
+            doNotOptimize(coefs.constData());
+            doNotOptimize(values.constData());
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * framesCount);
+}
+
+void bmFusedKernelVad(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    int hop = segmentSize - state.range(1);
+    int framesCount = 64;
+
+    /* Druhá část signálu je ticho. */
+    QVector<sample> signal = syntheticSignal(segmentSize + hop * framesCount);
+    int silenceStart = signal.size() - (signal.size() * state.range(4)) / 100;
+    std::fill(signal.begin() + silenceStart, signal.end(), 0);
+
+    FrameKernel kernel(segmentSize, SAMPLE_RATE, state.range(2), state.range(3));
+    VoiceActivityDetector detector(segmentSize);
+    detector.setHangover(0);
+    kernel.setVoiceActivityDetector(&detector);
+    QVector<float> coefs(kernel.coefsCount());
+
+    while (state.keepRunning()) {
+        for (int f = 0; f < framesCount; f++) {
+            kernel.process(signal.constData() + f * hop, coefs.data());
+            doNotOptimize(coefs.constData());
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * framesCount);
+}
+
+}
+
+PE_BENCHMARK(bmStagedPipeline, {256, 128, NUM_FILTERS, MFCC_COUNT}, {512, 256, NUM_FILTERS, MFCC_COUNT},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT}, {2048, 1024, NUM_FILTERS, MFCC_COUNT});
+PE_BENCHMARK(bmFusedKernel, {256, 128, NUM_FILTERS, MFCC_COUNT}, {512, 256, NUM_FILTERS, MFCC_COUNT},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT}, {2048, 1024, NUM_FILTERS, MFCC_COUNT},
+             {1103, 662, NUM_FILTERS, MFCC_COUNT, FFT::PowerOfTwo}, {1103, 662, NUM_FILTERS, MFCC_COUNT, FFT::NextFastSize});
+PE_BENCHMARK(bmFusedKernelOutput, {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT, FrameKernel::Magnitude},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT, FrameKernel::Power},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT, FrameKernel::LogMel},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT, FrameKernel::Mfcc});
+PE_BENCHMARK(bmFusedKernelPreEmphasis, {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT, 0},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT, 1}, {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT, 2});
+PE_BENCHMARK(bmSpectrumBand, {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, 13, 0, FrameKernel::FftSpectrum},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, 13, 3400, FrameKernel::FftSpectrum},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, 13, 3400, FrameKernel::GoertzelSpectrum},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, 13, 1000, FrameKernel::FftSpectrum},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, 13, 1000, FrameKernel::GoertzelSpectrum},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, 13, 600, FrameKernel::FftSpectrum},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, 13, 600, FrameKernel::GoertzelSpectrum});
+PE_BENCHMARK(bmFusedKernelDescriptors, {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT, 0},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT, 1}, {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT, 2});
+PE_BENCHMARK(bmFusedKernelVad, {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT, 0},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT, 50}, {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT, 90});
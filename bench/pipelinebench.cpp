@@ -0,0 +1,83 @@
+#include "benchmark.h"
+#include "benchdata.h"
+
+#include "../pe_config.h"
+#include "../audiosegmenter.h"
+#include "../hammingwindow.h"
+#include "../fft.h"
+#include "../mfcc.h"
+#include "../framekernel.h"
+
+/*
+ * Měření celého řetězce od zápisu akustického signálu do AudioSegmenter po výsledné MFC koeficienty.
+ * Vstupem je bílý šum z přiložených souborů white_noise/noise_<velikost>.raw.
+ * Parametry: velikost segmentu, překryv, počet filtrů, počet koeficientů.
+ */
+
+namespace {
+
+const int BLOCKS_COUNT = 64;
+
+void bmEndToEndStaged(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    int overlap = state.range(1);
+    int hop = segmentSize - overlap;
+
+    QVector<sample> signal = whiteNoise(segmentSize, hop * BLOCKS_COUNT);
+    AudioSegmenter segmenter(segmentSize, overlap, segmentSize * 4);
+    HammingWindow window(segmentSize);
+    FFT fft(segmentSize);
+    MFCC mfcc(SAMPLE_RATE, state.range(2), fft.espdSize());
+    qint64 frames = 0;
+
+    while (state.keepRunning()) {
+        for (int i = 0; i < BLOCKS_COUNT; i++) {
+            segmenter.writeAudio(signal.mid(i * hop, hop));
+
+            while (segmenter.hasNextSegment()) {
+                QVector<float> coefs = mfcc.calculate(fft.transformEucl(window.normalize(segmenter.nextSegment())),
+                                                      state.range(3));
+                doNotOptimize(coefs.constData());
+                frames++;
+            }
+        }
+    }
+
+    state.setFramesProcessed(frames);
+}
+
+void bmEndToEndFused(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    int overlap = state.range(1);
+    int hop = segmentSize - overlap;
+
+    QVector<sample> signal = whiteNoise(segmentSize, hop * BLOCKS_COUNT);
+    AudioSegmenter segmenter(segmentSize, overlap, segmentSize * 4);
+    FrameKernel kernel(segmentSize, SAMPLE_RATE, state.range(2), state.range(3));
+    QVector<float> coefs(kernel.coefsCount());
+    qint64 frames = 0;
+
+    while (state.keepRunning()) {
+        for (int i = 0; i < BLOCKS_COUNT; i++) {
+            segmenter.writeAudio(signal.mid(i * hop, hop));
+
+            while (segmenter.hasNextSegment()) {
+                QVector<sample> segment = segmenter.nextSegment();
+                kernel.process(segment.constData(), coefs.data());
+                doNotOptimize(coefs.constData());
+                frames++;
+            }
+        }
+    }
+
+    state.setFramesProcessed(frames);
+}
+
+}
+
+PE_BENCHMARK(bmEndToEndStaged, {512, 256, NUM_FILTERS, MFCC_COUNT}, {SEGMENT_SIZE, OVERLAP, 26, 13},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT}, {SEGMENT_SIZE, 768, NUM_FILTERS, MFCC_COUNT},
+             {2048, 1024, NUM_FILTERS, MFCC_COUNT});
+PE_BENCHMARK(bmEndToEndFused, {512, 256, NUM_FILTERS, MFCC_COUNT}, {SEGMENT_SIZE, OVERLAP, 26, 13},
+             {SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT}, {SEGMENT_SIZE, 768, NUM_FILTERS, MFCC_COUNT},
+             {2048, 1024, NUM_FILTERS, MFCC_COUNT});
@@ -0,0 +1,437 @@
+#include "benchmark.h"
+#include "benchdata.h"
+
+#include <QDir>
+
+#include "../pe_config.h"
+#include "../audiosegmenter.h"
+#include "../cmvn.h"
+#include "../deltafeatures.h"
+#include "../hammingwindow.h"
+#include "../fft.h"
+#include "../filterbank.h"
+#include "../htkfile.h"
+#include "../melfilterbank.h"
+#include "../mfcc.h"
+#include "../mfccfile.h"
+#include "../pitchtracker.h"
+#include "../resampler.h"
+#include "../reconstruction/audiocomposer.h"
+#include "../reconstruction/audioscaler.h"
+#include "../reconstruction/espdrecover.h"
+#include "../reconstruction/segmentrecover.h"
+
+/*
+ * Měření jednotlivých kroků výpočtu MFCC a rekonstrukce. Každé měření zpracovává stejný počet segmentů,
+ * výsledky jsou tedy uvedeny v ns na segment (frame).
+ */
+
+namespace {
+
+const int FRAMES_COUNT = 64;
+
+void bmAudioSegmenter(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    int overlap = state.range(1);
+    int hop = segmentSize - overlap;
+
+    /* Data přicházejí po blocích velikosti posunu, stejně jako ze zvukové karty. */
+    QVector<sample> signal = whiteNoise(segmentSize, hop * FRAMES_COUNT);
+    AudioSegmenter segmenter(segmentSize, overlap, segmentSize * 4);
+    qint64 frames = 0;
+
+    while (state.keepRunning()) {
+        for (int i = 0; i < FRAMES_COUNT; i++) {
+            segmenter.writeAudio(signal.mid(i * hop, hop));
+
+            while (segmenter.hasNextSegment()) {
+                QVector<sample> segment = segmenter.nextSegment();
+                doNotOptimize(segment.constData());
+                frames++;
+            }
+        }
+    }
+
+    state.setFramesProcessed(frames);
+}
+
+void bmHammingWindow(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    QVector<sample> segment = whiteNoise(segmentSize, segmentSize);
+    HammingWindow window(segmentSize);
+
+    while (state.keepRunning()) {
+        for (int i = 0; i < FRAMES_COUNT; i++) {
+            QVector<float> normalized = window.normalize(segment);
+            doNotOptimize(normalized.constData());
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * FRAMES_COUNT);
+}
+
+void bmFftTransformEucl(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    HammingWindow window(segmentSize);
+    QVector<float> segment = window.normalize(whiteNoise(segmentSize, segmentSize));
+    FFT fft(segmentSize, static_cast<FFT::SizePolicy>(state.range(1)));
+
+    while (state.keepRunning()) {
+        for (int i = 0; i < FRAMES_COUNT; i++) {
+            QVector<float> espd = fft.transformEucl(segment);
+            doNotOptimize(espd.constData());
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * FRAMES_COUNT);
+}
+
+void bmMelFilterBankInit(BenchmarkState &state) {
+    FFT fft(state.range(0));
+
+    while (state.keepRunning()) {
+        MelFilterBank filters(fft.espdSize(), state.range(1), SAMPLE_RATE);
+        doNotOptimize(filters.count());
+    }
+}
+
+/* Parametry: velikost segmentu, FilterBank::Scale, horní mezní frekvence v Hz (0 = Nyquistova frekvence). */
+void bmFilterBankApply(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    HammingWindow window(segmentSize);
+    FFT fft(segmentSize);
+    QVector<float> espd = fft.transformEucl(window.normalize(whiteNoise(segmentSize, segmentSize)));
+    float high = (state.range(2) > 0) ? state.range(2) : FILTERBANK_NYQUIST;
+    FilterBank filters(fft.espdSize(), NUM_FILTERS, SAMPLE_RATE, static_cast<FilterBank::Scale>(state.range(1)),
+                       0.0f, high);
+    QVector<float> energies(NUM_FILTERS);
+
+    while (state.keepRunning()) {
+        for (int i = 0; i < FRAMES_COUNT; i++) {
+            filters.apply(espd.constData(), energies.data());
+            doNotOptimize(energies.constData());
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * FRAMES_COUNT);
+}
+
+void bmMfccCalculate(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    HammingWindow window(segmentSize);
+    FFT fft(segmentSize);
+    QVector<float> espd = fft.transformEucl(window.normalize(whiteNoise(segmentSize, segmentSize)));
+    MFCC mfcc(SAMPLE_RATE, state.range(1), fft.espdSize());
+
+    while (state.keepRunning()) {
+        for (int i = 0; i < FRAMES_COUNT; i++) {
+            QVector<float> coefs = mfcc.calculate(espd, state.range(2));
+            doNotOptimize(coefs.constData());
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * FRAMES_COUNT);
+}
+
+void bmMfccFileWrite(BenchmarkState &state) {
+    QVector<QVector<float>> mfccs = syntheticMfccs(state.range(0));
+    MfccFile file(QDir::temp().filePath("pe_bench_write.mfcc"));
+
+    while (state.keepRunning())
+        file.write(mfccs);
+
+    file.clear();
+    state.setFramesProcessed(state.iterations() * mfccs.size());
+}
+
+void bmMfccFileAppend(BenchmarkState &state) {
+    QVector<QVector<float>> mfccs = syntheticMfccs(state.range(0));
+    MfccFile file(QDir::temp().filePath("pe_bench_append.mfcc"));
+
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        file.clear();
+        state.resumeTiming();
+
+        for (const QVector<float> &vector : mfccs)
+            file.append(vector);
+    }
+
+    file.clear();
+    state.setFramesProcessed(state.iterations() * mfccs.size());
+}
+
+void bmMfccFileReadAll(BenchmarkState &state) {
+    MfccFile file(QDir::temp().filePath("pe_bench_read.mfcc"));
+    file.write(syntheticMfccs(state.range(0)));
+
+    while (state.keepRunning()) {
+        QVector<QVector<float>> mfccs = file.readAll();
+        doNotOptimize(mfccs.constData());
+    }
+
+    file.clear();
+    state.setFramesProcessed(state.iterations() * state.range(0));
+}
+
+void bmMfccFileReadTensor(BenchmarkState &state) {
+    MfccFile file(QDir::temp().filePath("pe_bench_read_tensor.mfcc"));
+    file.write(syntheticMfccs(state.range(0)));
+
+    QVector<float> tensor(state.range(0) * MFCC_COUNT);
+    TensorView view = (state.range(1) == TensorView::FrameMajor)
+            ? TensorView::frameMajor(tensor.data(), state.range(0), MFCC_COUNT)
+            : TensorView::coefficientMajor(tensor.data(), state.range(0), MFCC_COUNT);
+
+    while (state.keepRunning()) {
+        file.read(view);
+        doNotOptimize(tensor.constData());
+    }
+
+    file.clear();
+    state.setFramesProcessed(state.iterations() * state.range(0));
+}
+
+void bmHtkFileWrite(BenchmarkState &state) {
+    const int vectors = state.range(0), size = state.range(1);
+    QVector<float> features(vectors * size, 1.0f);
+    QString path = QDir::temp().filePath("pe_bench_write.htk");
+    HtkFile file(path);
+
+    while (state.keepRunning())
+        file.write(features.constData(), vectors, size, HtkFile::samplePeriodFor(OVERLAP, SAMPLE_RATE), HtkFile::Mfcc);
+
+    QFile::remove(path);
+    state.setFramesProcessed(state.iterations() * vectors);
+}
+
+void bmHtkFileRead(BenchmarkState &state) {
+    const int vectors = state.range(0), size = state.range(1);
+    QString path = QDir::temp().filePath("pe_bench_read.htk");
+    HtkFile file(path);
+    file.write(QVector<float>(vectors * size, 1.0f).constData(), vectors, size, 100000, HtkFile::Mfcc);
+
+    QVector<float> tensor(vectors * size);
+    TensorView view = TensorView::frameMajor(tensor.data(), vectors, size);
+
+    while (state.keepRunning()) {
+        file.read(view);
+        doNotOptimize(tensor.constData());
+    }
+
+    QFile::remove(path);
+    state.setFramesProcessed(state.iterations() * vectors);
+}
+
+void bmEspdRecover(BenchmarkState &state) {
+    FFT fft(state.range(0));
+    ESPDRecover recover(fft.espdSize(), state.range(1), SAMPLE_RATE);
+    QVector<float> mfccs = syntheticMfccs(1).first().mid(0, state.range(2));
+
+    while (state.keepRunning()) {
+        for (int i = 0; i < FRAMES_COUNT; i++) {
+            QVector<float> espd = recover.recover(mfccs);
+            doNotOptimize(espd.constData());
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * FRAMES_COUNT);
+}
+
+void bmSegmentRecover(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    HammingWindow window(segmentSize);
+    FFT fft(segmentSize);
+    QVector<float> espd = fft.transformEucl(window.normalize(whiteNoise(segmentSize, segmentSize)));
+    SegmentRecover recover(segmentSize, state.range(1));
+
+    while (state.keepRunning()) {
+        QVector<float> segment = recover.recover(espd);
+        doNotOptimize(segment.constData());
+    }
+}
+
+void bmAudioComposer(BenchmarkState &state) {
+    int segmentSize = state.range(0);
+    HammingWindow window(segmentSize);
+    QVector<float> segment = window.normalize(whiteNoise(segmentSize, segmentSize));
+    AudioComposer composer(segmentSize, state.range(1));
+    composer.setWindows(window.coefficients(), window.coefficients());
+
+    /* Třetí parametr: 1 = proudový režim (signál audioComposed), 0 = celý signál metodou getAudio. */
+    bool streaming = state.range(2) != 0;
+    composer.setStreaming(streaming);
+    QObject::connect(&composer, &AudioComposer::audioComposed, [](const float *audio, int) { doNotOptimize(audio); });
+
+    while (state.keepRunning()) {
+        for (int i = 0; i < FRAMES_COUNT; i++)
+            composer.add(segment);
+
+        if (streaming) {
+            composer.flush();
+        }
+        else {
+            doNotOptimize(composer.getAudio().constData());
+            composer.clear();
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * FRAMES_COUNT);
+}
+
+void bmAudioScaler(BenchmarkState &state) {
+    /*
+     * Parametr: 0 = celý signál metodou scale, 1 = proudový režim po segmentech, 2 = proudový režim se signálem
+     * v rozsahu typu sample (omezovač nezasahuje). Jinak signál rozsah přesahuje, aby se skutečně škálovalo.
+     * Jeden frame = SEGMENT_SIZE vzorků.
+     */
+    QVector<sample> signal = syntheticSignal(SEGMENT_SIZE * FRAMES_COUNT);
+    QVector<float> audio(signal.size());
+    QVector<sample> output(signal.size());
+    float amplification = (state.range(0) == 2) ? 0.5f : 4.0f;
+
+    for (int i = 0; i < signal.size(); i++)
+        audio[i] = signal[i] * amplification;
+
+    bool streaming = state.range(0) != 0;
+    AudioScaler scaler;
+
+    while (state.keepRunning()) {
+        if (streaming) {
+            int written = 0;
+
+            for (int i = 0; i < FRAMES_COUNT; i++)
+                written += scaler.scaleStream(audio.constData() + i * SEGMENT_SIZE, SEGMENT_SIZE, output.data() + written);
+
+            scaler.flush(output.data() + written);
+        }
+        else scaler.scale(audio.constData(), audio.size(), output.data());
+
+        doNotOptimize(output.constData());
+    }
+
+    state.setFramesProcessed(state.iterations() * FRAMES_COUNT);
+}
+
+void bmResampler(BenchmarkState &state) {
+    /* Proud přichází po blocích SEGMENT_SIZE vstupních vzorků, jeden blok = jeden frame. */
+    QVector<sample> signal = syntheticSignal(SEGMENT_SIZE * FRAMES_COUNT);
+    Resampler resampler(state.range(0), state.range(1));
+
+    while (state.keepRunning()) {
+        for (int i = 0; i < FRAMES_COUNT; i++) {
+            QVector<sample> output = resampler.process(signal.mid(i * SEGMENT_SIZE, SEGMENT_SIZE));
+            doNotOptimize(output.constData());
+        }
+    }
+
+    state.setFramesProcessed(state.iterations() * FRAMES_COUNT);
+}
+
+void bmCmvn(BenchmarkState &state) {
+    /* Global a Sliding po segmentech (jako ve FrameKernel), Utterance dávkově nad celou maticí. */
+    const Cmvn::Mode mode = static_cast<Cmvn::Mode>(state.range(0));
+    const int coefsCount = state.range(1);
+    QVector<QVector<float>> mfccs = syntheticMfccs(FRAMES_COUNT);
+    QVector<float> matrix(FRAMES_COUNT * coefsCount);
+    Cmvn cmvn(coefsCount, mode);
+
+    for (int t = 0; t < FRAMES_COUNT; t++) {
+        std::copy(mfccs[t].constBegin(), mfccs[t].constBegin() + coefsCount, matrix.begin() + t * coefsCount);
+        cmvn.accumulate(matrix.constData() + t * coefsCount);
+    }
+
+    QVector<float> work(matrix.size());
+
+    while (state.keepRunning()) {
+        std::copy(matrix.constBegin(), matrix.constEnd(), work.begin());
+
+        if (mode == Cmvn::Utterance)
+            cmvn.normalize(work.data(), FRAMES_COUNT);
+        else {
+            for (int t = 0; t < FRAMES_COUNT; t++)
+                cmvn.normalize(work.data() + t * coefsCount);
+        }
+
+        doNotOptimize(work.constData());
+    }
+
+    state.setFramesProcessed(state.iterations() * FRAMES_COUNT);
+}
+
+void bmDeltaFeatures(BenchmarkState &state) {
+    /* Režim 0: proudově po segmentech (push), 1: dávkově na místě ve FrameMajor matici, 2: v CoefficientMajor matici. */
+    const int coefsCount = state.range(0), mode = state.range(1);
+    QVector<QVector<float>> mfccs = syntheticMfccs(FRAMES_COUNT);
+    DeltaFeatures deltas(coefsCount);
+    QVector<float> output(FRAMES_COUNT * deltas.outputSize());
+    TensorView view = (mode == 1) ? TensorView::frameMajor(output.data(), FRAMES_COUNT, deltas.outputSize())
+                                  : TensorView::coefficientMajor(output.data(), FRAMES_COUNT, deltas.outputSize());
+    QVector<float> statics(deltas.outputSize());
+    for (int t = 0; mode != 0 && t < FRAMES_COUNT; t++) {
+        std::copy(mfccs[t].constBegin(), mfccs[t].constBegin() + coefsCount, statics.begin());
+        view.store(t, statics.constData());
+    }
+
+    while (state.keepRunning()) {
+        if (mode == 0) {
+            int written = 0;
+            for (int t = 0; t < FRAMES_COUNT; t++)
+                written += deltas.push(mfccs[t].constData(), output.data() + written * deltas.outputSize());
+
+            deltas.flush(output.data() + written * deltas.outputSize());
+        }
+        else deltas.calculate(view, 2);
+
+        doNotOptimize(output.constData());
+    }
+
+    state.setFramesProcessed(state.iterations() * FRAMES_COUNT);
+}
+
+void bmPitchTracker(BenchmarkState &state) {
+    /* Segmenty s polovičním překryvem, druhý parametr zapíná vyhlazení Viterbiho algoritmem. */
+    const int segmentSize = state.range(0);
+    QVector<sample> signal = syntheticSignal(segmentSize / 2 * (FRAMES_COUNT + 1));
+    QVector<QVector<sample>> segments;
+    for (int i = 0; i < FRAMES_COUNT; i++)
+        segments.append(signal.mid(i * segmentSize / 2, segmentSize));
+
+    PitchTracker tracker(segmentSize, SAMPLE_RATE);
+
+    while (state.keepRunning()) {
+        QVector<PitchTracker::Estimate> estimates = tracker.track(segments, state.range(1) != 0);
+        doNotOptimize(estimates.constData());
+    }
+
+    state.setFramesProcessed(state.iterations() * FRAMES_COUNT);
+}
+
+}
+
+PE_BENCHMARK(bmAudioSegmenter, {256, 128}, {512, 256}, {SEGMENT_SIZE, OVERLAP}, {SEGMENT_SIZE, 768}, {2048, 1024});
+PE_BENCHMARK(bmHammingWindow, {256}, {512}, {SEGMENT_SIZE}, {2048});
+PE_BENCHMARK(bmFftTransformEucl, {256}, {400}, {512}, {SEGMENT_SIZE}, {1103}, {2048}, {400, FFT::NextFastSize},
+             {1103, FFT::NextFastSize});
+PE_BENCHMARK(bmMelFilterBankInit, {SEGMENT_SIZE, 26}, {SEGMENT_SIZE, NUM_FILTERS}, {2048, NUM_FILTERS});
+PE_BENCHMARK(bmFilterBankApply, {SEGMENT_SIZE, FilterBank::LegacyMel, 0}, {SEGMENT_SIZE, FilterBank::HtkMel, 0},
+             {SEGMENT_SIZE, FilterBank::HtkMel, 8000}, {SEGMENT_SIZE, FilterBank::Erb, 0},
+             {SEGMENT_SIZE, FilterBank::Erb, 8000});
+PE_BENCHMARK(bmMfccCalculate, {SEGMENT_SIZE, 26, 13}, {SEGMENT_SIZE, NUM_FILTERS, 13}, {SEGMENT_SIZE, NUM_FILTERS, MFCC_COUNT},
+             {2048, NUM_FILTERS, MFCC_COUNT});
+PE_BENCHMARK(bmMfccFileWrite, {WINDOW_VECTOR_COUNT}, {4096});
+PE_BENCHMARK(bmMfccFileAppend, {WINDOW_VECTOR_COUNT});
+PE_BENCHMARK(bmMfccFileReadAll, {WINDOW_VECTOR_COUNT}, {4096});
+PE_BENCHMARK(bmMfccFileReadTensor, {4096, TensorView::FrameMajor}, {4096, TensorView::CoefficientMajor});
+PE_BENCHMARK(bmHtkFileWrite, {4096, 13}, {4096, MFCC_COUNT});
+PE_BENCHMARK(bmHtkFileRead, {4096, 13}, {4096, MFCC_COUNT});
+PE_BENCHMARK(bmEspdRecover, {SEGMENT_SIZE, NUM_FILTERS, 13}, {SEGMENT_SIZE, NUM_FILTERS, MFCC_COUNT});
+PE_BENCHMARK(bmSegmentRecover, {256, 10}, {SEGMENT_SIZE, 10}, {SEGMENT_SIZE, 100});
+PE_BENCHMARK(bmAudioComposer, {SEGMENT_SIZE, OVERLAP, 0}, {SEGMENT_SIZE, OVERLAP, 1}, {SEGMENT_SIZE, 768, 0},
+             {2048, 1024, 0});
+PE_BENCHMARK(bmAudioScaler, {0}, {1}, {2});
+PE_BENCHMARK(bmResampler, {SAMPLE_RATE, 16000}, {48000, 16000}, {8000, SAMPLE_RATE}, {16000, SAMPLE_RATE});
+PE_BENCHMARK(bmCmvn, {Cmvn::Global, 13}, {Cmvn::Global, MFCC_COUNT}, {Cmvn::Utterance, MFCC_COUNT},
+             {Cmvn::Sliding, 13}, {Cmvn::Sliding, MFCC_COUNT});
+PE_BENCHMARK(bmDeltaFeatures, {13, 0}, {13, 1}, {MFCC_COUNT, 0}, {MFCC_COUNT, 1}, {MFCC_COUNT, 2});
+PE_BENCHMARK(bmPitchTracker, {512, 0}, {SEGMENT_SIZE, 0}, {SEGMENT_SIZE, 1}, {2048, 1});
@@ -0,0 +1,389 @@
+#include "cmvn.h"
+
+#include <QtMath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*!
+ * Nejmenší rozptyl, kterým se dělí (kvůli konstantním koeficientům).
+ */
+#define CMVN_VARIANCE_FLOOR 1e-10
+
+namespace {
+
+/* Přičte (Sign 1), resp. odečte (Sign -1) vektor a druhé mocniny jeho prvků k součtům v dvojnásobné přesnosti. */
+template <int Sign>
+void addSums(const float *coefs, double *sum, double *sumSquares, int count) {
+    int c = 0;
+
+#ifdef __SSE2__
+    /* Čtyři koeficienty jsou převedeny na dvě dvojice double, operace jsou stejné jako ve skalární větvi. */
+    for (; c + 4 <= count; c += 4) {
+        const __m128 values = _mm_loadu_ps(coefs + c);
+        const __m128d low = _mm_cvtps_pd(values);
+        const __m128d high = _mm_cvtps_pd(_mm_movehl_ps(values, values));
+
+        if (Sign > 0) {
+            _mm_storeu_pd(sum + c, _mm_add_pd(_mm_loadu_pd(sum + c), low));
+            _mm_storeu_pd(sum + c + 2, _mm_add_pd(_mm_loadu_pd(sum + c + 2), high));
+            _mm_storeu_pd(sumSquares + c, _mm_add_pd(_mm_loadu_pd(sumSquares + c), _mm_mul_pd(low, low)));
+            _mm_storeu_pd(sumSquares + c + 2, _mm_add_pd(_mm_loadu_pd(sumSquares + c + 2), _mm_mul_pd(high, high)));
+        }
+        else {
+            _mm_storeu_pd(sum + c, _mm_sub_pd(_mm_loadu_pd(sum + c), low));
+            _mm_storeu_pd(sum + c + 2, _mm_sub_pd(_mm_loadu_pd(sum + c + 2), high));
+            _mm_storeu_pd(sumSquares + c, _mm_sub_pd(_mm_loadu_pd(sumSquares + c), _mm_mul_pd(low, low)));
+            _mm_storeu_pd(sumSquares + c + 2, _mm_sub_pd(_mm_loadu_pd(sumSquares + c + 2), _mm_mul_pd(high, high)));
+        }
+    }
+#endif
+
+    for (; c < count; c++) {
+        sum[c] += Sign * static_cast<double>(coefs[c]);
+        sumSquares[c] += Sign * (static_cast<double>(coefs[c]) * coefs[c]);
+    }
+}
+
+}
+
+Cmvn::Cmvn(int coefsCount, Mode mode, bool normalizeVariance, int windowSize, QObject *parent) : QObject(parent) {
+    m_coefsCount = coefsCount;
+    m_mode = mode;
+    m_normalizeVariance = normalizeVariance;
+    m_windowSize = windowSize;
+
+    if (coefsCount <= 0 || (mode == Sliding && windowSize <= 0)) {
+        emit error("Cmvn::Cmvn: Neplatný počet koeficientů nebo velikost klouzavého okna.");
+        m_coefsCount = 0;
+        m_windowSize = 0;
+    }
+
+    m_offset.fill(0.0f, m_coefsCount);
+    m_scale.fill(1.0f, m_coefsCount);
+    m_hasStats = false;
+    m_accChanged = false;
+
+    if (m_mode == Sliding)
+        m_window.fill(0.0f, m_windowSize * m_coefsCount);
+
+    m_accSum.fill(0.0, m_coefsCount);
+    m_accSumSquares.fill(0.0, m_coefsCount);
+    m_accCount = 0;
+
+    reset();
+}
+
+Cmvn::Mode Cmvn::mode() const {
+    return m_mode;
+}
+
+int Cmvn::coefsCount() const {
+    return m_coefsCount;
+}
+
+bool Cmvn::normalize(float *coefs) {
+    if (!coefs || m_coefsCount == 0)
+        return false;
+
+    switch (m_mode) {
+    case Global:
+        if (!updateGlobal())
+            return false;
+
+        apply(coefs, m_offset.constData(), m_scale.constData());
+        return true;
+    case Sliding:
+        normalizeSliding(coefs);
+        return true;
+    default:
+        emit error("Cmvn::normalize: Režim Utterance vyžaduje dávkové zpracování celé promluvy.");
+        return false;
+    }
+}
+
+bool Cmvn::normalize(float *coefs, int frames) {
+    if (!coefs || frames <= 0 || m_coefsCount == 0)
+        return false;
+
+    return normalize(TensorView::frameMajor(coefs, frames, m_coefsCount));
+}
+
+bool Cmvn::normalize(const TensorView &features) {
+    if (features.isNull() || m_coefsCount == 0 || features.features() != m_coefsCount) {
+        emit error("Cmvn::normalize: Matice nemá coefsCount prvků na segment.");
+        return false;
+    }
+
+    /* Nesouvislé vektory (CoefficientMajor) jsou zpracovány přes pracovní buffer. */
+    const bool contiguous = features.hasContiguousFrames();
+    const qptrdiff stride = features.featureStride();
+    QVector<float> scratch(contiguous ? 0 : m_coefsCount);
+
+    auto load = [&](int t) -> float * {
+        if (contiguous)
+            return features.frame(t);
+
+        const float *frame = features.frame(t);
+        for (int c = 0; c < m_coefsCount; c++)
+            scratch[c] = frame[c * stride];
+
+        return scratch.data();
+    };
+
+    auto store = [&](int t) {
+        if (!contiguous)
+            features.store(t, scratch.constData());
+    };
+
+    if (m_mode == Utterance) {
+        /* První průchod: statistiky promluvy. */
+        QVector<double> sum(m_coefsCount, 0.0);
+        QVector<double> sumSquares(m_coefsCount, 0.0);
+
+        for (int t = 0; t < features.frames(); t++)
+            addSums<1>(load(t), sum.data(), sumSquares.data(), m_coefsCount);
+
+        QVector<float> offset(m_coefsCount);
+        QVector<float> scale(m_coefsCount);
+        computeTransform(sum.constData(), sumSquares.constData(), features.frames(), offset.data(), scale.data());
+
+        /* Druhý průchod: normalizace. */
+        for (int t = 0; t < features.frames(); t++) {
+            apply(load(t), offset.constData(), scale.constData());
+            store(t);
+        }
+
+        return true;
+    }
+
+    for (int t = 0; t < features.frames(); t++) {
+        if (!normalize(load(t)))
+            return false;
+
+        store(t);
+    }
+
+    return true;
+}
+
+QVector<QVector<float>> Cmvn::normalize(const QVector<QVector<float>> &coefs) {
+    if (coefs.isEmpty() || m_coefsCount == 0)
+        return QVector<QVector<float>>();
+
+    QVector<float> matrix;
+    matrix.reserve(coefs.size() * m_coefsCount);
+
+    for (const QVector<float> &frame : coefs) {
+        if (frame.size() != m_coefsCount) {
+            emit error("Cmvn::normalize: Neočekávaná délka vstupního vektoru koeficientů.");
+            return QVector<QVector<float>>();
+        }
+
+        matrix.append(frame);
+    }
+
+    normalize(matrix.data(), coefs.size());
+
+    QVector<QVector<float>> normalized;
+    normalized.reserve(coefs.size());
+
+    for (int t = 0; t < coefs.size(); t++)
+        normalized.append(matrix.mid(t * m_coefsCount, m_coefsCount));
+
+    return normalized;
+}
+
+void Cmvn::reset() {
+    m_sum.fill(0.0, m_coefsCount);
+    m_sumSquares.fill(0.0, m_coefsCount);
+    m_windowFilled = 0;
+    m_windowNext = 0;
+}
+
+void Cmvn::accumulate(const float *coefs) {
+    if (!coefs || m_coefsCount == 0)
+        return;
+
+    addSums<1>(coefs, m_accSum.data(), m_accSumSquares.data(), m_coefsCount);
+    m_accCount++;
+    m_accChanged = true;
+}
+
+bool Cmvn::saveStats(const QString &fileName) {
+    if (m_accCount == 0) {
+        emit error("Cmvn::saveStats: Nebyly nasčítány žádné statistiky.");
+        return false;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        emit error("Cmvn::saveStats: Do souboru " + fileName + " nelze zapisovat.");
+        return false;
+    }
+
+    QDataStream output(&file);
+    initStream(&output);
+
+    output << static_cast<int32_t>(m_coefsCount);
+    output << static_cast<qint64>(m_accCount);
+
+    for (int c = 0; c < m_coefsCount; c++) {
+        double mean = m_accSum[c] / m_accCount;
+        output << static_cast<float>(mean);
+    }
+
+    for (int c = 0; c < m_coefsCount; c++) {
+        double mean = m_accSum[c] / m_accCount;
+        output << static_cast<float>(m_accSumSquares[c] / m_accCount - mean * mean);
+    }
+
+    return true;
+}
+
+bool Cmvn::loadStats(const QString &fileName) {
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        emit error("Cmvn::loadStats: Soubor " + fileName + " nelze otevřít.");
+        return false;
+    }
+
+    QDataStream input(&file);
+    initStream(&input);
+
+    int32_t coefsCount;
+    qint64 count;
+    input >> coefsCount >> count;
+
+    if (coefsCount != m_coefsCount) {
+        emit error("Cmvn::loadStats: Počet koeficientů souboru statistik neodpovídá nastavení.");
+        return false;
+    }
+
+    QVector<float> means(m_coefsCount);
+    QVector<float> variances(m_coefsCount);
+
+    for (int c = 0; c < m_coefsCount; c++)
+        input >> means[c];
+
+    for (int c = 0; c < m_coefsCount; c++)
+        input >> variances[c];
+
+    if (input.status() != QDataStream::Ok) {
+        emit error("Cmvn::loadStats: Soubor statistik je poškozený.");
+        return false;
+    }
+
+    return setStats(means, variances);
+}
+
+bool Cmvn::setStats(const QVector<float> &means, const QVector<float> &variances) {
+    if (m_coefsCount == 0 || means.size() != m_coefsCount || variances.size() != m_coefsCount)
+        return false;
+
+    for (int c = 0; c < m_coefsCount; c++) {
+        m_offset[c] = means[c];
+        m_scale[c] = m_normalizeVariance ? 1.0f / qSqrt(qMax(static_cast<double>(variances[c]), CMVN_VARIANCE_FLOOR)) : 1.0f;
+    }
+
+    m_hasStats = true;
+    return true;
+}
+
+bool Cmvn::updateGlobal() {
+    if (m_hasStats)
+        return true;
+
+    if (m_accCount == 0) {
+        emit error("Cmvn::normalize: Režim Global vyžaduje statistiky (loadStats, setStats nebo accumulate).");
+        return false;
+    }
+
+    if (m_accChanged) {
+        computeTransform(m_accSum.constData(), m_accSumSquares.constData(), m_accCount, m_offset.data(), m_scale.data());
+        m_accChanged = false;
+    }
+
+    return true;
+}
+
+void Cmvn::computeTransform(const double *sum, const double *sumSquares, qint64 count, float *offset, float *scale) const {
+    for (int c = 0; c < m_coefsCount; c++) {
+        double mean = sum[c] / count;
+        double variance = sumSquares[c] / count - mean * mean;
+
+        offset[c] = static_cast<float>(mean);
+        scale[c] = m_normalizeVariance ? static_cast<float>(1.0 / qSqrt(qMax(variance, CMVN_VARIANCE_FLOOR))) : 1.0f;
+    }
+}
+
+void Cmvn::apply(float *coefs, const float *offset, const float *scale) const {
+    int c = 0;
+
+#ifdef __SSE2__
+    for (; c + 4 <= m_coefsCount; c += 4) {
+        __m128 value = _mm_sub_ps(_mm_loadu_ps(coefs + c), _mm_loadu_ps(offset + c));
+        _mm_storeu_ps(coefs + c, _mm_mul_ps(value, _mm_loadu_ps(scale + c)));
+    }
+#endif
+
+    for (; c < m_coefsCount; c++)
+        coefs[c] = (coefs[c] - offset[c]) * scale[c];
+}
+
+void Cmvn::normalizeSliding(float *coefs) {
+    float *slot = m_window.data() + m_windowNext * m_coefsCount;
+    double *sum = m_sum.data();
+    double *sumSquares = m_sumSquares.data();
+
+    /* Vektor, který vypadává z okna, je odečten od průběžných součtů. */
+    if (m_windowFilled == m_windowSize)
+        addSums<-1>(slot, sum, sumSquares, m_coefsCount);
+    else m_windowFilled++;
+
+    std::copy(coefs, coefs + m_coefsCount, slot);
+    addSums<1>(coefs, sum, sumSquares, m_coefsCount);
+
+    m_windowNext = (m_windowNext + 1) % m_windowSize;
+
+    const double count = m_windowFilled;
+    const bool scaled = m_normalizeVariance && m_windowFilled > 1;
+    int c = 0;
+
+#ifdef __SSE2__
+    /* Po dvou koeficientech v dvojnásobné přesnosti, stejné operace jako ve skalární větvi. */
+    const __m128d counts = _mm_set1_pd(count);
+    const __m128d floor = _mm_set1_pd(CMVN_VARIANCE_FLOOR);
+    const __m128d one = _mm_set1_pd(1.0);
+
+    for (; c + 2 <= m_coefsCount; c += 2) {
+        const __m128 pair = _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(coefs + c)));
+        const __m128d mean = _mm_div_pd(_mm_loadu_pd(sum + c), counts);
+        __m128d value = _mm_sub_pd(_mm_cvtps_pd(pair), mean);
+
+        if (scaled) {
+            const __m128d variance = _mm_sub_pd(_mm_div_pd(_mm_loadu_pd(sumSquares + c), counts), _mm_mul_pd(mean, mean));
+            value = _mm_mul_pd(value, _mm_div_pd(one, _mm_sqrt_pd(_mm_max_pd(variance, floor))));
+        }
+
+        _mm_storel_pi(reinterpret_cast<__m64 *>(coefs + c), _mm_cvtpd_ps(value));
+    }
+#endif
+
+    for (; c < m_coefsCount; c++) {
+        double mean = sum[c] / count;
+        double variance = sumSquares[c] / count - mean * mean;
+        double scale = scaled ? 1.0 / qSqrt(qMax(variance, CMVN_VARIANCE_FLOOR)) : 1.0;
+
+        coefs[c] = static_cast<float>((coefs[c] - mean) * scale);
+    }
+}
+
+void Cmvn::initStream(QDataStream *stream) {
+    if (!stream) return;
+
+    stream->setByteOrder(QDataStream::LittleEndian);
+    stream->setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream->setVersion(QDataStream::Qt_5_9);
+}
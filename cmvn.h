@@ -0,0 +1,201 @@
+#ifndef CMVN_H
+#define CMVN_H
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+#include <QFile>
+#include <QDataStream>
+
+#include "pe_config.h"
+#include "tensorview.h"
+
+/*!
+ * \brief Třída Cmvn
+ *
+ * Třída provádí normalizaci střední hodnoty a rozptylu kepstrálních koeficientů (cepstral mean and variance
+ * normalisation). Od každého koeficientu je odečtena jeho střední hodnota a volitelně je výsledek vydělen
+ * směrodatnou odchylkou. Statistiky lze získat třemi způsoby (viz Mode):
+ *
+ * - Global: statistiky jsou předem vypočítány (metody accumulate a saveStats) a načteny ze souboru (loadStats),
+ * - Utterance: statistiky jsou počítány z celé promluvy (pouze dávkové zpracování, dva průchody),
+ * - Sliding: statistiky jsou počítány z posledních windowSize vektorů pomocí průběžných součtů (O(1) na vektor).
+ *
+ * V režimu Global jsou použity statistiky nastavené metodou setStats nebo loadStats, jinak statistiky nasčítané
+ * metodou accumulate. Dokud nejsou k dispozici žádné, normalizace v tomto režimu selže.
+ *
+ * Vektory koeficientů jsou zpracovávány v místě (in-place) a mají stejné uspořádání jako výstup MFCC::calculate
+ * a FrameKernel::process (viz FrameKernel::setCmvn), dávkově lze normalizovat i matici TensorView (výstup
+ * OfflineExtractor). Souhrnné statistiky jsou počítány v dvojnásobné přesnosti, součty i normalizace vektoru jsou
+ * s SSE2 počítány po dvou, resp. čtyřech koeficientech.
+ *
+ * Soubor statistik je binární soubor uložený pomocí malého endianu: 4 B počet koeficientů, 8 B počet vektorů,
+ * ze kterých byly statistiky počítány, a dále střední hodnoty a rozptyly jednotlivých koeficientů (float).
+ */
+class Cmvn : public QObject {
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief Mode Způsob získání statistik.
+     */
+    enum Mode {
+        Global,     //!< Předem vypočítané statistiky načtené ze souboru.
+        Utterance,  //!< Statistiky celé promluvy (pouze dávkové zpracování).
+        Sliding     //!< Statistiky klouzavého okna posledních vektorů.
+    };
+
+    /*!
+     * \brief Cmvn Konstruktor třídy.
+     * \param coefsCount Počet koeficientů normalizovaných vektorů.
+     * \param mode Způsob získání statistik.
+     * \param normalizeVariance True, pokud mají být koeficienty děleny směrodatnou odchylkou.
+     * \param windowSize Počet vektorů klouzavého okna (pouze pro Mode::Sliding).
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolnění).
+     */
+    explicit Cmvn(int coefsCount, Mode mode, bool normalizeVariance = true, int windowSize = 300, QObject *parent = nullptr);
+
+    /*!
+     * \brief mode Vrací způsob získání statistik.
+     * \return Způsob získání statistik.
+     */
+    Mode mode() const;
+
+    /*!
+     * \brief coefsCount Vrací počet koeficientů normalizovaných vektorů.
+     * \return Počet koeficientů.
+     */
+    int coefsCount() const;
+
+    /*!
+     * \brief normalize Normalizuje jeden vektor koeficientů v místě. Tuto metodu lze použít pouze v režimech
+     *                  Global a Sliding, v režimu Utterance (a v režimu Global bez statistik) je emitován signál error.
+     * \param coefs Ukazatel na coefsCount koeficientů.
+     * \return True, pokud byl vektor normalizován, jinak false.
+     */
+    bool normalize(float *coefs);
+
+    /*!
+     * \brief normalize Přetížená metoda. Dávková normalizace souvislé matice vektorů (vektory uložené za sebou).
+     *                  V režimu Sliding jsou vektory zpracovány postupně, jako by přicházely jeden po druhém.
+     * \param coefs Ukazatel na frames * coefsCount koeficientů.
+     * \param frames Počet vektorů.
+     * \return True, pokud byly vektory normalizovány, jinak false.
+     */
+    bool normalize(float *coefs, int frames);
+
+    /*!
+     * \brief normalize Přetížená metoda. Dávková normalizace vektorů koeficientů (např. výstupu MfccFile::readAll).
+     * \param coefs Vektory koeficientů.
+     * \return Normalizované vektory nebo prázdný vektor při chybě.
+     */
+    QVector<QVector<float>> normalize(const QVector<QVector<float>> &coefs);
+
+    /*!
+     * \brief normalize Přetížená metoda. Dávková normalizace matice s libovolnými kroky (např. výstupu
+     *                  OfflineExtractor). V režimu Sliding jsou segmenty zpracovány postupně.
+     * \param features Matice s coefsCount prvky na segment.
+     * \return True, pokud byly vektory normalizovány, jinak false (a je emitován signál error).
+     */
+    bool normalize(const TensorView &features);
+
+    /*!
+     * \brief reset Zahodí stav klouzavého okna (začátek nové promluvy v režimu Sliding).
+     */
+    void reset();
+
+    /*!
+     * \brief accumulate Přičte vektor ke statistikám, které lze následně uložit metodou saveStats.
+     * \param coefs Ukazatel na coefsCount koeficientů.
+     */
+    void accumulate(const float *coefs);
+
+    /*!
+     * \brief saveStats Uloží statistiky nasčítané metodou accumulate do souboru.
+     * \param fileName Cesta k souboru statistik.
+     * \return True, pokud byl zápis úspěšný, jinak false.
+     */
+    bool saveStats(const QString &fileName);
+
+    /*!
+     * \brief loadStats Načte statistiky ze souboru a použije je pro normalizaci v režimu Global.
+     * \param fileName Cesta k souboru statistik.
+     * \return True, pokud byl soubor úspěšně načten, jinak false.
+     */
+    bool loadStats(const QString &fileName);
+
+    /*!
+     * \brief setStats Nastaví statistiky pro normalizaci v režimu Global.
+     * \param means Střední hodnoty koeficientů.
+     * \param variances Rozptyly koeficientů.
+     * \return True, pokud mají vektory správnou velikost, jinak false.
+     */
+    bool setStats(const QVector<float> &means, const QVector<float> &variances);
+
+private:
+    int m_coefsCount;               //!< Počet koeficientů normalizovaných vektorů.
+    Mode m_mode;                    //!< Způsob získání statistik.
+    bool m_normalizeVariance;       //!< True, pokud se normalizuje i rozptyl.
+    int m_windowSize;               //!< Počet vektorů klouzavého okna.
+
+    QVector<float> m_offset;        //!< Odečítaná střední hodnota (režim Global).
+    QVector<float> m_scale;         //!< Násobitel, tj. převrácená směrodatná odchylka (režim Global).
+    bool m_hasStats;                //!< True, pokud byly statistiky nastaveny metodou setStats nebo loadStats.
+    bool m_accChanged;              //!< True, pokud se nasčítané statistiky změnily od posledního výpočtu m_offset.
+
+    QVector<float> m_window;        //!< Kruhový buffer vektorů klouzavého okna.
+    QVector<double> m_sum;          //!< Průběžný součet koeficientů (klouzavé okno nebo accumulate).
+    QVector<double> m_sumSquares;   //!< Průběžný součet druhých mocnin koeficientů.
+    int m_windowFilled;             //!< Počet vektorů v klouzavém okně.
+    int m_windowNext;               //!< Index, kam bude zapsán další vektor klouzavého okna.
+
+    QVector<double> m_accSum;       //!< Součet koeficientů nasčítaný metodou accumulate.
+    QVector<double> m_accSumSquares;//!< Součet druhých mocnin koeficientů nasčítaný metodou accumulate.
+    qint64 m_accCount;              //!< Počet vektorů nasčítaných metodou accumulate.
+
+    /*!
+     * \brief computeTransform Z daných součtů vypočítá odečítanou hodnotu a násobitel každého koeficientu.
+     * \param sum Součty koeficientů.
+     * \param sumSquares Součty druhých mocnin koeficientů.
+     * \param count Počet sečtených vektorů.
+     * \param offset Ukazatel na pole, kam budou zapsány střední hodnoty.
+     * \param scale Ukazatel na pole, kam budou zapsány násobitele.
+     */
+    void computeTransform(const double *sum, const double *sumSquares, qint64 count, float *offset, float *scale) const;
+
+    /*!
+     * \brief apply Odečte od vektoru offset a vynásobí jej scale.
+     * \param coefs Ukazatel na normalizovaný vektor.
+     * \param offset Ukazatel na odečítané hodnoty.
+     * \param scale Ukazatel na násobitele.
+     */
+    void apply(float *coefs, const float *offset, const float *scale) const;
+
+    /*!
+     * \brief updateGlobal Připraví odečítané hodnoty a násobitele režimu Global (z nasčítaných statistik, pokud
+     *                     nebyly nastaveny jiné).
+     * \return True, pokud jsou statistiky k dispozici, jinak false (a je emitován signál error).
+     */
+    bool updateGlobal();
+
+    /*!
+     * \brief normalizeSliding Normalizace jednoho vektoru v režimu Sliding.
+     * \param coefs Ukazatel na normalizovaný vektor.
+     */
+    void normalizeSliding(float *coefs);
+
+    /*!
+     * \brief initStream Metoda provede inicializaci datového toku souboru statistik.
+     * \param stream Ukazatel na inicializovaný datový tok.
+     */
+    void initStream(QDataStream *stream);
+
+signals:
+    /*!
+     * \brief error Signál, který je emitován při chybě.
+     * \param message Popis chyby.
+     */
+    void error(QString message);
+};
+
+#endif
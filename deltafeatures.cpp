@@ -0,0 +1,186 @@
+#include "deltafeatures.h"
+
+DeltaFeatures::DeltaFeatures(int coefsCount, int window, QObject *parent) : QObject(parent) {
+    m_coefsCount = coefsCount;
+    m_window = window;
+    m_count = 0;
+
+    if (coefsCount <= 0 || window <= 0) {
+        emit error("DeltaFeatures::DeltaFeatures: Neplatný počet koeficientů nebo šířka regresního okna.");
+        m_coefsCount = m_window = 0;
+    }
+
+    int sumOfSquares = 0;
+    for (int n = 1; n <= m_window; n++)
+        sumOfSquares += n * n;
+
+    m_normFactor = (sumOfSquares > 0) ? 1.0f / (2.0f * sumOfSquares) : 0.0f;
+    m_staticsCapacity = 2 * m_window + 1;
+    m_deltasCapacity = 3 * m_window + 1;
+    m_statics.fill(0.0f, m_staticsCapacity * m_coefsCount);
+    m_deltas.fill(0.0f, m_deltasCapacity * m_coefsCount);
+}
+
+int DeltaFeatures::coefsCount() const {
+    return m_coefsCount;
+}
+
+int DeltaFeatures::outputSize() const {
+    return 3 * m_coefsCount;
+}
+
+int DeltaFeatures::latency() const {
+    return 2 * m_window;
+}
+
+bool DeltaFeatures::push(const float *coefs, float *output) {
+    if (!coefs || !output || m_coefsCount == 0)
+        return false;
+
+    int t = m_count++;
+    std::copy(coefs, coefs + m_coefsCount, m_statics.data() + (t % m_staticsCapacity) * m_coefsCount);
+
+    /* Delta vektoru t - N již má k dispozici všechny sousedy. */
+    if (t >= m_window) {
+        int index = t - m_window;
+        regression(m_statics.constData(), m_staticsCapacity, index, t,
+                   m_deltas.data() + (index % m_deltasCapacity) * m_coefsCount);
+    }
+
+    if (t < 2 * m_window)
+        return false;
+
+    writeOutput(t - 2 * m_window, t, output);
+    return true;
+}
+
+int DeltaFeatures::flush(float *output) {
+    if (!output || m_count == 0) {
+        reset();
+        return 0;
+    }
+
+    int last = m_count - 1;
+
+    /* Delta vektory posledních N vektorů (sousedé za koncem jsou nahrazeni posledním vektorem). */
+    for (int index = qMax(0, m_count - m_window); index <= last; index++)
+        regression(m_statics.constData(), m_staticsCapacity, index, last,
+                   m_deltas.data() + (index % m_deltasCapacity) * m_coefsCount);
+
+    int written = 0;
+    for (int index = qMax(0, m_count - 2 * m_window); index <= last; index++)
+        writeOutput(index, last, output + (written++) * outputSize());
+
+    reset();
+    return written;
+}
+
+void DeltaFeatures::reset() {
+    m_count = 0;
+}
+
+bool DeltaFeatures::calculate(const float *coefs, int frames, float *output) {
+    if (!coefs || !output || frames <= 0 || m_coefsCount == 0)
+        return false;
+
+    for (int t = 0; t < frames; t++)
+        std::copy(coefs + t * m_coefsCount, coefs + (t + 1) * m_coefsCount, output + t * outputSize());
+
+    return calculate(TensorView::frameMajor(output, frames, outputSize()), 2);
+}
+
+QVector<QVector<float>> DeltaFeatures::calculate(const QVector<QVector<float>> &coefs) {
+    if (coefs.isEmpty() || m_coefsCount == 0)
+        return QVector<QVector<float>>();
+
+    QVector<float> matrix;
+    matrix.reserve(coefs.size() * m_coefsCount);
+
+    for (const QVector<float> &frame : coefs) {
+        if (frame.size() != m_coefsCount) {
+            emit error("DeltaFeatures::calculate: Neočekávaná délka vstupního vektoru koeficientů.");
+            return QVector<QVector<float>>();
+        }
+
+        matrix.append(frame);
+    }
+
+    QVector<float> result(coefs.size() * outputSize());
+    calculate(matrix.constData(), coefs.size(), result.data());
+
+    QVector<QVector<float>> features;
+    features.reserve(coefs.size());
+
+    for (int t = 0; t < coefs.size(); t++)
+        features.append(result.mid(t * outputSize(), outputSize()));
+
+    return features;
+}
+
+bool DeltaFeatures::calculate(const TensorView &features, int order) {
+    if (features.isNull() || m_coefsCount == 0 || order < 1 || order > 2
+            || features.features() != (1 + order) * m_coefsCount) {
+        emit error("DeltaFeatures::calculate: Matice nemá (1 + order) * coefsCount() prvků na segment.");
+        return false;
+    }
+
+    /* Delta koeficienty čtou jen statické sloupce, delta-delta až po dopočtení všech delta koeficientů. */
+    regression(features, 0, m_coefsCount);
+
+    if (order == 2)
+        regression(features, m_coefsCount, 2 * m_coefsCount);
+
+    return true;
+}
+
+void DeltaFeatures::regression(const TensorView &features, int from, int to) const {
+    const qptrdiff stride = features.featureStride();
+    const int last = features.frames() - 1;
+
+    for (int t = 0; t <= last; t++) {
+        float *output = features.frame(t) + to * stride;
+
+        for (int c = 0; c < m_coefsCount; c++)
+            output[c * stride] = 0.0f;
+
+        for (int n = 1; n <= m_window; n++) {
+            const float *next = features.frame(qMin(t + n, last)) + from * stride;
+            const float *prev = features.frame(qMax(t - n, 0)) + from * stride;
+            float weight = n * m_normFactor;
+
+            // souvislé vektory (FrameMajor) zvlášť, aby překladač smyčku vektorizoval
+            if (stride == 1) {
+                for (int c = 0; c < m_coefsCount; c++)
+                    output[c] += weight * (next[c] - prev[c]);
+            }
+            else {
+                for (int c = 0; c < m_coefsCount; c++)
+                    output[c * stride] += weight * (next[c * stride] - prev[c * stride]);
+            }
+        }
+    }
+}
+
+void DeltaFeatures::regression(const float *frames, int capacity, int index, int last, float *output) const {
+    std::fill(output, output + m_coefsCount, 0.0f);
+
+    for (int n = 1; n <= m_window; n++) {
+        const float *next = frames + (qMin(index + n, last) % capacity) * m_coefsCount;
+        const float *prev = frames + (qMax(index - n, 0) % capacity) * m_coefsCount;
+        float weight = n * m_normFactor;
+
+        for (int c = 0; c < m_coefsCount; c++)
+            output[c] += weight * (next[c] - prev[c]);
+    }
+}
+
+void DeltaFeatures::writeOutput(int index, int last, float *output) const {
+    const float *statics = m_statics.constData() + (index % m_staticsCapacity) * m_coefsCount;
+    const float *deltas = m_deltas.constData() + (index % m_deltasCapacity) * m_coefsCount;
+
+    std::copy(statics, statics + m_coefsCount, output);
+    std::copy(deltas, deltas + m_coefsCount, output + m_coefsCount);
+
+    /* Při proudovém zpracování nepřesáhne index + N poslední vypočtený delta vektor, omezení na last se uplatní až ve flush. */
+    regression(m_deltas.constData(), m_deltasCapacity, index, last, output + 2 * m_coefsCount);
+}
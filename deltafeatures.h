@@ -0,0 +1,157 @@
+#ifndef DELTAFEATURES_H
+#define DELTAFEATURES_H
+
+#include <QObject>
+#include <QVector>
+
+#include "pe_config.h"
+#include "tensorview.h"
+
+/*!
+ * \brief Třída DeltaFeatures
+ *
+ * Třída počítá dynamické příznaky, tj. delta (rychlostní) a delta-delta (zrychlovací) koeficienty z vektorů
+ * statických koeficientů (např. výstupu MFCC::calculate nebo FrameKernel::process). Koeficienty jsou počítány
+ * regresí přes okno 2N + 1 sousedních vektorů:
+ *
+ *     d[t] = sum_{n=1}^{N} n * (c[t + n] - c[t - n]) / (2 * sum_{n=1}^{N} n^2)
+ *
+ * Na začátku a konci promluvy jsou chybějící sousední vektory nahrazeny prvním, resp. posledním vektorem.
+ * Výstupní vektor má 3 * coefsCount prvků uložených za sebou: statické koeficienty, delta a delta-delta koeficienty.
+ *
+ * Dávkově lze dynamické koeficienty dopočítat také přímo v matici TensorView (např. ve výstupu OfflineExtractor),
+ * jejíž první coefsCount() prvky vektoru jsou statické koeficienty a za nimi jsou místa pro delta, případně
+ * delta-delta koeficienty (rozložení HTK _D a _A).
+ *
+ * Proudové zpracování (metody push a flush) si pamatuje pouze 2N + 1 posledních statických a 3N + 1 posledních
+ * delta vektorů. Výstup je oproti vstupu zpožděn o pevný počet latency() = 2N vektorů. Dávkové zpracování (metody
+ * calculate) dává stejné výsledky jako proudové.
+ */
+class DeltaFeatures : public QObject {
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief DeltaFeatures Konstruktor třídy.
+     * \param coefsCount Počet statických koeficientů vstupních vektorů.
+     * \param window Poloviční šířka regresního okna N (obvykle 2).
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolnění).
+     */
+    explicit DeltaFeatures(int coefsCount, int window = 2, QObject *parent = nullptr);
+
+    /*!
+     * \brief coefsCount Vrací počet statických koeficientů vstupních vektorů.
+     * \return Počet statických koeficientů.
+     */
+    int coefsCount() const;
+
+    /*!
+     * \brief outputSize Vrací počet prvků výstupního vektoru (3 * coefsCount()).
+     * \return Počet prvků výstupního vektoru.
+     */
+    int outputSize() const;
+
+    /*!
+     * \brief latency Vrací zpoždění proudového zpracování ve vektorech.
+     * \return Počet vektorů, o které je výstup zpožděn.
+     */
+    int latency() const;
+
+    /*!
+     * \brief push Metoda přijme další vektor statických koeficientů. Pokud je již k dispozici vše potřebné pro
+     *             výpočet vektoru zpožděného o latency() vektorů, zapíše jej do výstupního pole.
+     * \param coefs Ukazatel na coefsCount() statických koeficientů.
+     * \param output Ukazatel na pole o velikosti alespoň outputSize() prvků.
+     * \return True, pokud byl do výstupního pole zapsán vektor, jinak false.
+     */
+    bool push(const float *coefs, float *output);
+
+    /*!
+     * \brief flush Metoda dopočítá zbývající (nejvýše latency()) vektory na konci promluvy a připraví objekt
+     *              na zpracování další promluvy.
+     * \param output Ukazatel na pole o velikosti alespoň latency() * outputSize() prvků.
+     * \return Počet vektorů zapsaných do výstupního pole.
+     */
+    int flush(float *output);
+
+    /*!
+     * \brief reset Metoda zahodí rozpracovanou promluvu bez výpočtu zbývajících vektorů.
+     */
+    void reset();
+
+    /*!
+     * \brief calculate Dávkový výpočet nad souvislou maticí statických koeficientů (vektory uložené za sebou).
+     * \param coefs Ukazatel na frames * coefsCount() statických koeficientů.
+     * \param frames Počet vektorů.
+     * \param output Ukazatel na pole o velikosti alespoň frames * outputSize() prvků.
+     * \return True, pokud výpočet proběhl, jinak false.
+     */
+    bool calculate(const float *coefs, int frames, float *output);
+
+    /*!
+     * \brief calculate Přetížená metoda. Dávkový výpočet nad vektory statických koeficientů (např. výstupem
+     *                  MfccFile::readAll). V případě vektorů nesprávné velikosti je emitován signál error a je
+     *                  vrácen prázdný vektor.
+     * \param coefs Vektory statických koeficientů.
+     * \return Vektory o outputSize() prvcích.
+     */
+    QVector<QVector<float>> calculate(const QVector<QVector<float>> &coefs);
+
+    /*!
+     * \brief calculate Přetížená metoda. Dávkový výpočet na místě: do matice se statickými koeficienty v prvních
+     *                  coefsCount() prvcích každého vektoru zapíše delta (order 1), případně i delta-delta (order 2)
+     *                  koeficienty za ně. Matice může mít libovolné kroky.
+     * \param features Matice s (1 + order) * coefsCount() prvky na segment.
+     * \param order Řád dynamických koeficientů (1 nebo 2).
+     * \return True, pokud výpočet proběhl, jinak false (a je emitován signál error).
+     */
+    bool calculate(const TensorView &features, int order = 2);
+
+private:
+    int m_coefsCount;               //!< Počet statických koeficientů.
+    int m_window;                   //!< Poloviční šířka regresního okna N.
+    float m_normFactor;             //!< Převrácená hodnota jmenovatele regrese 1 / (2 * sum n^2).
+    int m_staticsCapacity;          //!< Počet vektorů kruhového bufferu statických koeficientů (2N + 1).
+    int m_deltasCapacity;           //!< Počet vektorů kruhového bufferu delta koeficientů (3N + 1).
+    int m_count;                    //!< Počet vektorů přijatých od začátku promluvy.
+    QVector<float> m_statics;       //!< Kruhový buffer statických koeficientů.
+    QVector<float> m_deltas;        //!< Kruhový buffer delta koeficientů.
+
+    /*!
+     * \brief regression Metoda vypočítá regresní koeficienty vektoru index. Indexy sousedních vektorů jsou
+     *                   omezeny na rozsah 0 až last.
+     * \param frames Kruhový buffer (nebo matice) vstupních vektorů.
+     * \param capacity Počet vektorů bufferu (index vektoru je brán modulo capacity).
+     * \param index Index vektoru, pro který je regrese počítána.
+     * \param last Index posledního dostupného vektoru.
+     * \param output Ukazatel na pole, kam bude zapsáno m_coefsCount koeficientů.
+     */
+    void regression(const float *frames, int capacity, int index, int last, float *output) const;
+
+    /*!
+     * \brief regression Přetížená metoda pro matici TensorView. Regrese sloupců from až from + coefsCount() - 1
+     *                   je zapsána do sloupců to až to + coefsCount() - 1 (indexy sousedních segmentů jsou omezeny
+     *                   na rozsah matice).
+     * \param features Matice koeficientů.
+     * \param from Index prvního vstupního sloupce.
+     * \param to Index prvního výstupního sloupce.
+     */
+    void regression(const TensorView &features, int from, int to) const;
+
+    /*!
+     * \brief writeOutput Metoda zapíše výstupní vektor index složený ze statických, delta a delta-delta koeficientů.
+     * \param index Index výstupního vektoru.
+     * \param last Index posledního přijatého vektoru.
+     * \param output Ukazatel na pole o velikosti alespoň outputSize() prvků.
+     */
+    void writeOutput(int index, int last, float *output) const;
+
+signals:
+    /*!
+     * \brief error Signál, který je emitován při chybě.
+     * \param message Popis chyby.
+     */
+    void error(QString message);
+};
+
+#endif
@@ -1,13 +1,25 @@
 #include "fft.h"
 
 FFT::FFT(int segmentSize, QObject *parent) : QObject(parent) {
+    m_policy = PowerOfTwo;
+    init(segmentSize);
+}
+
+FFT::FFT(int segmentSize, SizePolicy policy, QObject *parent) : QObject(parent) {
+    m_policy = policy;
+    init(segmentSize);
+}
+
+void FFT::init(int segmentSize) {
+    m_maxSegmentSize = m_espdSize = 0;
+    m_fftCfg = m_ifftCft = nullptr;
+
     if (segmentSize <= 0) {
         emit error("FFT::FFT: Neplatná velikost vstupních segmentů.");
         return;
     }
 
-    // tento výpočet vyplívá z definice algoritmu FFT
-    for (m_maxSegmentSize = 1; m_maxSegmentSize < segmentSize; m_maxSegmentSize *= 2);
+    m_maxSegmentSize = fftSizeFor(segmentSize, m_policy);
     m_espdSize = (m_maxSegmentSize / 2) + 1;
 
     m_fftCfg = kiss_fftr_alloc(m_maxSegmentSize, 0, nullptr, nullptr);
@@ -27,6 +39,29 @@ int FFT::espdSize() const {
     return m_espdSize;
 }
 
+int FFT::fftSize() const {
+    return m_maxSegmentSize;
+}
+
+FFT::SizePolicy FFT::sizePolicy() const {
+    return m_policy;
+}
+
+int FFT::fftSizeFor(int segmentSize, SizePolicy policy) {
+    if (segmentSize <= 0)
+        return UNDEFINED;
+
+    // reálná FFT knihovny kissFFT vyžaduje sudou velikost
+    if (policy == NextFastSize)
+        return kiss_fftr_next_fast_size_real(segmentSize);
+
+    // tento výpočet vyplívá z definice algoritmu FFT
+    int fftSize;
+    for (fftSize = 1; fftSize < segmentSize; fftSize *= 2);
+
+    return fftSize;
+}
+
 QVector<float> FFT::transformEucl(QVector<float> segment) {
     if (segment.isEmpty())
         return QVector<float>();
@@ -36,6 +71,8 @@ QVector<float> FFT::transformEucl(QVector<float> segment) {
         return QVector<float>();
     }
 
+    PE_STAGE_BEGIN(Fft);
+
     if (segment.size() < m_maxSegmentSize)
         segment = prepareSegment(segment);
 
@@ -45,6 +82,62 @@ QVector<float> FFT::transformEucl(QVector<float> segment) {
     return euclidNorm(cpx);
 }
 
+QVector<float> FFT::transformEucl(QVector<float> segment, int firstBin, int lastBin) {
+    if (segment.isEmpty())
+        return QVector<float>();
+
+    if (segment.size() > m_maxSegmentSize || firstBin < 0 || lastBin <= firstBin || lastBin > m_espdSize) {
+        emit error("FFT::transformEucl: Vstupní segment je větší je přednastavená velikost nebo je neplatné pásmo.");
+        return QVector<float>();
+    }
+
+    PE_STAGE_BEGIN(Fft);
+
+    QVector<float> magnitudes(m_espdSize, 0.0f);
+
+    /* Úzké pásmo: Goertzelův algoritmus nad vzorky segmentu (doplnění nulami nic nemění). */
+    if (Goertzel::isCheaper(lastBin - firstBin, segment.size(), m_maxSegmentSize)) {
+        Goertzel goertzel(m_maxSegmentSize, firstBin, lastBin);
+        goertzel.power(segment.constData(), segment.size(), magnitudes.data());
+
+        for (int k = firstBin; k < lastBin; k++)
+            magnitudes[k] = qSqrt(magnitudes[k]);
+
+        return magnitudes;
+    }
+
+    if (segment.size() < m_maxSegmentSize)
+        segment = prepareSegment(segment);
+
+    QVector<kiss_fft_cpx> cpx = realFFt(segment);
+    if (cpx.isEmpty()) return QVector<float>();
+
+    for (int k = firstBin; k < lastBin; k++)
+        magnitudes[k] = qSqrt((cpx[k].r * cpx[k].r) + (cpx[k].i * cpx[k].i));
+
+    return magnitudes;
+}
+
+QVector<float> FFT::transformPower(QVector<float> segment) {
+    if (segment.isEmpty())
+        return QVector<float>();
+
+    if (segment.size() > m_maxSegmentSize) {
+        emit error("FFT::transformPower: Vstupní segment je větší je přednastavená velikost.");
+        return QVector<float>();
+    }
+
+    PE_STAGE_BEGIN(Fft);
+
+    if (segment.size() < m_maxSegmentSize)
+        segment = prepareSegment(segment);
+
+    QVector<kiss_fft_cpx> cpx = realFFt(segment);
+    if (cpx.isEmpty()) return QVector<float>();
+
+    return squaredNorm(cpx);
+}
+
 QVector<kiss_fft_cpx> FFT::realFFt(QVector<float> segment) {
     if (segment.size() != m_maxSegmentSize)
         return QVector<kiss_fft_cpx>();
@@ -121,3 +214,15 @@ QVector<float> FFT::euclidNorm(QVector<kiss_fft_cpx> cpx) {
 
     return magnitudes;
 }
+
+QVector<float> FFT::squaredNorm(QVector<kiss_fft_cpx> cpx) {
+    if (cpx.isEmpty()) return QVector<float>();
+
+    QVector<float> powers;
+    powers.reserve(m_espdSize);
+
+    for (kiss_fft_cpx val : cpx)
+        powers.append((val.r * val.r) + (val.i * val.i));
+
+    return powers;
+}
@@ -8,6 +8,8 @@
 #include <QDebug>
 
 #include "pe_config.h"
+#include "instrumentation.h"
+#include "goertzel.h"
 
 #include "kiss_fft//kiss_fft.h"
 #include "kiss_fft/kiss_fftr.h"
@@ -17,23 +19,42 @@
  *
  * Tato třída reprezentuje dopřednou diskrétní Fourierovu transformaci. Kromě samotné transformace
  * metoda nad výsledkem provádí výpočet magnitud jednotlivých členů komplexních váhových koeficientů,
- * a to použitím Euclidovské normy (l2). Využívá algoritmu FFT, jehož podmínkou je velikost vstupních
- * segmentů v mocninách čísla 2. Velikost výstupního vektoru odhadu výkonové spektrální hustoty je
- * vypočítán již při konstrukci objeku. Pokud je pak velikost dalších segmentů menší než zadaná, jsou
- * tyto segmenty doplněny nulami. V případě většího segmentu třídá hlásí chybu pomocí signálu error.
+ * a to použitím Euclidovské normy (l2). Velikost transformace (fftSize) je vypočítána již při konstrukci
+ * objektu podle zvolené strategie (SizePolicy): buď nejbližší vyšší mocnina čísla 2 (výchozí, původní chování),
+ * nebo nejbližší vyšší sudá velikost, kterou knihovna kissFFT rozloží na faktory 2, 3, 4 a 5 (NextFastSize).
+ * Druhá možnost u velikostí segmentů, které nejsou mocninou 2 (např. 25 ms okno, 1103 vzorků při 44,1 kHz),
+ * téměř dvakrát zkracuje transformaci i odhad výkonové spektrální hustoty. Pokud je pak velikost dalších
+ * segmentů menší než fftSize, jsou tyto segmenty doplněny nulami. V případě většího segmentu třídá hlásí chybu
+ * pomocí signálu error.
  */
 class FFT : public QObject {
     Q_OBJECT
 
 public:
     /*!
-     * \brief FFT Konstruktor třídy. Provede výpočet maximální velikosti vstupních segmentů a podle
+     * \brief SizePolicy Strategie výběru velikosti transformace pro danou velikost segmentu.
+     */
+    enum SizePolicy {
+        PowerOfTwo,     //!< Nejbližší vyšší (nebo stejná) mocnina čísla 2.
+        NextFastSize    //!< Nejbližší vyšší (nebo stejná) sudá velikost s faktory 2, 3 a 5 (kiss_fftr_next_fast_size_real).
+    };
+
+    /*!
+     * \brief FFT Konstruktor třídy. Provede výpočet maximální velikosti vstupních segmentů (mocnina čísla 2) a podle
      *            toho i výpočet velikosti výsledných vektorů odhadu výkonové spektrální hustoty.
      * \param segmentSize Předpokládaná velikost vstupních segmentů normalizovaného signálu.
      * \param parent Ukazatel na rodičovský objekt (kvůli dynamickému uvolnění).
      */
     explicit FFT(int segmentSize, QObject *parent = nullptr);
 
+    /*!
+     * \brief FFT Přetížený konstruktor, velikost transformace je vypočtena podle dané strategie.
+     * \param segmentSize Předpokládaná velikost vstupních segmentů normalizovaného signálu.
+     * \param policy Strategie výběru velikosti transformace.
+     * \param parent Ukazatel na rodičovský objekt (kvůli dynamickému uvolnění).
+     */
+    explicit FFT(int segmentSize, SizePolicy policy, QObject *parent = nullptr);
+
     /*!
      * Destruktor třídy.
      */
@@ -45,6 +66,27 @@ public:
      */
     int espdSize() const;
 
+    /*!
+     * \brief fftSize Metoda vrátí velikost transformace, tj. počet vzorků, na který jsou segmenty doplněny nulami.
+     * \return Velikost transformace.
+     */
+    int fftSize() const;
+
+    /*!
+     * \brief sizePolicy Metoda vrátí strategii, podle které byla vypočtena velikost transformace.
+     * \return Strategie výběru velikosti transformace.
+     */
+    SizePolicy sizePolicy() const;
+
+    /*!
+     * \brief fftSizeFor Vypočítá velikost transformace pro danou velikost segmentu a strategii. Metodu využívají
+     *                   i ostatní třídy, které volají kissFFT přímo (FrameKernel), aby byly výsledky shodné.
+     * \param segmentSize Velikost vstupních segmentů.
+     * \param policy Strategie výběru velikosti transformace.
+     * \return Velikost transformace (sudá, alespoň segmentSize) nebo UNDEFINED při neplatné velikosti segmentu.
+     */
+    static int fftSizeFor(int segmentSize, SizePolicy policy);
+
     /*!
      * \brief transformEucl Metoda provede samotnou diskréní Fourierovu transformaci a následný výpočet
      *                      výsledných komplexních koeficientů pomocí metody euclidNorm. V případě, že
@@ -56,6 +98,26 @@ public:
      */
     QVector<float> transformEucl(QVector<float> segment);
 
+    /*!
+     * \brief transformEucl Přetížená metoda, která magnitudy počítá jen v pásmu firstBin až lastBin - 1 (např. prvky,
+     *                      které čte banka filtrů, viz FilterBank::minBin a maxBin), ostatní prvky výsledku jsou
+     *                      nulové. Pokud je pásmo dostatečně úzké (viz Goertzel::isCheaper), jsou prvky vypočteny
+     *                      Goertzelovým algoritmem bez celé transformace.
+     * \param segment Vektor, který obsahuje vzorky segmentu, z něhož je počítána disktréní F. transformace.
+     * \param firstBin Index prvního počítaného prvku.
+     * \param lastBin Index za posledním počítaným prvkem (nejvýše espdSize()).
+     * \return Vektor magnitud (espdSize() prvků) nebo prázdný vektor při chybě.
+     */
+    QVector<float> transformEucl(QVector<float> segment, int firstBin, int lastBin);
+
+    /*!
+     * \brief transformPower Metoda provede diskrétní Fourierovu transformaci stejně jako transformEucl, místo magnitud
+     *                       však vrací jejich kvadráty (výkonové spektrum), a ušetří tak odmocninu pro každý prvek.
+     * \param segment Vektor, který obsahuje vzorky segmentu, z něhož je počítána disktréní F. transformace.
+     * \return Vektor výkonového spektra daného segmentu nebo prázdný vektor při chybě.
+     */
+    QVector<float> transformPower(QVector<float> segment);
+
     /*!
      * \brief realFft Metoda volá samotné funkce knihovny kissFFT a provádí samotný výpočet komplexních
      *                váhových koeficientů, které vrací jako vektor těchto hodnot.
@@ -94,14 +156,21 @@ public:
     void invRealFFT(QVector<kiss_fft_cpx> &cpx, QVector<float> &segment);
 
 private:
-    int m_maxSegmentSize;       //!< Maximální velikost vstupních segmentů (mocnina čísla 2).
+    int m_maxSegmentSize;       //!< Maximální velikost vstupních segmentů, tj. velikost transformace (viz SizePolicy).
     int m_espdSize;             //!< Velikost výstupních vektorů odhadu výkonové spektrální hustoty.
+    SizePolicy m_policy;        //!< Strategie výběru velikosti transformace.
     kiss_fftr_cfg m_fftCfg;     //!< Struktura knihovny kissFFT potřebná pro výpočet FFT.
     kiss_fftr_cfg m_ifftCft;    //!< Struktura knihovny kissFFT potřebná pro výpočet inverze FFT.
 
+    /*!
+     * \brief init Metoda vypočítá velikost transformace a alokuje konfigurace knihovny kissFFT.
+     * \param segmentSize Předpokládaná velikost vstupních segmentů.
+     */
+    void init(int segmentSize);
+
     /*!
      * \brief prepareSegment Tato metoda je volána v případě, že velikost vstupního segmentu je menší
-     *                       než hodnota m_maxSegmentSize (mocnina 2). V takovém případě metoda vytvoří nový
+     *                       než hodnota m_maxSegmentSize (velikost transformace). V takovém případě metoda vytvoří nový
      *                       vektor, do kterého zkopíruje prvky vstupního vektoru. Takto vytvořený vektor
      *                       doplní čísly nula do počtu m_maxSegmentSize.
      * \param segment Vstupní segment akustického signálu.
@@ -117,6 +186,13 @@ private:
      */
     QVector<float> euclidNorm(QVector<kiss_fft_cpx> cpx);
 
+    /*!
+     * \brief squaredNorm Podle zadaného pole komplexních koeficientů vypočítá kvadráty jejich magnitud.
+     * \param cpx Vektor komplexních váhových koeficientů.
+     * \return Vektor kvadrátů magnitud, tj. výkonové spektrum.
+     */
+    QVector<float> squaredNorm(QVector<kiss_fft_cpx> cpx);
+
 signals:
     /*!
      * \brief error Signál, který je emitován při chybě.
@@ -0,0 +1,271 @@
+#include "filterbank.h"
+#include "melfilterbank.h"
+
+#include <QtMath>
+
+namespace {
+
+/* Ekvivalentní pravoúhlá šířka pásma sluchového filtru se střední frekvencí fc (Glasberg a Moore). */
+inline double erbBandwidth(double fc) {
+    return 24.7 * (4.37 * fc / 1000.0 + 1.0);
+}
+
+}
+
+FilterBank::FilterBank() {
+    m_scale = LegacyMel;
+    m_espdSize = 0;
+    m_count = 0;
+    m_minBin = m_maxBin = 0;
+}
+
+FilterBank::FilterBank(int espdSize, int filterCount, int sampleRate, Scale scale, float lowFrequency,
+                       float highFrequency, Normalization normalization) {
+    m_scale = scale;
+    m_espdSize = 0;
+    m_count = 0;
+    m_minBin = m_maxBin = 0;
+
+    if (espdSize < 2 || filterCount <= 0 || sampleRate <= 0 || scale < LegacyMel || scale > Erb)
+        return;
+
+    const double nyquist = sampleRate / 2.0;
+    const double high = (highFrequency == FILTERBANK_NYQUIST) ? nyquist : highFrequency;
+
+    if (scale != LegacyMel && !(lowFrequency >= 0.0f && high > lowFrequency && high <= nyquist))
+        return;
+
+    m_espdSize = espdSize;
+    m_count = filterCount;
+
+    m_begin.reserve(filterCount);
+    m_end.reserve(filterCount);
+    m_offset.reserve(filterCount);
+
+    if (scale == LegacyMel)
+        initLegacy(sampleRate);
+    else initAuditory(sampleRate, lowFrequency, high);
+
+    normalize(normalization);
+
+    m_minBin = m_espdSize;
+    for (int m = 0; m < m_count; m++) {
+        m_minBin = qMin(m_minBin, m_begin[m]);
+        m_maxBin = qMax(m_maxBin, m_end[m]);
+    }
+}
+
+bool FilterBank::isValid() const {
+    return m_count > 0;
+}
+
+FilterBank::Scale FilterBank::scale() const {
+    return m_scale;
+}
+
+int FilterBank::espdSize() const {
+    return m_espdSize;
+}
+
+int FilterBank::count() const {
+    return m_count;
+}
+
+int FilterBank::begin(int filter) const {
+    return m_begin[filter];
+}
+
+int FilterBank::end(int filter) const {
+    return m_end[filter];
+}
+
+const float *FilterBank::weights(int filter) const {
+    return m_weights.constData() + m_offset[filter];
+}
+
+int FilterBank::minBin() const {
+    return m_minBin;
+}
+
+int FilterBank::maxBin() const {
+    return m_maxBin;
+}
+
+int FilterBank::weightsCount() const {
+    return m_weights.size();
+}
+
+QVector<float> FilterBank::getFilter(int filter) const {
+    if (filter < 0 || filter >= m_count)
+        return QVector<float>();
+
+    QVector<float> dense(m_espdSize, 0.0f);
+    const float *values = weights(filter);
+
+    for (int k = m_begin[filter]; k < m_end[filter]; k++)
+        dense[k] = values[k - m_begin[filter]];
+
+    return dense;
+}
+
+void FilterBank::apply(const float *espd, float *energies) const {
+    const float *weights = m_weights.constData();
+
+    for (int m = 0; m < m_count; m++) {
+        const float *filter = weights + m_offset[m] - m_begin[m];
+        float energy = 0.0f;
+
+        for (int k = m_begin[m]; k < m_end[m]; k++)
+            energy += espd[k] * filter[k];
+
+        energies[m] = energy;
+    }
+}
+
+double FilterBank::toScale(Scale scale, double frequency) {
+    switch (scale) {
+    case LegacyMel:
+        return 1125.0 * qLn(1.0 + frequency / 700.0);
+    case HtkMel:
+        return 2595.0 * std::log10(1.0 + frequency / 700.0);
+    case SlaneyMel:
+        // lineární část 200/3 Hz na mel, nad 1 kHz logaritmická s krokem ln(6,4) / 27 na mel
+        if (frequency < 1000.0)
+            return frequency / (200.0 / 3.0);
+        return 15.0 + qLn(frequency / 1000.0) / (qLn(6.4) / 27.0);
+    case Bark:
+        return (26.81 * frequency) / (1960.0 + frequency) - 0.53;
+    case Erb:
+        return 21.4 * std::log10(1.0 + 0.00437 * frequency);
+    }
+
+    return frequency;
+}
+
+double FilterBank::fromScale(Scale scale, double value) {
+    switch (scale) {
+    case LegacyMel:
+        return 700.0 * (qExp(value / 1125.0) - 1.0);
+    case HtkMel:
+        return 700.0 * (qPow(10.0, value / 2595.0) - 1.0);
+    case SlaneyMel:
+        if (value < 15.0)
+            return value * (200.0 / 3.0);
+        return 1000.0 * qExp((value - 15.0) * (qLn(6.4) / 27.0));
+    case Bark:
+        return 1960.0 * (value + 0.53) / (26.28 - value);
+    case Erb:
+        return (qPow(10.0, value / 21.4) - 1.0) / 0.00437;
+    }
+
+    return value;
+}
+
+void FilterBank::append(const QVector<float> &filter, int first) {
+    int begin = 0;
+    while (begin < filter.size() && filter[begin] == 0.0f)
+        begin++;
+
+    int end = filter.size();
+    while (end > begin && filter[end - 1] == 0.0f)
+        end--;
+
+    m_begin.append(first + begin);
+    m_end.append(first + end);
+    m_offset.append(m_weights.size());
+
+    for (int k = begin; k < end; k++)
+        m_weights.append(filter[k]);
+}
+
+void FilterBank::initLegacy(int sampleRate) {
+    MelFilterBank filters(m_espdSize, m_count, sampleRate);
+
+    for (int m = 0; m < m_count; m++)
+        append(filters.getFilter(m), 0);
+}
+
+void FilterBank::initAuditory(int sampleRate, double lowFrequency, double highFrequency) {
+    /* Body rozložené rovnoměrně na stupnici, filtr m má střed v bodě m + 1 a sousední body jsou jeho okraje. */
+    QVector<double> points(m_count + 2);
+    const double low = toScale(m_scale, lowFrequency);
+    const double step = (toScale(m_scale, highFrequency) - low) / (m_count + 1);
+
+    for (int i = 0; i < points.size(); i++)
+        points[i] = fromScale(m_scale, low + i * step);
+
+    points[0] = lowFrequency;
+    points[m_count + 1] = highFrequency;
+
+    const double binWidth = sampleRate / (2.0 * (m_espdSize - 1));
+    const int lowBin = qCeil(lowFrequency / binWidth);
+    const int highBin = qMin(m_espdSize - 1, qFloor(highFrequency / binWidth));
+
+    for (int m = 0; m < m_count; m++) {
+        const double center = points[m + 1];
+        int first, last;
+
+        if (m_scale == Erb) {
+            first = lowBin;
+            last = highBin;
+        }
+        else {
+            first = qMax(lowBin, qFloor(points[m] / binWidth) + 1);
+            last = qMin(highBin, qCeil(points[m + 2] / binWidth) - 1);
+        }
+
+        QVector<float> filter(qMax(0, last - first + 1), 0.0f);
+
+        for (int k = first; k <= last; k++) {
+            const double f = k * binWidth;
+            double weight;
+
+            if (m_scale == Erb) {
+                const double x = (f - center) / (1.019 * erbBandwidth(center));
+                weight = 1.0 / ((1.0 + x * x) * (1.0 + x * x));
+
+                if (weight < FILTERBANK_GAMMATONE_THRESHOLD)
+                    weight = 0.0;
+            }
+            else if (f <= center)
+                weight = (f - points[m]) / (center - points[m]);
+            else weight = (points[m + 2] - f) / (points[m + 2] - center);
+
+            filter[k - first] = static_cast<float>(qMax(0.0, weight));
+        }
+
+        append(filter, first);
+
+        /* Filtr užší než rozestup prvků: váha 1 v prvku nejbližším středu. */
+        if (m_begin[m] == m_end[m]) {
+            const int bin = qBound(0, qRound(center / binWidth), m_espdSize - 1);
+
+            m_begin[m] = bin;
+            m_end[m] = bin + 1;
+            m_weights.append(1.0f);
+        }
+    }
+}
+
+void FilterBank::normalize(Normalization normalization) {
+    if (normalization == NoNormalization)
+        return;
+
+    for (int m = 0; m < m_count; m++) {
+        float *values = m_weights.data() + m_offset[m];
+        const int size = m_end[m] - m_begin[m];
+        float norm = 0.0f;
+
+        for (int k = 0; k < size; k++) {
+            if (normalization == PeakNormalization)
+                norm = qMax(norm, values[k]);
+            else norm += values[k];
+        }
+
+        if (norm <= 0.0f)
+            continue;
+
+        for (int k = 0; k < size; k++)
+            values[k] /= norm;
+    }
+}
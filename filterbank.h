@@ -0,0 +1,217 @@
+#ifndef FILTERBANK_H
+#define FILTERBANK_H
+
+#include <QVector>
+
+#include "pe_config.h"
+
+/*!
+ * Hodnota horní mezní frekvence, která označuje Nyquistovu frekvenci (polovinu frekvence vzorkování).
+ */
+#define FILTERBANK_NYQUIST -1.0f
+
+/*!
+ * Nejmenší uložená váha filtrů typu gammatone (menší váhy na okrajích filtru jsou vynulovány).
+ */
+#define FILTERBANK_GAMMATONE_THRESHOLD 1e-3f
+
+/*!
+ * \brief Třída FilterBank
+ *
+ * Třída generuje banky sluchových filtrů nad odhadem výkonové spektrální hustoty a ukládá je v kompaktní řídké
+ * reprezentaci: pro každý filtr rozsah nenulových prvků <begin, end) a jeho váhy uložené za sebou v jediném poli.
+ * Výpočet energií filtrů (apply) tak prochází pouze nenulové části filtrů a prvky nad horní mezní frekvencí
+ * nejsou čteny vůbec (viz maxBin).
+ *
+ * Stupnice LegacyMel odpovídá přesně třídě MelFilterBank (melovská stupnice 1125 * ln(1 + f / 700), filtry
+ * rozložené až do frekvence vzorkování a hranice zaokrouhlené dolů na celé prvky), mezní frekvence u ní nemají
+ * vliv. Ostatní stupnice rozkládají středy filtrů frekvencí rovnoměrně na dané stupnici mezi dolní a horní
+ * mezní frekvencí (výchozí je Nyquistova frekvence) a váhy počítají ze skutečných frekvencí prvků
+ * (k * sampleRate / fftSize), horní filtry se tedy neslévají do posledního prvku:
+ *   - HtkMel: 2595 * log10(1 + f / 700), trojúhelníkové filtry,
+ *   - SlaneyMel: lineární do 1 kHz, nad ní logaritmická (Auditory Toolbox), trojúhelníkové filtry,
+ *   - Bark: Traunmüllerova aproximace, trojúhelníkové filtry,
+ *   - Erb: stupnice ERB (Glasberg a Moore), amplitudová charakteristika gammatone filtru 4. řádu se šířkou pásma
+ *     1,019 ERB, váhy menší než FILTERBANK_GAMMATONE_THRESHOLD jsou vynulovány.
+ * Filtr užší než rozestup prvků, který by neobsahoval žádný prvek, dostane váhu 1 v prvku nejbližším jeho středu.
+ *
+ * Normalizace PeakNormalization nastaví největší váhu každého filtru na 1, AreaNormalization součet jeho vah na 1.
+ *
+ * Objekt je hodnotový (lze jej kopírovat) a po vytvoření se nemění, může být proto sdílen mezi vlákny.
+ */
+class FilterBank {
+
+public:
+    /*!
+     * \brief Scale Frekvenční stupnice a tvar filtrů.
+     */
+    enum Scale {
+        LegacyMel,  //!< Původní banka MelFilterBank (výchozí).
+        HtkMel,     //!< Melovská stupnice HTK, trojúhelníkové filtry.
+        SlaneyMel,  //!< Melovská stupnice Slaney, trojúhelníkové filtry.
+        Bark,       //!< Barkova stupnice, trojúhelníkové filtry.
+        Erb         //!< Stupnice ERB, filtry typu gammatone.
+    };
+
+    /*!
+     * \brief Normalization Normalizace vah filtrů.
+     */
+    enum Normalization {
+        NoNormalization,    //!< Bez normalizace (vrchol trojúhelníku ve skutečné střední frekvenci má váhu 1).
+        PeakNormalization,  //!< Největší váha filtru je 1.
+        AreaNormalization   //!< Součet vah filtru je 1.
+    };
+
+    /*!
+     * \brief FilterBank Konstruktor prázdné (neplatné) banky.
+     */
+    FilterBank();
+
+    /*!
+     * \brief FilterBank Konstruktor, který banku vygeneruje.
+     * \param espdSize Počet prvků odhadu výkonové spektrální hustoty (fftSize / 2 + 1).
+     * \param filterCount Počet filtrů.
+     * \param sampleRate Frekvence vzorkování signálu.
+     * \param scale Frekvenční stupnice a tvar filtrů.
+     * \param lowFrequency Dolní mezní frekvence v Hz.
+     * \param highFrequency Horní mezní frekvence v Hz (nejvýše Nyquistova frekvence, FILTERBANK_NYQUIST pro ni).
+     * \param normalization Normalizace vah filtrů.
+     */
+    FilterBank(int espdSize, int filterCount, int sampleRate, Scale scale = LegacyMel, float lowFrequency = 0.0f,
+               float highFrequency = FILTERBANK_NYQUIST, Normalization normalization = NoNormalization);
+
+    /*!
+     * \brief isValid Zjistí, zda byla banka vygenerována (platné parametry konstruktoru).
+     * \return True, pokud je banka platná, jinak false.
+     */
+    bool isValid() const;
+
+    /*!
+     * \brief scale Vrací frekvenční stupnici banky.
+     * \return Frekvenční stupnice.
+     */
+    Scale scale() const;
+
+    /*!
+     * \brief espdSize Vrací počet prvků odhadu výkonové spektrální hustoty, pro který je banka vytvořena.
+     * \return Počet prvků odhadu.
+     */
+    int espdSize() const;
+
+    /*!
+     * \brief count Vrací počet filtrů.
+     * \return Počet filtrů.
+     */
+    int count() const;
+
+    /*!
+     * \brief begin Vrací index prvního nenulového prvku filtru.
+     * \param filter Index filtru.
+     * \return Index prvního nenulového prvku.
+     */
+    int begin(int filter) const;
+
+    /*!
+     * \brief end Vrací index za posledním nenulovým prvkem filtru.
+     * \param filter Index filtru.
+     * \return Index za posledním nenulovým prvkem.
+     */
+    int end(int filter) const;
+
+    /*!
+     * \brief weights Vrací váhy nenulové části filtru (end(filter) - begin(filter) vah).
+     * \param filter Index filtru.
+     * \return Ukazatel na váhy prvků begin(filter) až end(filter) - 1.
+     */
+    const float *weights(int filter) const;
+
+    /*!
+     * \brief minBin Vrací index prvního prvku, který čte některý z filtrů. Prvky pod tímto indexem nemají na výstup
+     *               banky vliv a nemusí být počítány.
+     * \return Index prvního použitého prvku.
+     */
+    int minBin() const;
+
+    /*!
+     * \brief maxBin Vrací index za posledním prvkem, který čte některý z filtrů. Prvky od tohoto indexu výše nemají
+     *               na výstup banky vliv a nemusí být počítány.
+     * \return Index za posledním použitým prvkem.
+     */
+    int maxBin() const;
+
+    /*!
+     * \brief weightsCount Vrací počet uložených vah, tj. počet násobení jednoho volání apply.
+     * \return Počet uložených vah.
+     */
+    int weightsCount() const;
+
+    /*!
+     * \brief getFilter Vrací plný (hustý) vektor vah filtru.
+     * \param filter Index filtru.
+     * \return Vektor espdSize() vah nebo prázdný vektor při neplatném indexu.
+     */
+    QVector<float> getFilter(int filter) const;
+
+    /*!
+     * \brief apply Vypočítá energie všech filtrů (skalární součiny filtrů a odhadu spektra) v řídké reprezentaci.
+     * \param espd Ukazatel na alespoň maxBin() prvků odhadu spektra.
+     * \param energies Ukazatel na pole pro count() energií.
+     */
+    void apply(const float *espd, float *energies) const;
+
+    /*!
+     * \brief toScale Převede frekvenci v Hz na danou stupnici.
+     * \param scale Frekvenční stupnice.
+     * \param frequency Frekvence v Hz.
+     * \return Hodnota na stupnici.
+     */
+    static double toScale(Scale scale, double frequency);
+
+    /*!
+     * \brief fromScale Převede hodnotu dané stupnice na frekvenci v Hz.
+     * \param scale Frekvenční stupnice.
+     * \param value Hodnota na stupnici.
+     * \return Frekvence v Hz.
+     */
+    static double fromScale(Scale scale, double value);
+
+private:
+    Scale m_scale;                  //!< Frekvenční stupnice.
+    int m_espdSize;                 //!< Počet prvků odhadu výkonové spektrální hustoty.
+    int m_count;                    //!< Počet filtrů.
+    int m_minBin;                   //!< Index prvního použitého prvku.
+    int m_maxBin;                   //!< Index za posledním použitým prvkem.
+    QVector<int> m_begin;           //!< Index prvního nenulového prvku každého filtru.
+    QVector<int> m_end;             //!< Index za posledním nenulovým prvkem každého filtru.
+    QVector<int> m_offset;          //!< Pozice vah každého filtru ve vektoru m_weights.
+    QVector<float> m_weights;       //!< Nenulové váhy všech filtrů uložené za sebou.
+
+    /*!
+     * \brief append Uloží nenulovou část hustého filtru do řídké reprezentace.
+     * \param filter Váhy filtru pro prvky first až first + filter.size() - 1.
+     * \param first Index prvku první váhy.
+     */
+    void append(const QVector<float> &filter, int first);
+
+    /*!
+     * \brief initLegacy Vytvoří banku podle třídy MelFilterBank.
+     * \param sampleRate Frekvence vzorkování.
+     */
+    void initLegacy(int sampleRate);
+
+    /*!
+     * \brief initAuditory Vytvoří banku trojúhelníkových filtrů nebo filtrů typu gammatone na zvolené stupnici.
+     * \param sampleRate Frekvence vzorkování.
+     * \param lowFrequency Dolní mezní frekvence.
+     * \param highFrequency Horní mezní frekvence.
+     */
+    void initAuditory(int sampleRate, double lowFrequency, double highFrequency);
+
+    /*!
+     * \brief normalize Provede normalizaci vah všech filtrů.
+     * \param normalization Normalizace vah filtrů.
+     */
+    void normalize(Normalization normalization);
+};
+
+#endif
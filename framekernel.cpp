@@ -0,0 +1,426 @@
+#include "framekernel.h"
+
+FrameKernel::FrameKernel(int segmentSize, int sampleRate, int filtersCount, int coefsCount, QObject *parent)
+        : QObject(parent) {
+    m_segmentSize = segmentSize;
+    m_filtersCount = filtersCount;
+    m_coefsCount = (coefsCount <= 0 || coefsCount > filtersCount) ? filtersCount : coefsCount;
+
+    init(sampleRate, FFT::PowerOfTwo);
+}
+
+FrameKernel::FrameKernel(int segmentSize, int sampleRate, int filtersCount, int coefsCount, FFT::SizePolicy policy,
+                         QObject *parent) : QObject(parent) {
+    m_segmentSize = segmentSize;
+    m_filtersCount = filtersCount;
+    m_coefsCount = (coefsCount <= 0 || coefsCount > filtersCount) ? filtersCount : coefsCount;
+
+    init(sampleRate, policy);
+}
+
+void FrameKernel::init(int sampleRate, FFT::SizePolicy policy) {
+    m_fftSize = m_espdSize = 0;
+    m_fftCfg = nullptr;
+    m_mode = Mfcc;
+    m_logFloor = MEL_LOG_FLOOR;
+    m_spectrumMethod = AutoSpectrum;
+    m_lifter = 0;
+    m_energyTerm = LeadingC0;
+    m_energyIndex = UNDEFINED;
+    m_firstBin = m_lastBin = 0;
+    m_window = nullptr;
+    m_detector = nullptr;
+    m_preEmphasis = nullptr;
+    m_descriptors = nullptr;
+    m_cmvn = nullptr;
+    m_hasSilence = false;
+
+    if (m_segmentSize <= 1 || sampleRate <= 0 || m_filtersCount <= 0) {
+        emit error("FrameKernel::FrameKernel: Neplatné parametry výpočtu.");
+        return;
+    }
+
+    // stejný výpočet jako v FFT::FFT, aby byly výsledky obou cest shodné
+    m_fftSize = FFT::fftSizeFor(m_segmentSize, policy);
+    m_espdSize = (m_fftSize / 2) + 1;
+
+    m_fftCfg = kiss_fftr_alloc(m_fftSize, 0, nullptr, nullptr);
+    if (!m_fftCfg) {
+        emit error("FrameKernel::FrameKernel: Nepodařilo se alokovat potřebné zdroje (kissFFT).");
+        return;
+    }
+
+    m_window = WindowTable::get(WindowTable::Hamming, m_segmentSize);
+
+    m_frame.fill(0.0f, m_fftSize);
+    m_spectrum.resize(m_espdSize);
+    m_espd.resize(m_espdSize);
+    m_mels.resize(m_filtersCount);
+    m_output.resize(qMax(m_espdSize, m_filtersCount));
+    m_silence.resize(m_coefsCount);
+
+    m_filterBank = FilterBank(m_espdSize, m_filtersCount, sampleRate);
+    updateBand();
+    initDctTable();
+}
+
+FrameKernel::~FrameKernel() {
+    free(m_fftCfg);
+}
+
+int FrameKernel::segmentSize() const {
+    return m_segmentSize;
+}
+
+int FrameKernel::espdSize() const {
+    return m_espdSize;
+}
+
+int FrameKernel::fftSize() const {
+    return m_fftSize;
+}
+
+int FrameKernel::coefsCount() const {
+    return m_coefsCount;
+}
+
+FrameKernel::OutputMode FrameKernel::outputMode() const {
+    return m_mode;
+}
+
+int FrameKernel::outputSize() const {
+    int descriptors = m_descriptors ? m_descriptors->count() : 0;
+
+    switch (m_mode) {
+    case Magnitude:
+    case Power:
+        return m_espdSize + descriptors;
+    case LogMel:
+        return m_filtersCount + descriptors;
+    default:
+        return m_coefsCount + descriptors;
+    }
+}
+
+bool FrameKernel::setOutputMode(OutputMode mode, float logFloor) {
+    if (mode < Magnitude || mode > Mfcc || !(logFloor > 0.0f)) {
+        emit error("FrameKernel::setOutputMode: Neplatný výstupní režim nebo dolní mez logaritmu.");
+        return false;
+    }
+
+    m_mode = mode;
+    m_logFloor = logFloor;
+    m_silence.resize(outputSize());
+    m_hasSilence = false;
+    updateBand();
+    return true;
+}
+
+void FrameKernel::setVoiceActivityDetector(VoiceActivityDetector *detector) {
+    if (detector && detector->segmentSize() != m_segmentSize) {
+        emit error("FrameKernel::setVoiceActivityDetector: Detektor vyhodnocuje segmenty jiné velikosti.");
+        return;
+    }
+
+    m_detector = detector;
+    m_hasSilence = false;
+}
+
+void FrameKernel::setPreEmphasis(PreEmphasis *filter) {
+    if (filter && filter->segmentSize() != m_segmentSize) {
+        emit error("FrameKernel::setPreEmphasis: Filtr zpracovává segmenty jiné velikosti.");
+        return;
+    }
+
+    m_preEmphasis = filter;
+    m_hasSilence = false;
+}
+
+void FrameKernel::setSpectralDescriptors(SpectralDescriptors *descriptors) {
+    if (descriptors && descriptors->espdSize() != m_espdSize) {
+        emit error("FrameKernel::setSpectralDescriptors: Deskriptory zpracovávají spektrum jiné velikosti.");
+        return;
+    }
+
+    m_descriptors = descriptors;
+    m_output.resize(qMax(m_espdSize, m_filtersCount) + (descriptors ? descriptors->count() : 0));
+    m_silence.resize(outputSize());
+    m_hasSilence = false;
+    updateBand();
+}
+
+void FrameKernel::setCmvn(Cmvn *cmvn) {
+    int descriptors = m_descriptors ? m_descriptors->count() : 0;
+
+    if (cmvn && (cmvn->mode() == Cmvn::Utterance || cmvn->coefsCount() != outputSize() - descriptors)) {
+        emit error("FrameKernel::setCmvn: Normalizace není v režimu Global nebo Sliding nebo neodpovídá výstupu.");
+        return;
+    }
+
+    m_cmvn = cmvn;
+}
+
+bool FrameKernel::setWindow(WindowTable::Type type, float parameter) {
+    const float *window = WindowTable::get(type, m_segmentSize, parameter);
+
+    if (!window) {
+        emit error("FrameKernel::setWindow: Neplatný typ nebo velikost okna.");
+        return false;
+    }
+
+    m_window = window;
+    m_hasSilence = false;
+    return true;
+}
+
+bool FrameKernel::setFilterBank(const FilterBank &filters) {
+    if (!filters.isValid() || filters.espdSize() != m_espdSize || filters.count() != m_filtersCount) {
+        emit error("FrameKernel::setFilterBank: Banka filtrů neodpovídá velikosti spektra nebo počtu filtrů.");
+        return false;
+    }
+
+    m_filterBank = filters;
+    m_hasSilence = false;
+    updateBand();
+    return true;
+}
+
+bool FrameKernel::setLifter(int lifter) {
+    if (lifter < 0) {
+        emit error("FrameKernel::setLifter: Parametr lifteru nesmí být záporný.");
+        return false;
+    }
+
+    m_lifter = lifter;
+    m_hasSilence = false;
+    initDctTable();
+    return true;
+}
+
+void FrameKernel::setEnergyTerm(EnergyTerm term) {
+    m_energyTerm = term;
+    m_hasSilence = false;
+    initDctTable();
+}
+
+FrameKernel::EnergyTerm FrameKernel::energyTerm() const {
+    return m_energyTerm;
+}
+
+void FrameKernel::setSpectrumMethod(SpectrumMethod method) {
+    m_spectrumMethod = method;
+    m_hasSilence = false;
+    updateBand();
+}
+
+bool FrameKernel::usesGoertzel() const {
+    return m_goertzel.isValid();
+}
+
+const FilterBank &FrameKernel::filterBank() const {
+    return m_filterBank;
+}
+
+bool FrameKernel::process(const sample *segment, float *coefs, bool *voiced) {
+    if (!segment || !coefs || !m_fftCfg) {
+        emit error("FrameKernel::process: Neplatný vstupní segment nebo výstupní pole.");
+        return false;
+    }
+
+    bool active = !m_detector || m_detector->isVoiced(segment);
+    if (voiced)
+        *voiced = active;
+
+    if (active)
+        compute(segment, coefs);
+    else {
+        PE_COUNT(SilentFrames, 1);
+
+        /* Tichý segment: koeficienty prvního z nich jsou vypočteny a uloženy, další pouze zkopírovány. */
+        if (!m_hasSilence) {
+            compute(segment, coefs);
+            std::copy(coefs, coefs + m_silence.size(), m_silence.begin());
+            m_hasSilence = true;
+        }
+        else {
+            std::copy(m_silence.constBegin(), m_silence.constEnd(), coefs);
+
+            if (m_preEmphasis)
+                m_preEmphasis->advance(segment);
+        }
+    }
+
+    // výstup režimu je na začátku vektoru, deskriptory za ním se nenormalizují
+    if (m_cmvn) {
+        int descriptors = m_descriptors ? m_descriptors->count() : 0;
+
+        if (m_cmvn->coefsCount() != outputSize() - descriptors || !m_cmvn->normalize(coefs)) {
+            emit error("FrameKernel::process: Normalizace neodpovídá výstupu režimu nebo nemá statistiky.");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool FrameKernel::process(const sample *segment, const TensorView &output, int frame, bool *voiced) {
+    if (output.isNull() || output.features() != outputSize() || frame < 0 || frame >= output.frames()) {
+        emit error("FrameKernel::process: Neplatná výstupní matice nebo index segmentu.");
+        return false;
+    }
+
+    if (output.hasContiguousFrames())
+        return process(segment, output.frame(frame), voiced);
+
+    if (!process(segment, m_output.data(), voiced))
+        return false;
+
+    output.store(frame, m_output.constData());
+    return true;
+}
+
+void FrameKernel::compute(const sample *segment, float *coefs) {
+    PE_STAGE_BEGIN(Windowing);
+    PE_COUNT(ProcessedFrames, 1);
+
+    // energie je počítána z původních vzorků, ještě před preemfází a oknem (HTK RAWENERGY)
+    float energy = (m_mode == Mfcc && m_energyIndex >= 0) ? logEnergy(segment) : 0.0f;
+
+    /* Váhování oknem (a případně preemfáze) spojené s převodem na float. */
+    float *frame = m_frame.data();
+
+    if (m_preEmphasis)
+        m_preEmphasis->apply(m_window, segment, frame);
+    else WindowTable::apply(m_window, segment, frame, m_segmentSize);
+
+    /* FFT a magnitudy (výkonové spektrum bez odmocniny) v pásmu m_firstBin až m_lastBin, spektrální režimy
+     * zapisují celé spektrum přímo do výstupu. */
+    PE_STAGE_NEXT(Fft);
+    float *espd = (m_mode == Magnitude || m_mode == Power) ? coefs : m_espd.data();
+
+    if (m_goertzel.isValid()) {
+        m_goertzel.power(frame, m_segmentSize, espd);
+
+        if (m_mode == Mfcc) {
+            for (int k = m_firstBin; k < m_lastBin; k++)
+                espd[k] = qSqrt(espd[k]);
+        }
+    }
+    else {
+        kiss_fft_cpx *spectrum = m_spectrum.data();
+        kiss_fftr(m_fftCfg, frame, spectrum);
+
+        if (m_mode == Power || m_mode == LogMel) {
+            for (int k = m_firstBin; k < m_lastBin; k++)
+                espd[k] = (spectrum[k].r * spectrum[k].r) + (spectrum[k].i * spectrum[k].i);
+        }
+        else {
+            for (int k = m_firstBin; k < m_lastBin; k++)
+                espd[k] = qSqrt((spectrum[k].r * spectrum[k].r) + (spectrum[k].i * spectrum[k].i));
+        }
+    }
+
+    /* Deskriptory ze stejného spektra za výstupem režimu. */
+    if (m_descriptors)
+        m_descriptors->compute(espd, coefs + outputSize() - m_descriptors->count(), m_mode == Power || m_mode == LogMel);
+
+    if (m_mode == Magnitude || m_mode == Power)
+        return;
+
+    /* Filtrace bankou (pouze nenulové části filtrů) a logaritmus. */
+    PE_STAGE_NEXT(Mel);
+    float *mels = (m_mode == LogMel) ? coefs : m_mels.data();
+
+    m_filterBank.apply(espd, mels);
+
+    for (int m = 0; m < m_filtersCount; m++) {
+        if (m_mode == LogMel)
+            mels[m] = qLn(qMax(mels[m], m_logFloor));
+        else mels[m] = (mels[m] > 0.0f) ? qLn(mels[m]) : mels[m];
+    }
+
+    if (m_mode == LogMel)
+        return;
+
+    /* DCT s předpočítanými kosiny, součiny ve dvojnásobné přesnosti a zaokrouhlení součtu po každém členu jako
+     * v MFCC::dct. */
+    PE_STAGE_NEXT(Dct);
+    const double *dct = m_dctTable.constData();
+
+    for (int c = 0; c < m_coefsCount; c++) {
+        if (c == m_energyIndex) {
+            coefs[c] = energy;
+            continue;
+        }
+
+        const double *row = dct + c * m_filtersCount;
+        float kep = 0.0f;
+
+        for (int m = 0; m < m_filtersCount; m++)
+            kep += mels[m] * row[m];
+
+        coefs[c] = kep * m_dctScale[c];
+    }
+}
+
+void FrameKernel::updateBand() {
+    m_goertzel = Goertzel();
+
+    /* Spektrální režimy a deskriptory potřebují celé spektrum, ostatní jen prvky, které čte banka filtrů. */
+    if (m_mode == Magnitude || m_mode == Power || m_descriptors) {
+        m_firstBin = 0;
+        m_lastBin = m_espdSize;
+        return;
+    }
+
+    m_firstBin = m_filterBank.minBin();
+    m_lastBin = m_filterBank.maxBin();
+
+    bool goertzel = (m_spectrumMethod == GoertzelSpectrum)
+            || (m_spectrumMethod == AutoSpectrum
+                && Goertzel::isCheaper(m_lastBin - m_firstBin, m_segmentSize, m_fftSize));
+
+    if (goertzel)
+        m_goertzel = Goertzel(m_fftSize, m_firstBin, m_lastBin);
+}
+
+void FrameKernel::initDctTable() {
+    m_dctTable.resize(m_coefsCount * m_filtersCount);
+    m_dctScale.resize(m_coefsCount);
+
+    bool trailing = m_energyTerm == TrailingC0 || m_energyTerm == TrailingLogEnergy;
+
+    if (m_energyTerm == LeadingLogEnergy)
+        m_energyIndex = 0;
+    else if (m_energyTerm == TrailingLogEnergy)
+        m_energyIndex = m_coefsCount - 1;
+    else m_energyIndex = UNDEFINED;
+
+    for (int row = 0; row < m_coefsCount; row++) {
+        /* HTK ukládá c1 až c(n-1) a c0 až na konec, a to se stejnou normalizací jako ostatní koeficienty. */
+        int c = trailing ? ((row + 1) % m_coefsCount) : row;
+
+        float normFactor = (c == 0 && !trailing)
+                ? qSqrt(1.0f / m_filtersCount)
+                : qSqrt(2.0f / m_filtersCount);
+
+        float lifter = (m_lifter > 0) ? 1.0f + (m_lifter / 2.0f) * qSin((M_PI * c) / m_lifter) : 1.0f;
+
+        for (int m = 0; m < m_filtersCount; m++) {
+            float incos = (M_PI / (float)m_filtersCount) * (float)c * ((float)m + 0.5f);
+
+            m_dctTable[row * m_filtersCount + m] = qCos(incos);
+        }
+
+        m_dctScale[row] = normFactor * lifter;
+    }
+}
+
+float FrameKernel::logEnergy(const sample *segment) const {
+    qint64 energy = 0;
+
+    for (int i = 0; i < m_segmentSize; i++)
+        energy += static_cast<qint32>(segment[i]) * segment[i];
+
+    return qLn(qMax(static_cast<float>(energy), m_logFloor));
+}
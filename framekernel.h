@@ -0,0 +1,373 @@
+#ifndef FRAMEKERNEL_H
+#define FRAMEKERNEL_H
+
+#include <QObject>
+#include <QVector>
+#include <QtMath>
+
+#include "pe_config.h"
+#include "instrumentation.h"
+#include "windowtable.h"
+#include "fft.h"
+#include "filterbank.h"
+#include "goertzel.h"
+#include "melfilterbank.h"
+#include "voiceactivitydetector.h"
+#include "preemphasis.h"
+#include "spectraldescriptors.h"
+#include "cmvn.h"
+#include "tensorview.h"
+
+#include "kiss_fft/kiss_fftr.h"
+
+/*!
+ * \brief Třída FrameKernel
+ *
+ * Třída představuje sloučenou (fused) variantu výpočtu MFC koeficientů jednoho segmentu akustického signálu.
+ * Provádí tytéž kroky jako řetězec WindowFunction::normalize, FFT::transformEucl a MFCC::calculate, tj. váhování
+ * oknem (výchozí je Hammingovo okno, jiné lze nastavit metodou setWindow), doplnění nulami na velikost transformace
+ * (podle FFT::SizePolicy), FFT, výpočet magnitud, melovskou filtraci, logaritmus a DCT, avšak v jednom
+ * průchodu nad předem alokovanými pracovními buffery. Mezi jednotlivými kroky tak nevznikají žádné nové vektory
+ * a všechna pracovní data se při obvyklých velikostech segmentů vejdou do L1 cache. Banka filtrů (FilterBank, výchozí
+ * je původní melovská banka, jinou lze nastavit metodou setFilterBank) je uložena řídce (pouze nenulové části filtrů)
+ * a kosiny DCT jsou předpočítány do tabulky.
+ * Okno není kopírováno, výpočet čte přímo sdílenou tabulku WindowTable a násobení oknem je spojeno s převodem
+ * vzorků na float.
+ *
+ * V režimech LogMel a Mfcc je spektrum počítáno jen v pásmu, které čte banka filtrů (FilterBank::minBin až maxBin),
+ * u úzkých pásem (např. telefonní pásmo při 44,1 kHz) navíc Goertzelovým algoritmem místo celé FFT, pokud je to
+ * levnější (viz setSpectrumMethod).
+ *
+ * Výstup je určen režimem (setOutputMode): magnitudové spektrum, výkonové spektrum (bez odmocniny), logaritmy
+ * melovských energií (bez DCT) nebo MFC koeficienty (výchozí). Kroky, které zvolený režim nepotřebuje, se vůbec
+ * neprovádějí.
+ *
+ * Kvůli kompatibilitě s HTK a Kaldi lze nastavit sinusový lifter (setLifter), který je vynásoben přímo do tabulky DCT
+ * a nic tedy nestojí, a pořadí koeficientů s energetickým členem (setEnergyTerm): c0 nebo logaritmus energie
+ * segmentu na začátku vektoru (Kaldi) či na jeho konci (HTK _0 a _E).
+ *
+ * Volitelně lze nastavit preemfázi s ditheringem (setPreEmphasis), která je provedena během převodu vzorků
+ * a váhování oknem. Objekt PreEmphasis nese stav proudu, preemfáze je tak spojitá přes překrývající se segmenty.
+ *
+ * Volitelně lze nastavit spektrální deskriptory (setSpectralDescriptors), které jsou počítány ze stejného spektra
+ * a připojeny za výstup zvoleného režimu. Spektrum je pak počítáno celé a vždy pomocí FFT.
+ *
+ * Volitelně lze nastavit normalizaci střední hodnoty a rozptylu (setCmvn) v režimu Global nebo Sliding, která je
+ * provedena v místě nad výstupem režimu každého segmentu (bez deskriptorů), tj. bez dalšího průchodu daty.
+ *
+ * Volitelně lze nastavit detektor řečové aktivity (viz setVoiceActivityDetector), který vyhodnotí každý segment ještě
+ * před váhováním. U segmentů označených jako ticho se FFT, melovská filtrace ani DCT neprovádějí a místo nich je do
+ * výstupu zapsán uložený vektor ticha, tj. koeficienty prvního tichého segmentu od nastavení detektoru.
+ *
+ * Objekt této třídy uchovává stav (pracovní buffery, konfiguraci kissFFT), a proto nesmí být sdílen mezi vlákny.
+ */
+class FrameKernel : public QObject {
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief OutputMode Výstup metody process.
+     */
+    enum OutputMode {
+        Magnitude,  //!< Magnitudy spektra (espdSize() prvků), stejně jako FFT::transformEucl.
+        Power,      //!< Výkonové spektrum, tj. kvadráty magnitud bez odmocniny (espdSize() prvků).
+        LogMel,     //!< Logaritmy melovských energií výkonového spektra s dolní mezí (filtersCount prvků, bez DCT).
+        Mfcc        //!< MFC koeficienty (coefsCount() prvků), stejně jako MFCC::calculate.
+    };
+
+    /*!
+     * \brief SpectrumMethod Způsob výpočtu pásma spektra, které čte banka filtrů (režimy LogMel a Mfcc).
+     */
+    enum SpectrumMethod {
+        AutoSpectrum,       //!< Goertzelův algoritmus, pokud je pro dané pásmo levnější než FFT (výchozí).
+        FftSpectrum,        //!< Vždy FFT, magnitudy jsou počítány jen v pásmu.
+        GoertzelSpectrum    //!< Vždy Goertzelův algoritmus pro prvky pásma.
+    };
+
+    /*!
+     * \brief EnergyTerm Pořadí MFC koeficientů a energetický člen vektoru (režim Mfcc).
+     */
+    enum EnergyTerm {
+        LeadingC0,          //!< c0, c1, ..., c(n-1) (výchozí, stejně jako MFCC::calculate).
+        LeadingLogEnergy,   //!< log E, c1, ..., c(n-1) (Kaldi, use-energy).
+        TrailingC0,         //!< c1, ..., c(n-1), c0 (HTK MFCC_0, c0 se stejnou normalizací jako ostatní koeficienty).
+        TrailingLogEnergy   //!< c1, ..., c(n-1), log E (HTK MFCC_E).
+    };
+
+    /*!
+     * \brief FrameKernel Konstruktor třídy. Předpočítá váhovací okno, řídkou banku melovských filtrů, tabulku DCT
+     *                    a alokuje všechny pracovní buffery.
+     * \param segmentSize Počet vzorků vstupních segmentů.
+     * \param sampleRate Frekvence vzorkování zpracovávaného signálu.
+     * \param filtersCount Počet filtrů banky melovských filtrů.
+     * \param coefsCount Počet počítaných MFC koeficientů. V případě neplatné hodnoty je počítáno všech
+     *                   filtersCount koeficientů (stejně jako v MFCC::calculate).
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolnění).
+     */
+    explicit FrameKernel(int segmentSize, int sampleRate, int filtersCount, int coefsCount, QObject *parent = nullptr);
+
+    /*!
+     * \brief FrameKernel Přetížený konstruktor, velikost transformace je vypočtena podle dané strategie (stejně jako
+     *                    v konstruktoru FFT::FFT se stejnou strategií). Banka melovských filtrů je vytvořena pro
+     *                    odpovídající velikost odhadu výkonové spektrální hustoty.
+     * \param segmentSize Počet vzorků vstupních segmentů.
+     * \param sampleRate Frekvence vzorkování zpracovávaného signálu.
+     * \param filtersCount Počet filtrů banky melovských filtrů.
+     * \param coefsCount Počet počítaných MFC koeficientů (viz výše).
+     * \param policy Strategie výběru velikosti transformace.
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolnění).
+     */
+    explicit FrameKernel(int segmentSize, int sampleRate, int filtersCount, int coefsCount, FFT::SizePolicy policy,
+                         QObject *parent = nullptr);
+
+    /*!
+     * Destruktor třídy.
+     */
+    ~FrameKernel();
+
+    /*!
+     * \brief segmentSize Vrací očekávaný počet vzorků vstupních segmentů.
+     * \return Počet vzorků vstupních segmentů.
+     */
+    int segmentSize() const;
+
+    /*!
+     * \brief espdSize Vrací velikost vnitřně počítaného odhadu výkonové spektrální hustoty.
+     * \return Počet prvků odhadu výkonové spektrální hustoty.
+     */
+    int espdSize() const;
+
+    /*!
+     * \brief fftSize Vrací velikost transformace (počet vzorků segmentu doplněného nulami).
+     * \return Velikost transformace.
+     */
+    int fftSize() const;
+
+    /*!
+     * \brief coefsCount Vrací počet MFC koeficientů, které metoda process zapisuje do výstupního pole.
+     * \return Počet výstupních koeficientů.
+     */
+    int coefsCount() const;
+
+    /*!
+     * \brief outputMode Vrací nastavený výstupní režim.
+     * \return Výstupní režim.
+     */
+    OutputMode outputMode() const;
+
+    /*!
+     * \brief outputSize Vrací počet prvků, které metoda process zapisuje do výstupního pole v nastaveném režimu
+     *                   (včetně případných spektrálních deskriptorů).
+     * \return Počet výstupních prvků.
+     */
+    int outputSize() const;
+
+    /*!
+     * \brief setOutputMode Nastaví výstupní režim (výchozí Mfcc). Nastavení zahodí uložený vektor ticha.
+     * \param mode Výstupní režim.
+     * \param logFloor Dolní mez melovských energií před logaritmem v režimu LogMel (musí být kladná). Režim Mfcc
+     *                 zachovává původní chování (nekladné energie nejsou logaritmovány).
+     * \return True, pokud byl režim nastaven, jinak false (a je emitován signál error).
+     */
+    bool setOutputMode(OutputMode mode, float logFloor = MEL_LOG_FLOOR);
+
+    /*!
+     * \brief setVoiceActivityDetector Nastaví detektor řečové aktivity, podle kterého jsou přeskakovány tiché segmenty.
+     *                                 Objekt nepřebírá vlastnictví detektoru. Nastavení zahodí uložený vektor ticha.
+     *                                 Detektor musí vyhodnocovat segmenty o segmentSize() vzorcích.
+     * \param detector Ukazatel na detektor nebo nullptr, pokud mají být počítány všechny segmenty.
+     */
+    void setVoiceActivityDetector(VoiceActivityDetector *detector);
+
+    /*!
+     * \brief setPreEmphasis Nastaví preemfázi (a dither) prováděnou při převodu vzorků. Objekt nepřebírá vlastnictví
+     *                       filtru, filtr musí pracovat se segmenty o segmentSize() vzorcích a jeho stav je posunut
+     *                       každým zpracovaným segmentem (i tichým). Nastavení zahodí uložený vektor ticha.
+     * \param filter Ukazatel na filtr nebo nullptr pro vypnutí preemfáze (výchozí).
+     */
+    void setPreEmphasis(PreEmphasis *filter);
+
+    /*!
+     * \brief setSpectralDescriptors Nastaví spektrální deskriptory, jejichž count() hodnot je zapisováno za výstup
+     *                              režimu (za MFC koeficienty, melovské energie nebo spektrum). Objekt nepřebírá
+     *                              vlastnictví deskriptorů, ty musí zpracovávat spektrum o espdSize() prvcích a jejich
+     *                              stav (spektrum pro flux) je posunut každým vypočteným segmentem. U tichých segmentů
+     *                              přeskočených detektorem je zkopírován i uložený vektor deskriptorů. Nastavení zahodí
+     *                              uložený vektor ticha.
+     * \param descriptors Ukazatel na deskriptory nebo nullptr pro jejich vypnutí (výchozí).
+     */
+    void setSpectralDescriptors(SpectralDescriptors *descriptors);
+
+    /*!
+     * \brief setCmvn Nastaví normalizaci střední hodnoty a rozptylu výstupu režimu (MFC koeficientů, melovských
+     *                energií nebo spektra, bez deskriptorů). Objekt nepřebírá vlastnictví, normalizace musí být
+     *                v režimu Global nebo Sliding a mít tolik koeficientů, kolik zapisuje výstupní režim. Stav
+     *                klouzavého okna je posunut každým segmentem (i tichým, uložený vektor ticha je ukládán před
+     *                normalizací).
+     * \param cmvn Ukazatel na normalizaci nebo nullptr pro její vypnutí (výchozí).
+     */
+    void setCmvn(Cmvn *cmvn);
+
+    /*!
+     * \brief setWindow Nastaví váhovací okno (výchozí je WindowTable::Hamming). Nastavení zahodí uložený vektor ticha.
+     * \param type Typ okna.
+     * \param parameter Parametr okna (viz WindowTable::Type), WINDOW_DEFAULT_PARAMETER pro výchozí hodnotu.
+     * \return True, pokud bylo okno nastaveno, jinak false (a je emitován signál error).
+     */
+    bool setWindow(WindowTable::Type type, float parameter = WINDOW_DEFAULT_PARAMETER);
+
+    /*!
+     * \brief setFilterBank Nastaví banku filtrů (výchozí je FilterBank::LegacyMel, tj. banka MelFilterBank). Banka
+     *                      musí být vytvořena pro espdSize() prvků a filtersCount filtrů z konstruktoru. Nastavení
+     *                      zahodí uložený vektor ticha.
+     * \param filters Banka filtrů.
+     * \return True, pokud byla banka nastavena, jinak false (a je emitován signál error).
+     */
+    bool setFilterBank(const FilterBank &filters);
+
+    /*!
+     * \brief setLifter Nastaví sinusový lifter 1 + (L / 2) * sin(pi * n / L) koeficientu cn (HTK CEPLIFTER, Kaldi
+     *                  cepstral-lifter, obvykle 22). Lifter je vynásoben do tabulky DCT, energetický člen neovlivňuje.
+     *                  Nastavení zahodí uložený vektor ticha.
+     * \param lifter Parametr L lifteru (0 lifter vypíná, výchozí).
+     * \return True, pokud byl lifter nastaven, jinak false (a je emitován signál error).
+     */
+    bool setLifter(int lifter);
+
+    /*!
+     * \brief setEnergyTerm Nastaví pořadí koeficientů a energetický člen výstupního vektoru v režimu Mfcc (výchozí
+     *                      LeadingC0). Logaritmus energie je počítán ze vzorků segmentu před preemfází, ditherem
+     *                      a váhováním (HTK RAWENERGY) s dolní mezí jako v režimu LogMel. Počet výstupních prvků se
+     *                      nemění. Nastavení zahodí uložený vektor ticha.
+     * \param term Pořadí koeficientů a energetický člen.
+     */
+    void setEnergyTerm(EnergyTerm term);
+
+    /*!
+     * \brief energyTerm Vrací nastavené pořadí koeficientů a energetický člen.
+     * \return Pořadí koeficientů a energetický člen.
+     */
+    EnergyTerm energyTerm() const;
+
+    /*!
+     * \brief setSpectrumMethod Nastaví způsob výpočtu pásma spektra (výchozí AutoSpectrum). Výsledky Goertzelova
+     *                          algoritmu se od FFT liší jen zaokrouhlením. Nastavení zahodí uložený vektor ticha.
+     * \param method Způsob výpočtu spektra.
+     */
+    void setSpectrumMethod(SpectrumMethod method);
+
+    /*!
+     * \brief usesGoertzel Zjistí, zda je při nastaveném režimu, bance filtrů a způsobu výpočtu použit Goertzelův
+     *                     algoritmus.
+     * \return True, pokud je spektrum počítáno Goertzelovým algoritmem, jinak false.
+     */
+    bool usesGoertzel() const;
+
+    /*!
+     * \brief filterBank Vrací nastavenou banku filtrů.
+     * \return Banka filtrů.
+     */
+    const FilterBank &filterBank() const;
+
+    /*!
+     * \brief process Metoda provede celý výpočet výstupu (podle výstupního režimu, výchozí jsou MFC koeficienty)
+     *                daného segmentu. Segment musí obsahovat právě segmentSize() vzorků a výstupní pole musí mít
+     *                místo alespoň pro outputSize() prvků. Metoda nealokuje žádnou paměť.
+     * \param segment Ukazatel na vzorky vstupního segmentu.
+     * \param coefs Ukazatel na pole, do kterého bude zapsán výstup (MFC koeficienty, spektrum nebo melovské energie).
+     * \param voiced Volitelný ukazatel, kam bude zapsáno, zda segment obsahuje řeč (bez detektoru vždy true).
+     * \return True, pokud výpočet proběhl, jinak false (a je emitován signál error).
+     */
+    bool process(const sample *segment, float *coefs, bool *voiced = nullptr);
+
+    /*!
+     * \brief process Přetížená metoda, která výstup zapíše do segmentu frame matice volajícího. Při souvislých
+     *                vektorech segmentů (TensorView::hasContiguousFrames) je výstup zapsán přímo, jinak přes pracovní
+     *                buffer podle kroků matice. Metoda nealokuje žádnou paměť.
+     * \param segment Ukazatel na vzorky vstupního segmentu.
+     * \param output Výstupní matice s outputSize() prvky na segment.
+     * \param frame Index segmentu v matici.
+     * \param voiced Volitelný ukazatel, kam bude zapsáno, zda segment obsahuje řeč (bez detektoru vždy true).
+     * \return True, pokud výpočet proběhl, jinak false (a je emitován signál error).
+     */
+    bool process(const sample *segment, const TensorView &output, int frame, bool *voiced = nullptr);
+
+private:
+    int m_segmentSize;                  //!< Počet vzorků vstupních segmentů.
+    int m_fftSize;                      //!< Počet vzorků vstupu FFT (viz FFT::fftSizeFor).
+    int m_espdSize;                     //!< Počet prvků odhadu výkonové spektrální hustoty.
+    int m_filtersCount;                 //!< Počet filtrů banky melovských filtrů.
+    int m_coefsCount;                   //!< Počet výstupních MFC koeficientů.
+    kiss_fftr_cfg m_fftCfg;             //!< Struktura knihovny kissFFT potřebná pro výpočet FFT.
+    OutputMode m_mode;                  //!< Výstupní režim.
+    float m_logFloor;                   //!< Dolní mez melovských energií v režimu LogMel.
+
+    const float *m_window;              //!< Vzorky váhovacího okna (sdílená tabulka WindowTable).
+    QVector<float> m_frame;             //!< Pracovní buffer vstupu FFT (konec za m_segmentSize zůstává nulový).
+    QVector<kiss_fft_cpx> m_spectrum;   //!< Pracovní buffer komplexních váhových koeficientů.
+    QVector<float> m_espd;              //!< Pracovní buffer odhadu výkonové spektrální hustoty.
+    QVector<float> m_mels;              //!< Pracovní buffer melovských koeficientů.
+    QVector<float> m_output;            //!< Pracovní buffer výstupu pro matice s nesouvislými vektory segmentů.
+
+    FilterBank m_filterBank;            //!< Řídká banka filtrů.
+    SpectrumMethod m_spectrumMethod;    //!< Způsob výpočtu pásma spektra.
+    int m_firstBin;                     //!< Index prvního počítaného prvku spektra.
+    int m_lastBin;                      //!< Index za posledním počítaným prvkem spektra.
+    Goertzel m_goertzel;                //!< Goertzelův algoritmus pro pásmo, pokud je použit, jinak neplatný objekt.
+    QVector<double> m_dctTable;         //!< Tabulka kosinů DCT (m_coefsCount x m_filtersCount) v pořadí výstupu.
+    QVector<float> m_dctScale;          //!< Normalizační faktor a lifter řádků m_dctTable (násobí se až součet).
+    int m_lifter;                       //!< Parametr sinusového lifteru (0 = vypnutý).
+    EnergyTerm m_energyTerm;            //!< Pořadí koeficientů a energetický člen.
+    int m_energyIndex;                  //!< Pozice logaritmu energie ve výstupu nebo UNDEFINED.
+
+    VoiceActivityDetector *m_detector;  //!< Detektor řečové aktivity (nevlastněný) nebo nullptr.
+    PreEmphasis *m_preEmphasis;         //!< Preemfáze (nevlastněná) nebo nullptr.
+    SpectralDescriptors *m_descriptors; //!< Spektrální deskriptory (nevlastněné) nebo nullptr.
+    Cmvn *m_cmvn;                       //!< Normalizace střední hodnoty a rozptylu (nevlastněná) nebo nullptr.
+    QVector<float> m_silence;           //!< Uložený vektor ticha.
+    bool m_hasSilence;                  //!< True, pokud byl vektor ticha již vypočten.
+
+    /*!
+     * \brief init Metoda vypočítá velikost transformace a předpočítá okno, banku filtrů, tabulku DCT a buffery.
+     * \param sampleRate Frekvence vzorkování zpracovávaného signálu.
+     * \param policy Strategie výběru velikosti transformace.
+     */
+    void init(int sampleRate, FFT::SizePolicy policy);
+
+    /*!
+     * \brief compute Metoda provede váhování, FFT a podle výstupního režimu i melovskou filtraci a DCT jednoho segmentu.
+     * \param segment Ukazatel na vzorky vstupního segmentu.
+     * \param coefs Ukazatel na pole, do kterého bude zapsán výstup.
+     */
+    void compute(const sample *segment, float *coefs);
+
+    /*!
+     * \brief updateBand Metoda určí pásmo počítaných prvků spektra a způsob jeho výpočtu podle výstupního režimu,
+     *                   banky filtrů, nastaveného způsobu výpočtu a deskriptorů.
+     */
+    void updateBand();
+
+    /*!
+     * \brief initDctTable Metoda předpočítá tabulku kosinů DCT a normalizační faktory vynásobené lifterem
+     *                     v pořadí výstupních koeficientů (viz EnergyTerm). Kosiny jsou uloženy ve dvojnásobné
+     *                     přesnosti a faktor násobí až součet řádku, stejně jako v MFCC::calculate, takže výsledky
+     *                     bez lifteru jsou shodné.
+     */
+    void initDctTable();
+
+    /*!
+     * \brief logEnergy Metoda vypočítá logaritmus energie (součtu kvadrátů) vzorků segmentu.
+     * \param segment Ukazatel na vzorky segmentu.
+     * \return Logaritmus energie s dolní mezí m_logFloor.
+     */
+    float logEnergy(const sample *segment) const;
+
+signals:
+    /*!
+     * \brief error Signál, který je emitován při chybě.
+     * \param message Popis chyby.
+     */
+    void error(QString message);
+};
+
+#endif
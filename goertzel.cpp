@@ -0,0 +1,108 @@
+#include "goertzel.h"
+
+#include <QtMath>
+
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+Goertzel::Goertzel() {
+    m_firstBin = m_lastBin = 0;
+}
+
+Goertzel::Goertzel(int fftSize, int firstBin, int lastBin) {
+    m_firstBin = m_lastBin = 0;
+
+    if (fftSize <= 0 || firstBin < 0 || lastBin <= firstBin || lastBin > (fftSize / 2) + 1)
+        return;
+
+    m_firstBin = firstBin;
+    m_lastBin = lastBin;
+
+    // doplnění na násobek bloku, poslední neúplný blok počítá kopie posledního prvku
+    int count = lastBin - firstBin;
+    m_coefficients.resize(((count + GOERTZEL_BLOCK - 1) / GOERTZEL_BLOCK) * GOERTZEL_BLOCK);
+
+    for (int i = 0; i < m_coefficients.size(); i++)
+        m_coefficients[i] = 2.0 * qCos((2.0 * M_PI * qMin(firstBin + i, lastBin - 1)) / fftSize);
+}
+
+bool Goertzel::isValid() const {
+    return m_lastBin > m_firstBin;
+}
+
+int Goertzel::firstBin() const {
+    return m_firstBin;
+}
+
+int Goertzel::lastBin() const {
+    return m_lastBin;
+}
+
+void Goertzel::power(const float *frame, int frameSize, float *output) const {
+    const double *coefficients = m_coefficients.constData();
+    float block[GOERTZEL_BLOCK];
+
+    /* Bloky GOERTZEL_BLOCK nezávislých rekurencí, jejichž latence se překrývá. Výraz (x - s[n - 2]) + c * s[n - 1]
+     * zkracuje závislost mezi iteracemi na násobení a sčítání. */
+    for (int first = 0; first < m_coefficients.size(); first += GOERTZEL_BLOCK) {
+        const double *c = coefficients + first;
+
+#ifdef __SSE2__
+        __m128d cv[GOERTZEL_BLOCK / 2], a[GOERTZEL_BLOCK / 2], b[GOERTZEL_BLOCK / 2];
+
+        for (int j = 0; j < GOERTZEL_BLOCK / 2; j++) {
+            cv[j] = _mm_loadu_pd(c + 2 * j);
+            a[j] = b[j] = _mm_setzero_pd();
+        }
+
+        for (int n = 0; n < frameSize; n++) {
+            const __m128d x = _mm_set1_pd(frame[n]);
+
+            for (int j = 0; j < GOERTZEL_BLOCK / 2; j++) {
+                __m128d s = _mm_add_pd(_mm_sub_pd(x, b[j]), _mm_mul_pd(cv[j], a[j]));
+                b[j] = a[j];
+                a[j] = s;
+            }
+        }
+
+        for (int j = 0; j < GOERTZEL_BLOCK / 2; j++) {
+            __m128d p = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(a[j], a[j]), _mm_mul_pd(b[j], b[j])),
+                                   _mm_mul_pd(cv[j], _mm_mul_pd(a[j], b[j])));
+            double values[2];
+            _mm_storeu_pd(values, p);
+
+            block[2 * j] = static_cast<float>(values[0]);
+            block[2 * j + 1] = static_cast<float>(values[1]);
+        }
+#else
+        double a[GOERTZEL_BLOCK] = {}, b[GOERTZEL_BLOCK] = {};
+
+        for (int n = 0; n < frameSize; n++) {
+            const double x = frame[n];
+
+            for (int j = 0; j < GOERTZEL_BLOCK; j++) {
+                double s = (x - b[j]) + c[j] * a[j];
+                b[j] = a[j];
+                a[j] = s;
+            }
+        }
+
+        for (int j = 0; j < GOERTZEL_BLOCK; j++)
+            block[j] = static_cast<float>(a[j] * a[j] + b[j] * b[j] - c[j] * a[j] * b[j]);
+#endif
+
+        int count = qMin(GOERTZEL_BLOCK, m_lastBin - m_firstBin - first);
+        std::copy(block, block + count, output + m_firstBin + first);
+    }
+}
+
+bool Goertzel::isCheaper(int binsCount, int frameSize, int fftSize) {
+    // FFT ~ fftSize * log2(fftSize) operací, Goertzel frameSize operací na prvek (po celých blocích)
+    double fftCost = GOERTZEL_FFT_COST * fftSize * std::log2(static_cast<double>(fftSize));
+    int blocks = (binsCount + GOERTZEL_BLOCK - 1) / GOERTZEL_BLOCK;
+
+    return binsCount > 0 && static_cast<double>(blocks) * GOERTZEL_BLOCK * frameSize < fftCost;
+}
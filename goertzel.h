@@ -0,0 +1,87 @@
+#ifndef GOERTZEL_H
+#define GOERTZEL_H
+
+#include <QVector>
+
+#include "pe_config.h"
+
+/*!
+ * Poměr ceny FFT k ceně jednoho prvku Goertzelova algoritmu, podle kterého se rozhoduje, zda je přímý výpočet
+ * úzkého pásma levnější než celá transformace (viz Goertzel::isCheaper, kalibrováno měřením bmSpectrumBand).
+ */
+#define GOERTZEL_FFT_COST 1.5f
+
+/*!
+ * Počet prvků počítaných najednou (nezávislé rekurence v jednom průchodu vzorky, sudý kvůli SSE2).
+ */
+#define GOERTZEL_BLOCK 8
+
+/*!
+ * \brief Třída Goertzel
+ *
+ * Třída počítá výkonové spektrum (kvadráty magnitud) souvislého rozsahu prvků DFT Goertzelovým algoritmem, tedy
+ * bez výpočtu celé transformace. Výsledky odpovídají prvkům <firstBin, lastBin) transformace velikosti fftSize
+ * segmentu doplněného nulami, nulové vzorky za koncem segmentu se však vůbec nezpracovávají. Cena výpočtu roste
+ * s počtem prvků (frameSize násobení na prvek), algoritmus se proto vyplatí jen pro úzká pásma (viz isCheaper).
+ * Rekurence je počítána v dvojnásobné přesnosti a po blocích GOERTZEL_BLOCK prvků najednou.
+ *
+ * Objekt je hodnotový a po vytvoření se nemění, může být proto sdílen mezi vlákny.
+ */
+class Goertzel {
+
+public:
+    /*!
+     * \brief Goertzel Konstruktor prázdného (neplatného) objektu.
+     */
+    Goertzel();
+
+    /*!
+     * \brief Goertzel Konstruktor, který předpočítá koeficienty rekurence daných prvků.
+     * \param fftSize Velikost transformace, jejíž prvky jsou počítány.
+     * \param firstBin Index prvního počítaného prvku.
+     * \param lastBin Index za posledním počítaným prvkem (nejvýše fftSize / 2 + 1).
+     */
+    Goertzel(int fftSize, int firstBin, int lastBin);
+
+    /*!
+     * \brief isValid Zjistí, zda byl objekt vytvořen s platnými parametry.
+     * \return True, pokud je objekt platný, jinak false.
+     */
+    bool isValid() const;
+
+    /*!
+     * \brief firstBin Vrací index prvního počítaného prvku.
+     * \return Index prvního prvku.
+     */
+    int firstBin() const;
+
+    /*!
+     * \brief lastBin Vrací index za posledním počítaným prvkem.
+     * \return Index za posledním prvkem.
+     */
+    int lastBin() const;
+
+    /*!
+     * \brief power Vypočítá výkonové spektrum prvků firstBin() až lastBin() - 1 daného segmentu.
+     * \param frame Ukazatel na vzorky segmentu (váhované oknem).
+     * \param frameSize Počet vzorků segmentu (nejvýše fftSize).
+     * \param output Ukazatel na pole indexované čísly prvků, zapsány jsou prvky firstBin() až lastBin() - 1.
+     */
+    void power(const float *frame, int frameSize, float *output) const;
+
+    /*!
+     * \brief isCheaper Odhadne, zda je výpočet daného počtu prvků Goertzelovým algoritmem levnější než FFT.
+     * \param binsCount Počet počítaných prvků.
+     * \param frameSize Počet vzorků segmentu.
+     * \param fftSize Velikost transformace.
+     * \return True, pokud je Goertzelův algoritmus levnější, jinak false.
+     */
+    static bool isCheaper(int binsCount, int frameSize, int fftSize);
+
+private:
+    int m_firstBin;                 //!< Index prvního počítaného prvku.
+    int m_lastBin;                  //!< Index za posledním počítaným prvkem.
+    QVector<double> m_coefficients; //!< Koeficienty rekurence 2 * cos(2 * pi * k / fftSize) doplněné na násobek bloku.
+};
+
+#endif
@@ -10,6 +10,7 @@ void HammingWindow::initWindow() {
         return;
     }
 
-    for (int n = 0; n < m_window.size(); n++)
-        m_window[n] = ALPHA - BETA * qCos((2 * M_PI * n) / (m_window.size() - 1));
+    // tabulka je spočtena jen jednou pro celý proces (viz WindowTable)
+    const float *table = WindowTable::get(WindowTable::Hamming, m_window.size());
+    std::copy(table, table + m_window.size(), m_window.begin());
 }
@@ -35,8 +35,8 @@ public:
 
 private:
     /*!
-     * \brief initWindow Konkrétní implementace virtuální metody initWindow. Pomocí
-     *                   koeficientů ALPHA a BETA počítá průběh Hammingovy funkce.
+     * \brief initWindow Konkrétní implementace virtuální metody initWindow. Zkopíruje průběh Hammingovy funkce
+     *                   (koeficienty ALPHA a BETA) ze sdílené tabulky WindowTable.
      */
     void initWindow();
 };
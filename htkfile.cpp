@@ -0,0 +1,242 @@
+#include "htkfile.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+namespace {
+
+const int BLOCK_VALUES = 4096;  // počet koeficientů převáděných najednou
+
+/* Převod bloku 32bitových slov mezi pořadím bytů platformy a velkým endianem (v obou směrech stejný). */
+inline void swapBlock(quint32 *words, int count) {
+    for (int i = 0; i < count; i++)
+        words[i] = qToBigEndian<quint32>(words[i]);
+}
+
+}
+
+HtkFile::HtkFile(const QString &fileName, QObject *parent) : QObject(parent) {
+    setHtkFile(fileName);
+}
+
+void HtkFile::setHtkFile(const QString &fileName) {
+    m_fileName = fileName;
+    m_vectorsCount = m_vectorSize = UNDEFINED;
+    m_samplePeriod = UNDEFINED;
+    m_parameterKind = UNDEFINED;
+}
+
+bool HtkFile::readHeader() {
+    QFile file(m_fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        emit error("HtkFile::readHeader: Soubor " + m_fileName + " nelze otevřít.");
+        return false;
+    }
+
+    uchar header[HTK_HEADER_SIZE];
+    if (file.read(reinterpret_cast<char *>(header), HTK_HEADER_SIZE) != HTK_HEADER_SIZE) {
+        emit error("HtkFile::readHeader: Soubor " + m_fileName + " nemá úplnou hlavičku.");
+        return false;
+    }
+
+    qint32 vectors = qFromBigEndian<qint32>(header);
+    qint32 period = qFromBigEndian<qint32>(header + 4);
+    int bytes = qFromBigEndian<qint16>(header + 8);
+    int kind = qFromBigEndian<quint16>(header + 10);
+
+    if ((kind & Compressed) || (kind & 0x3F) == Waveform) {
+        emit error("HtkFile::readHeader: Komprimované soubory a průběhy signálu nejsou podporovány (" + kindName(kind) + ").");
+        return false;
+    }
+
+    qint64 dataSize = static_cast<qint64>(vectors) * bytes;
+    qint64 expected = HTK_HEADER_SIZE + dataSize;
+
+    // kontrolní součet _K jsou 2 byty za daty
+    if (vectors < 0 || bytes <= 0 || bytes % static_cast<int>(sizeof(float)) != 0
+            || (file.size() != expected && !((kind & Checksum) && file.size() == expected + 2))) {
+        emit error("HtkFile::readHeader: Velikost souboru " + m_fileName + " neodpovídá hlavičce.");
+        return false;
+    }
+
+    m_vectorsCount = vectors;
+    m_vectorSize = bytes / static_cast<int>(sizeof(float));
+    m_samplePeriod = period;
+    m_parameterKind = kind;
+    return true;
+}
+
+int HtkFile::vectorsCount() const {
+    return m_vectorsCount;
+}
+
+int HtkFile::vectorSize() const {
+    return m_vectorSize;
+}
+
+qint32 HtkFile::samplePeriod() const {
+    return m_samplePeriod;
+}
+
+int HtkFile::parameterKind() const {
+    return m_parameterKind;
+}
+
+bool HtkFile::write(const float *features, int vectors, int vectorSize, qint32 samplePeriod, int parameterKind) {
+    return write(TensorView::frameMajor(const_cast<float *>(features), vectors, vectorSize), samplePeriod, parameterKind);
+}
+
+bool HtkFile::write(const TensorView &features, qint32 samplePeriod, int parameterKind) {
+    const int vectorBytes = features.features() * static_cast<int>(sizeof(float));
+
+    if (features.isNull() || vectorBytes > 0x7FFF || samplePeriod <= 0 || parameterKind < 0 || parameterKind > 0xFFFF
+            || (parameterKind & (Compressed | Checksum))) {
+        emit error("HtkFile::write: Neplatná matice koeficientů, perioda nebo druh parametrů.");
+        return false;
+    }
+
+    PE_STAGE_BEGIN(FileWrite);
+
+    QFile file(m_fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        emit error("HtkFile::write: Do souboru " + m_fileName + " nelze zapisovat.");
+        return false;
+    }
+
+    uchar header[HTK_HEADER_SIZE];
+    qToBigEndian<qint32>(features.frames(), header);
+    qToBigEndian<qint32>(samplePeriod, header + 4);
+    qToBigEndian<qint16>(static_cast<qint16>(vectorBytes), header + 8);
+    qToBigEndian<quint16>(static_cast<quint16>(parameterKind), header + 10);
+
+    bool ok = file.write(reinterpret_cast<const char *>(header), HTK_HEADER_SIZE) == HTK_HEADER_SIZE;
+
+    /* Vektory jsou převáděny po blocích přes pracovní buffer a zapsány jednou operací na blok. */
+    const int size = features.features();
+    const int blockVectors = qMax(1, BLOCK_VALUES / size);
+    QVector<quint32> block(blockVectors * size);
+
+    for (int begin = 0; ok && begin < features.frames(); begin += blockVectors) {
+        int count = qMin(blockVectors, features.frames() - begin);
+
+        for (int i = 0; i < count; i++) {
+            const float *vector = features.frame(begin + i);
+            quint32 *words = block.data() + i * size;
+
+            if (features.hasContiguousFrames())
+                memcpy(words, vector, size * sizeof(float));
+            else {
+                for (int f = 0; f < size; f++)
+                    memcpy(words + f, vector + f * features.featureStride(), sizeof(float));
+            }
+        }
+
+        swapBlock(block.data(), count * size);
+
+        qint64 bytes = static_cast<qint64>(count) * vectorBytes;
+        ok = file.write(reinterpret_cast<const char *>(block.constData()), bytes) == bytes;
+    }
+
+    if (!ok) {
+        emit error("HtkFile::write: Zápis do souboru " + m_fileName + " selhal.");
+        return false;
+    }
+
+    m_vectorsCount = features.frames();
+    m_vectorSize = size;
+    m_samplePeriod = samplePeriod;
+    m_parameterKind = parameterKind;
+    return true;
+}
+
+QVector<float> HtkFile::readAll() {
+    if (!readHeader())
+        return QVector<float>();
+
+    QVector<float> features(m_vectorsCount * m_vectorSize);
+    if (features.isEmpty())
+        return features;
+
+    if (read(TensorView::frameMajor(features.data(), m_vectorsCount, m_vectorSize)) == UNDEFINED)
+        return QVector<float>();
+
+    return features;
+}
+
+int HtkFile::read(const TensorView &output) {
+    if (!readHeader())
+        return UNDEFINED;
+
+    if (output.isNull() || output.features() != m_vectorSize || output.frames() < m_vectorsCount) {
+        emit error("HtkFile::read: Výstupní matice neodpovídá velikosti vektorů nebo jejich počtu.");
+        return UNDEFINED;
+    }
+
+    PE_STAGE_BEGIN(FileRead);
+
+    QFile file(m_fileName);
+    if (!file.open(QFile::ReadOnly) || !file.seek(HTK_HEADER_SIZE) || !readData(&file, output)) {
+        emit error("HtkFile::read: Ze souboru " + m_fileName + " nelze číst.");
+        return UNDEFINED;
+    }
+
+    output.fill(m_vectorsCount, output.frames());
+    return m_vectorsCount;
+}
+
+qint32 HtkFile::samplePeriodFor(int hop, int sampleRate) {
+    if (hop <= 0 || sampleRate <= 0)
+        return UNDEFINED;
+
+    return static_cast<qint32>(qRound64((hop * 10000000.0) / sampleRate));
+}
+
+QString HtkFile::kindName(int parameterKind) {
+    static const char *const names[] = {"WAVEFORM", "LPC", "LPREFC", "LPCEPSTRA", "LPDELCEP", "IREFC", "MFCC",
+                                        "FBANK", "MELSPEC", "USER", "DISCRETE", "PLP"};
+    static const struct { int flag; const char *suffix; } qualifiers[] = {
+        {Energy, "_E"}, {NoAbsoluteEnergy, "_N"}, {Delta, "_D"}, {Acceleration, "_A"}, {Compressed, "_C"},
+        {ZeroMean, "_Z"}, {Checksum, "_K"}, {ZerothCepstral, "_0"}, {ThirdDifferential, "_T"}};
+
+    int base = parameterKind & 0x3F;
+    QString name = (base <= Plp) ? QString(names[base]) : QString("ANON");
+
+    for (const auto &qualifier : qualifiers) {
+        if (parameterKind & qualifier.flag)
+            name += qualifier.suffix;
+    }
+
+    return name;
+}
+
+bool HtkFile::readData(QFile *file, const TensorView &output) {
+    const int size = m_vectorSize;
+    const int blockVectors = qMax(1, BLOCK_VALUES / size);
+    const bool direct = output.hasContiguousFrames() && output.frameStride() == size;
+    QVector<quint32> block(blockVectors * size);
+    QVector<float> values(direct ? 0 : blockVectors * size);
+
+    for (int begin = 0; begin < m_vectorsCount; begin += blockVectors) {
+        int count = qMin(blockVectors, m_vectorsCount - begin);
+        qint64 bytes = static_cast<qint64>(count) * size * static_cast<qint64>(sizeof(float));
+
+        if (file->read(reinterpret_cast<char *>(block.data()), bytes) != bytes)
+            return false;
+
+        swapBlock(block.data(), count * size);
+
+        /* Souvislá matice je zkopírována najednou, jinak přes pracovní buffer podle kroků matice. */
+        if (direct) {
+            memcpy(output.frame(begin), block.constData(), bytes);
+            continue;
+        }
+
+        memcpy(values.data(), block.constData(), bytes);
+
+        for (int i = 0; i < count; i++)
+            output.store(begin + i, values.constData() + i * size);
+    }
+
+    return true;
+}
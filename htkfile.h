@@ -0,0 +1,184 @@
+#ifndef HTKFILE_H
+#define HTKFILE_H
+
+#include <QObject>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+#include "pe_config.h"
+#include "instrumentation.h"
+#include "tensorview.h"
+
+/*!
+ * Velikost hlavičky souboru parametrů HTK v bytech.
+ */
+#define HTK_HEADER_SIZE 12
+
+/*!
+ * \brief Třída HtkFile
+ *
+ * Třída představuje soubor parametrů ve formátu HTK (HParm), který přímo čtou nástroje HTK i Kaldi (copy-feats
+ * --htk-in). Soubor začíná 12bytovou hlavičkou s velkým endianem: počet vektorů (int32), perioda vektorů
+ * v jednotkách 100 ns (int32), velikost vektoru v bytech (int16) a druh parametrů (int16, základní druh a příznaky
+ * kvalifikátorů). Následují vektory koeficientů typu float, rovněž s velkým endianem.
+ *
+ * Na rozdíl od MfccFile není počet koeficientů vektoru pevný. Zápis i čtení převádějí pořadí bytů po blocích
+ * a soubor čtou, resp. zapisují několika velkými operacemi, zápis je proto srovnatelně rychlý jako u MfccFile.
+ * Komprimované soubory (_C) a průběhové (waveform) soubory nejsou podporovány, kontrolní součet (_K) je při čtení
+ * přeskočen a při zápisu se nevytváří.
+ */
+class HtkFile : public QObject {
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief ParameterKind Základní druh parametrů (dolních 6 bitů položky parmKind).
+     */
+    enum ParameterKind {
+        Waveform = 0,       //!< WAVEFORM, vzorky signálu (nepodporováno).
+        Lpc = 1,            //!< LPC, koeficienty lineární predikce.
+        LpReflection = 2,   //!< LPREFC, reflexní koeficienty.
+        LpCepstra = 3,      //!< LPCEPSTRA, kepstrální koeficienty LPC.
+        LpDeltaCepstra = 4, //!< LPDELCEP, kepstrální koeficienty LPC s delta koeficienty.
+        IReflection = 5,    //!< IREFC, celočíselné reflexní koeficienty.
+        Mfcc = 6,           //!< MFCC, melovské kepstrální koeficienty.
+        Fbank = 7,          //!< FBANK, logaritmy energií banky filtrů.
+        MelSpectrum = 8,    //!< MELSPEC, lineární energie banky filtrů.
+        User = 9,           //!< USER, uživatelské parametry.
+        Discrete = 10,      //!< DISCRETE, vektorově kvantované parametry.
+        Plp = 11            //!< PLP, kepstrální koeficienty PLP.
+    };
+
+    /*!
+     * \brief Qualifier Příznaky kvalifikátorů druhu parametrů.
+     */
+    enum Qualifier {
+        Energy = 0x40,              //!< _E, logaritmus energie.
+        NoAbsoluteEnergy = 0x80,    //!< _N, absolutní energie odstraněna.
+        Delta = 0x100,              //!< _D, delta koeficienty.
+        Acceleration = 0x200,       //!< _A, koeficienty zrychlení.
+        Compressed = 0x400,         //!< _C, komprimovaný soubor (nepodporováno).
+        ZeroMean = 0x800,           //!< _Z, odečtena střední hodnota kepstra.
+        Checksum = 0x1000,          //!< _K, kontrolní součet CRC.
+        ZerothCepstral = 0x2000,    //!< _0, koeficient c0.
+        ThirdDifferential = 0x8000  //!< _T, delta koeficienty třetího řádu.
+    };
+
+    /*!
+     * \brief HtkFile Konstruktor třídy.
+     * \param fileName Cesta k souboru parametrů HTK.
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolnění).
+     */
+    explicit HtkFile(const QString &fileName, QObject *parent = nullptr);
+
+    /*!
+     * \brief setHtkFile Metoda nastaví objektu cestu k souboru a zahodí přečtenou hlavičku.
+     * \param fileName Cesta k souboru parametrů HTK.
+     */
+    void setHtkFile(const QString &fileName);
+
+    /*!
+     * \brief readHeader Metoda přečte a zkontroluje hlavičku souboru (velikost souboru musí odpovídat hlavičce).
+     * \return True, pokud je hlavička platná a soubor lze číst, jinak false (a je emitován signál error).
+     */
+    bool readHeader();
+
+    /*!
+     * \brief vectorsCount Vrací počet vektorů podle přečtené nebo zapsané hlavičky.
+     * \return Počet vektorů nebo UNDEFINED, pokud hlavička nebyla přečtena.
+     */
+    int vectorsCount() const;
+
+    /*!
+     * \brief vectorSize Vrací počet koeficientů jednoho vektoru podle přečtené nebo zapsané hlavičky.
+     * \return Počet koeficientů nebo UNDEFINED, pokud hlavička nebyla přečtena.
+     */
+    int vectorSize() const;
+
+    /*!
+     * \brief samplePeriod Vrací periodu vektorů v jednotkách 100 ns.
+     * \return Perioda vektorů nebo UNDEFINED, pokud hlavička nebyla přečtena.
+     */
+    qint32 samplePeriod() const;
+
+    /*!
+     * \brief parameterKind Vrací druh parametrů včetně kvalifikátorů (položka parmKind).
+     * \return Druh parametrů nebo UNDEFINED, pokud hlavička nebyla přečtena.
+     */
+    int parameterKind() const;
+
+    /*!
+     * \brief write Metoda zapíše matici koeficientů do souboru (existující soubor je přepsán).
+     * \param features Ukazatel na vectors * vectorSize koeficientů uložených po vektorech.
+     * \param vectors Počet vektorů.
+     * \param vectorSize Počet koeficientů vektoru.
+     * \param samplePeriod Perioda vektorů v jednotkách 100 ns (viz samplePeriodFor).
+     * \param parameterKind Druh parametrů včetně kvalifikátorů.
+     * \return True, pokud byl zápis úspěšný, jinak false (a je emitován signál error).
+     */
+    bool write(const float *features, int vectors, int vectorSize, qint32 samplePeriod, int parameterKind);
+
+    /*!
+     * \brief write Přetížená metoda, která zapíše matici volajícího s libovolnými kroky.
+     * \param features Matice koeficientů (frames() vektorů po features() koeficientech).
+     * \param samplePeriod Perioda vektorů v jednotkách 100 ns.
+     * \param parameterKind Druh parametrů včetně kvalifikátorů.
+     * \return True, pokud byl zápis úspěšný, jinak false (a je emitován signál error).
+     */
+    bool write(const TensorView &features, qint32 samplePeriod, int parameterKind);
+
+    /*!
+     * \brief readAll Metoda přečte všechny vektory souboru.
+     * \return Souvislá matice koeficientů (vectorsCount() vektorů po vectorSize() koeficientech) nebo prázdný vektor
+     *         při chybě.
+     */
+    QVector<float> readAll();
+
+    /*!
+     * \brief read Metoda přečte všechny vektory přímo do matice volajícího. Segmenty matice za posledním vektorem
+     *             jsou vyplněny nulami.
+     * \param output Výstupní matice s vectorSize() prvky na segment a alespoň vectorsCount() segmenty.
+     * \return Počet přečtených vektorů nebo UNDEFINED při chybě.
+     */
+    int read(const TensorView &output);
+
+    /*!
+     * \brief samplePeriodFor Vypočítá periodu vektorů v jednotkách 100 ns pro daný posun segmentů.
+     * \param hop Posun sousedních segmentů ve vzorcích.
+     * \param sampleRate Frekvence vzorkování.
+     * \return Perioda vektorů (zaokrouhlená) nebo UNDEFINED při neplatných parametrech.
+     */
+    static qint32 samplePeriodFor(int hop, int sampleRate);
+
+    /*!
+     * \brief kindName Vrací název druhu parametrů v zápisu HTK (např. MFCC_E_D).
+     * \param parameterKind Druh parametrů včetně kvalifikátorů.
+     * \return Název druhu parametrů.
+     */
+    static QString kindName(int parameterKind);
+
+private:
+    QString m_fileName;         //!< Cesta k souboru parametrů HTK.
+    int m_vectorsCount;         //!< Počet vektorů z hlavičky.
+    int m_vectorSize;           //!< Počet koeficientů vektoru z hlavičky.
+    qint32 m_samplePeriod;      //!< Perioda vektorů z hlavičky.
+    int m_parameterKind;        //!< Druh parametrů z hlavičky.
+
+    /*!
+     * \brief readData Metoda přečte vektory za hlavičkou po blocích a převede je do matice.
+     * \param file Otevřený soubor nastavený za hlavičku.
+     * \param output Výstupní matice.
+     * \return True, pokud byla data přečtena, jinak false.
+     */
+    bool readData(QFile *file, const TensorView &output);
+
+signals:
+    /*!
+     * \brief error Signál, který je emitován při chybě.
+     * \param message Popis chyby.
+     */
+    void error(QString message);
+};
+
+#endif
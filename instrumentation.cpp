@@ -0,0 +1,202 @@
+#include "instrumentation.h"
+
+namespace {
+
+struct AtomicStage {
+    std::atomic<quint64> count;
+    std::atomic<quint64> totalNs;
+    std::atomic<quint64> maxNs;
+    std::atomic<quint64> histogram[INSTRUMENTATION_BUCKETS];
+};
+
+struct AtomicGauge {
+    std::atomic<quint64> fill;
+    std::atomic<quint64> peakFill;
+    std::atomic<quint64> capacity;
+};
+
+/* Statické proměnné jsou inicializovány nulou ještě před prvním použitím. */
+AtomicStage g_stages[Instrumentation::StagesCount];
+AtomicGauge g_buffers[Instrumentation::BuffersCount];
+std::atomic<quint64> g_counters[Instrumentation::CountersCount];
+
+void storeMax(std::atomic<quint64> &target, quint64 value) {
+    quint64 current = target.load(std::memory_order_relaxed);
+
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed));
+}
+
+int bucketOf(quint64 ns) {
+    int bucket = 0;
+
+    while (ns > 1 && bucket < INSTRUMENTATION_BUCKETS - 1) {
+        ns >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+}
+
+double StageStats::meanNs() const {
+    return (count > 0) ? static_cast<double>(totalNs) / static_cast<double>(count) : 0.0;
+}
+
+quint64 StageStats::percentileNs(double p) const {
+    if (count == 0)
+        return 0;
+
+    quint64 threshold = static_cast<quint64>(p * static_cast<double>(count));
+    quint64 cumulative = 0;
+
+    for (int i = 0; i < INSTRUMENTATION_BUCKETS; i++) {
+        cumulative += histogram[i];
+
+        if (cumulative > threshold || cumulative == count)
+            return qMin(maxNs, (2ULL << i) - 1);
+    }
+
+    return maxNs;
+}
+
+double Instrumentation::Snapshot::realTimeFactor(int sampleRate) const {
+    if (sampleRate <= 0 || counters[ReceivedSamples] == 0)
+        return 0.0;
+
+    quint64 totalNs = 0;
+    for (int i = 0; i < StagesCount; i++)
+        totalNs += stages[i].totalNs;
+
+    double audioNs = 1e9 * static_cast<double>(counters[ReceivedSamples]) / static_cast<double>(sampleRate);
+
+    return static_cast<double>(totalNs) / audioNs;
+}
+
+bool Instrumentation::isEnabled() {
+#ifdef PE_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Instrumentation::recordStage(Stage stage, quint64 ns) {
+    if (stage < 0 || stage >= StagesCount)
+        return;
+
+    AtomicStage &stats = g_stages[stage];
+
+    stats.count.fetch_add(1, std::memory_order_relaxed);
+    stats.totalNs.fetch_add(ns, std::memory_order_relaxed);
+    stats.histogram[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    storeMax(stats.maxNs, ns);
+}
+
+void Instrumentation::setBufferFill(Buffer buffer, quint64 fill, quint64 capacity) {
+    if (buffer < 0 || buffer >= BuffersCount)
+        return;
+
+    g_buffers[buffer].fill.store(fill, std::memory_order_relaxed);
+    g_buffers[buffer].capacity.store(capacity, std::memory_order_relaxed);
+    storeMax(g_buffers[buffer].peakFill, fill);
+}
+
+void Instrumentation::addToCounter(Counter counter, quint64 value) {
+    if (counter < 0 || counter >= CountersCount)
+        return;
+
+    g_counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+Instrumentation::Snapshot Instrumentation::snapshot() {
+    Snapshot snapshot;
+
+    for (int i = 0; i < StagesCount; i++) {
+        snapshot.stages[i].count = g_stages[i].count.load(std::memory_order_relaxed);
+        snapshot.stages[i].totalNs = g_stages[i].totalNs.load(std::memory_order_relaxed);
+        snapshot.stages[i].maxNs = g_stages[i].maxNs.load(std::memory_order_relaxed);
+
+        for (int j = 0; j < INSTRUMENTATION_BUCKETS; j++)
+            snapshot.stages[i].histogram[j] = g_stages[i].histogram[j].load(std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < BuffersCount; i++) {
+        snapshot.buffers[i].fill = g_buffers[i].fill.load(std::memory_order_relaxed);
+        snapshot.buffers[i].peakFill = g_buffers[i].peakFill.load(std::memory_order_relaxed);
+        snapshot.buffers[i].capacity = g_buffers[i].capacity.load(std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < CountersCount; i++)
+        snapshot.counters[i] = g_counters[i].load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+void Instrumentation::reset() {
+    for (int i = 0; i < StagesCount; i++) {
+        g_stages[i].count.store(0, std::memory_order_relaxed);
+        g_stages[i].totalNs.store(0, std::memory_order_relaxed);
+        g_stages[i].maxNs.store(0, std::memory_order_relaxed);
+
+        for (int j = 0; j < INSTRUMENTATION_BUCKETS; j++)
+            g_stages[i].histogram[j].store(0, std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < BuffersCount; i++) {
+        g_buffers[i].fill.store(0, std::memory_order_relaxed);
+        g_buffers[i].peakFill.store(0, std::memory_order_relaxed);
+        g_buffers[i].capacity.store(0, std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < CountersCount; i++)
+        g_counters[i].store(0, std::memory_order_relaxed);
+}
+
+QString Instrumentation::stageName(Stage stage) {
+    switch (stage) {
+    case Windowing: return "windowing";
+    case Fft: return "fft";
+    case Mel: return "mel";
+    case Dct: return "dct";
+    case FileRead: return "file_read";
+    case FileWrite: return "file_write";
+    default: return QString();
+    }
+}
+
+QString Instrumentation::bufferName(Buffer buffer) {
+    switch (buffer) {
+    case SegmenterBuffer: return "audio_segmenter";
+    case WindowerBuffer: return "io_audio_windower";
+    default: return QString();
+    }
+}
+
+QString Instrumentation::counterName(Counter counter) {
+    switch (counter) {
+    case ReceivedSamples: return "received_samples";
+    case ProcessedFrames: return "processed_frames";
+    case SilentFrames: return "silent_frames";
+    case DroppedSamples: return "dropped_samples";
+    case BufferOverruns: return "buffer_overruns";
+    default: return QString();
+    }
+}
+
+StageTimer::StageTimer(Instrumentation::Stage stage) {
+    m_stage = stage;
+    m_start = Clock::now();
+}
+
+StageTimer::~StageTimer() {
+    Instrumentation::recordStage(m_stage, std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_start).count());
+}
+
+void StageTimer::next(Instrumentation::Stage stage) {
+    Clock::time_point now = Clock::now();
+
+    Instrumentation::recordStage(m_stage, std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_start).count());
+    m_stage = stage;
+    m_start = now;
+}
@@ -0,0 +1,222 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <QString>
+
+#include <atomic>
+#include <chrono>
+
+#include "pe_config.h"
+
+/*!
+ * Počet přihrádek histogramu doby trvání. Přihrádka i obsahuje měření s dobou trvání v intervalu
+ * <2^i, 2^(i+1)) ns, poslední přihrádka obsahuje i všechna delší měření.
+ */
+#define INSTRUMENTATION_BUCKETS 40
+
+/*!
+ * \brief Struktura StageStats
+ *
+ * Statistika jednoho kroku výpočtu v okamžiku pořízení snímku (viz Instrumentation::snapshot).
+ */
+struct StageStats {
+    quint64 count;                                  //!< Počet měření.
+    quint64 totalNs;                                //!< Celková doba trvání všech měření v ns.
+    quint64 maxNs;                                  //!< Nejdelší naměřená doba v ns.
+    quint64 histogram[INSTRUMENTATION_BUCKETS];     //!< Logaritmický histogram doby trvání.
+
+    /*!
+     * \brief meanNs Vrací průměrnou dobu trvání kroku.
+     * \return Průměrná doba trvání v ns nebo 0, pokud nebylo nic změřeno.
+     */
+    double meanNs() const;
+
+    /*!
+     * \brief percentileNs Vrací horní odhad zadaného percentilu doby trvání (horní mez přihrádky histogramu).
+     * \param p Požadovaný percentil v rozsahu 0 až 1 (např. 0.99).
+     * \return Odhad percentilu v ns nebo 0, pokud nebylo nic změřeno.
+     */
+    quint64 percentileNs(double p) const;
+};
+
+/*!
+ * \brief Struktura BufferGauge
+ *
+ * Stav zaplnění kruhového bufferu v okamžiku pořízení snímku.
+ */
+struct BufferGauge {
+    quint64 fill;           //!< Počet vzorků, které čekají na zpracování.
+    quint64 peakFill;       //!< Největší zaznamenané zaplnění.
+    quint64 capacity;       //!< Kapacita bufferu ve vzorcích.
+};
+
+/*!
+ * \brief Třída Instrumentation
+ *
+ * Volitelné měření doby trvání jednotlivých kroků výpočtu MFCC, zaplnění kruhových bufferů a počtu zahozených
+ * dat. Měření se zapíná při překladu definicí PE_INSTRUMENTATION (volba LIBPE_ENABLE_INSTRUMENTATION), jinak
+ * makra PE_STAGE_BEGIN a PE_STAGE_NEXT nic nedělají a snímek obsahuje samé nuly. Všechny hodnoty jsou ukládány
+ * do atomických proměnných bez zámků, zápis i pořízení snímku je tedy možné z libovolného vlákna. Hodnoty jsou
+ * společné pro celý proces (všechny instance tříd knihovny).
+ */
+class Instrumentation {
+public:
+    /*!
+     * \brief Stage Měřené kroky výpočtu.
+     */
+    enum Stage {
+        Windowing,          //!< Váhování oknem (WindowFunction::normalize).
+        Fft,                //!< FFT včetně výpočtu magnitud (FFT::transformEucl).
+        Mel,                //!< Melovská filtrace a logaritmus.
+        Dct,                //!< Diskrétní kosinová transformace.
+        FileRead,           //!< Čtení souborů MFCC.
+        FileWrite,          //!< Zápis výstupních souborů (MFCC, HTK, WAV).
+        StagesCount
+    };
+
+    /*!
+     * \brief Buffer Sledované kruhové buffery.
+     */
+    enum Buffer {
+        SegmenterBuffer,    //!< Buffer třídy AudioSegmenter.
+        WindowerBuffer,     //!< Buffer třídy IOAudioWindower.
+        BuffersCount
+    };
+
+    /*!
+     * \brief Counter Sledované čítače.
+     */
+    enum Counter {
+        ReceivedSamples,    //!< Počet vzorků přijatých do bufferů.
+        ProcessedFrames,    //!< Počet segmentů, ze kterých byly vypočítány koeficienty.
+        SilentFrames,       //!< Počet segmentů, jejichž výpočet byl přeskočen detektorem řečové aktivity.
+        DroppedSamples,     //!< Počet vzorků zahozených kvůli nedostatečné velikosti bufferu.
+        BufferOverruns,     //!< Počet zápisů, které přepsaly dosud nezpracovaná data.
+        CountersCount
+    };
+
+    /*!
+     * \brief Struktura Snapshot
+     *
+     * Snímek všech měřených hodnot, který lze předat dalším systémům (metriky, logy).
+     */
+    struct Snapshot {
+        StageStats stages[StagesCount];     //!< Statistiky jednotlivých kroků.
+        BufferGauge buffers[BuffersCount];  //!< Zaplnění kruhových bufferů.
+        quint64 counters[CountersCount];    //!< Hodnoty čítačů.
+
+        /*!
+         * \brief realTimeFactor Vrací poměr doby výpočtu ke skutečné délce přijatého signálu. Hodnota menší
+         *                       než 1 znamená, že výpočet stíhá zpracovávat signál v reálném čase.
+         * \param sampleRate Frekvence vzorkování přijatého signálu.
+         * \return Real-time factor nebo 0, pokud nebyl přijat žádný signál.
+         */
+        double realTimeFactor(int sampleRate) const;
+    };
+
+    /*!
+     * \brief isEnabled Zjistí, zda byla knihovna přeložena s měřením.
+     * \return True, pokud je měření zapnuto, jinak false.
+     */
+    static bool isEnabled();
+
+    /*!
+     * \brief recordStage Zaznamená jedno měření doby trvání kroku.
+     * \param stage Měřený krok.
+     * \param ns Doba trvání v ns.
+     */
+    static void recordStage(Stage stage, quint64 ns);
+
+    /*!
+     * \brief setBufferFill Nastaví aktuální zaplnění bufferu.
+     * \param buffer Sledovaný buffer.
+     * \param fill Počet vzorků čekajících na zpracování.
+     * \param capacity Kapacita bufferu.
+     */
+    static void setBufferFill(Buffer buffer, quint64 fill, quint64 capacity);
+
+    /*!
+     * \brief addToCounter Přičte hodnotu k čítači.
+     * \param counter Čítač.
+     * \param value Přičítaná hodnota.
+     */
+    static void addToCounter(Counter counter, quint64 value = 1);
+
+    /*!
+     * \brief snapshot Pořídí snímek všech měřených hodnot.
+     * \return Snímek měřených hodnot.
+     */
+    static Snapshot snapshot();
+
+    /*!
+     * \brief reset Vynuluje všechny měřené hodnoty.
+     */
+    static void reset();
+
+    /*!
+     * \brief stageName Vrací název kroku, např. pro export do systému metrik.
+     * \param stage Krok výpočtu.
+     * \return Název kroku.
+     */
+    static QString stageName(Stage stage);
+
+    /*!
+     * \brief bufferName Vrací název bufferu.
+     * \param buffer Buffer.
+     * \return Název bufferu.
+     */
+    static QString bufferName(Buffer buffer);
+
+    /*!
+     * \brief counterName Vrací název čítače.
+     * \param counter Čítač.
+     * \return Název čítače.
+     */
+    static QString counterName(Counter counter);
+};
+
+/*!
+ * \brief Třída StageTimer
+ *
+ * Měří dobu trvání kroku od konstrukce objektu do jeho destrukce, popřípadě do volání metody next, která
+ * měření ukončí a zahájí měření dalšího kroku. Využívá std::chrono::steady_clock.
+ */
+class StageTimer {
+public:
+    /*!
+     * \brief StageTimer Konstruktor třídy, zahájí měření daného kroku.
+     * \param stage Měřený krok.
+     */
+    explicit StageTimer(Instrumentation::Stage stage);
+
+    /*!
+     * Destruktor třídy, ukončí měření aktuálního kroku.
+     */
+    ~StageTimer();
+
+    /*!
+     * \brief next Ukončí měření aktuálního kroku a zahájí měření dalšího.
+     * \param stage Další měřený krok.
+     */
+    void next(Instrumentation::Stage stage);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Instrumentation::Stage m_stage;     //!< Aktuálně měřený krok.
+    Clock::time_point m_start;          //!< Začátek měření aktuálního kroku.
+};
+
+#ifdef PE_INSTRUMENTATION
+#define PE_STAGE_BEGIN(stage) StageTimer peStageTimer(Instrumentation::stage)
+#define PE_STAGE_NEXT(stage) peStageTimer.next(Instrumentation::stage)
+#define PE_BUFFER_FILL(buffer, fill, capacity) Instrumentation::setBufferFill(Instrumentation::buffer, (fill), (capacity))
+#define PE_COUNT(counter, value) Instrumentation::addToCounter(Instrumentation::counter, (value))
+#else
+#define PE_STAGE_BEGIN(stage)
+#define PE_STAGE_NEXT(stage)
+#define PE_BUFFER_FILL(buffer, fill, capacity) ((void)0)
+#define PE_COUNT(counter, value) ((void)0)
+#endif
+
+#endif
@@ -79,6 +79,10 @@ qint64 IOAudioWindower::writeData(const char *data, qint64 maxSize) {
     if (m_extractTimeData)
         emitRawTimeData(data, maxSize);
 
+    PE_COUNT(ReceivedSamples, maxSize / sizeof(sample));
+    if (((m_next - m_first + m_bufferSize) % m_bufferSize) + (maxSize / static_cast<qint64>(sizeof(sample))) >= m_bufferSize)
+        PE_COUNT(BufferOverruns, 1);
+
     int newPosition = m_next + (maxSize / sizeof(sample));
     if (newPosition > m_bufferSize) {
         size_t restCountBytes = (m_bufferSize - m_next) * sizeof(sample);
@@ -93,5 +97,7 @@ qint64 IOAudioWindower::writeData(const char *data, qint64 maxSize) {
 
     while (isWindowBuffered()) finalizeWindow();
 
+    PE_BUFFER_FILL(WindowerBuffer, (m_next - m_first + m_bufferSize) % m_bufferSize, m_bufferSize);
+
     return maxSize;
 }
@@ -7,6 +7,7 @@
 #include <QVector>
 
 #include "pe_config.h"
+#include "instrumentation.h"
 
 /*!
  *  Multiplikátor minimálně použitelné velikosti bufferu.
@@ -1,5 +1,5 @@
-#ifndef FILTERBANK_H
-#define FILTERBANK_H
+#ifndef MELFILTERBANK_H
+#define MELFILTERBANK_H
 
 #include <QObject>
 #include <QVector>
@@ -7,8 +7,17 @@
 
 #include "pe_config.h"
 
+/*!
+ * Výchozí dolní mez melovských energií před logaritmem (FrameKernel::LogMel, MFCC::calculateLogMel).
+ */
+#define MEL_LOG_FLOOR 1e-10f
+
 /*!
  * \brief Třída MelFilterBank obahuje metody pro generování a uchovávání banky melovských filtrů.
+ *
+ * Hranice filtrů jsou na indexy odhadu výkonové spektrální hustoty převáděny poměrem espdSize / sampleRate, banka
+ * tedy závisí pouze na počtu prvků odhadu, nikoli na tom, zda je velikost transformace mocninou 2. Pro segmenty
+ * transformované s FFT::NextFastSize je nutné banku vytvořit s FFT::espdSize() daného objektu FFT.
  */
 class MelFilterBank : public QObject {
     Q_OBJECT
@@ -14,6 +14,9 @@ QVector<float> MFCC::calculate(QVector<float> espd, int count) {
         return QVector<float>();
     }
 
+    PE_STAGE_BEGIN(Mel);
+    PE_COUNT(ProcessedFrames, 1);
+
     QVector<float> mels = calcMelCoefs(espd);
 
     QMutableVectorIterator<float> melsIt(mels);
@@ -27,6 +30,8 @@ QVector<float> MFCC::calculate(QVector<float> espd, int count) {
     if (count <= 0 || count > m_filtersCount)
         count = m_filtersCount;
 
+    PE_STAGE_NEXT(Dct);
+
     QVector<float> keps(count);
 
     for (int i = 0; i < keps.size(); i++) {
@@ -37,6 +42,23 @@ QVector<float> MFCC::calculate(QVector<float> espd, int count) {
     return keps;
 }
 
+QVector<float> MFCC::calculateLogMel(QVector<float> espd, float logFloor) {
+    if (espd.size() != m_espdSize || !(logFloor > 0.0f)) {
+        emit error("MFCC::calculateLogMel: Neočekávaná délka vstupního vektoru nebo neplatná dolní mez logaritmu.");
+        return QVector<float>();
+    }
+
+    PE_STAGE_BEGIN(Mel);
+    PE_COUNT(ProcessedFrames, 1);
+
+    QVector<float> mels = calcMelCoefs(espd);
+
+    for (int i = 0; i < mels.size(); i++)
+        mels[i] = qLn(qMax(mels[i], logFloor));
+
+    return mels;
+}
+
 QVector<float> MFCC::calcMelCoefs(QVector<float> espd) {
     QVector<float> mels(m_filtersCount);
 
@@ -6,6 +6,7 @@
 #include <QMutableVectorIterator>
 
 #include "pe_config.h"
+#include "instrumentation.h"
 #include "melfilterbank.h"
 
 /*!
@@ -41,6 +42,17 @@ public:
      */
     QVector<float> calculate(QVector<float> espd, int count);
 
+    /*!
+     * \brief calculateLogMel Metoda vypočítá pouze logaritmy melovských koeficientů (bez DCT), např. jako vstup
+     *                        neuronových sítí. Melovské koeficienty menší než logFloor jsou před logaritmem nahrazeny
+     *                        hodnotou logFloor. Pokud se počet přijatých prvků nerovná hodnotě m_espdSize nebo dolní
+     *                        mez není kladná, je emitován signál error a je vrácen prázdný vektor.
+     * \param espd Vstupní vektor spektra (pro obvyklé log-mel příznaky výkonové spektrum, viz FFT::transformPower).
+     * \param logFloor Dolní mez melovských koeficientů před logaritmem.
+     * \return Vektor m_filtersCount logaritmů melovských koeficientů.
+     */
+    QVector<float> calculateLogMel(QVector<float> espd, float logFloor = MEL_LOG_FLOOR);
+
 private:
     int m_sampleRate;           //!< Frekvence vzorkování parametrizovaného signálu.
     int m_espdSize;             //!< Očekávaná velikost vektorů odhadu výkonové spektrální hustoty.
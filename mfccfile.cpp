@@ -66,6 +66,8 @@ bool MfccFile::write(const QVector<QVector<float>> &mfccs) {
     if (!isValidMfccVector(mfccs))
         return false;
 
+    PE_STAGE_BEGIN(FileWrite);
+
     QFile mfccFile(m_fileName);
     if (!mfccFile.open(QFile::WriteOnly | QFile::Truncate))
         return false;
@@ -83,6 +85,34 @@ bool MfccFile::write(const QVector<QVector<float>> &mfccs) {
     return true;
 }
 
+bool MfccFile::write(const float *mfccs, int vectors) {
+    if (!mfccs || vectors <= 0)
+        return false;
+
+    PE_STAGE_BEGIN(FileWrite);
+
+    QFile mfccFile(m_fileName);
+    if (!mfccFile.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+
+    QDataStream output(&mfccFile);
+    initStream(&output);
+
+    output << static_cast<int32_t>(vectors);
+
+    qint64 count = static_cast<qint64>(vectors) * MFCC_COUNT;
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    qint64 bytes = count * static_cast<qint64>(sizeof(float));
+    return mfccFile.write(reinterpret_cast<const char *>(mfccs), bytes) == bytes;
+#else
+    for (qint64 i = 0; i < count; i++)
+        output << mfccs[i];
+
+    return output.status() == QDataStream::Ok;
+#endif
+}
+
 bool MfccFile::append(const QVector<float> &mfccs, bool checkFile) {
     if (mfccs.size() != MFCC_COUNT || (checkFile && !isWritable()))
         return false;
@@ -94,6 +124,8 @@ bool MfccFile::append(const QVector<float> &mfccs, bool checkFile) {
         return write(temp);
     }
 
+    PE_STAGE_BEGIN(FileWrite);
+
     QFile file(m_fileName);
     if (!file.open(QFile::ReadWrite))
         return false;
@@ -121,6 +153,8 @@ QVector<QVector<float>> MfccFile::readAll(bool checkFile) {
     if (checkFile && !isReadable())
         return QVector<QVector<float>>();
 
+    PE_STAGE_BEGIN(FileRead);
+
     QFile file(m_fileName);
     if (!file.open(QFile::ReadOnly))
         return QVector<QVector<float>>();
@@ -147,6 +181,79 @@ QVector<QVector<float>> MfccFile::readAll(bool checkFile) {
     return mfccs;
 }
 
+int MfccFile::vectorsCount() {
+    QFile file(m_fileName);
+    if (!file.open(QFile::ReadOnly) || file.size() < static_cast<qint64>(sizeof(int32_t)))
+        return UNDEFINED;
+
+    QDataStream stream(&file);
+    initStream(&stream);
+
+    int32_t vectors;
+    stream >> vectors;
+
+    return (vectors >= 0) ? vectors : UNDEFINED;
+}
+
+int MfccFile::read(const TensorView &output, bool checkFile) {
+    if (output.isNull() || output.features() != MFCC_COUNT || (checkFile && !isReadable()))
+        return UNDEFINED;
+
+    PE_STAGE_BEGIN(FileRead);
+
+    QFile file(m_fileName);
+    if (!file.open(QFile::ReadOnly))
+        return UNDEFINED;
+
+    QDataStream stream(&file);
+    initStream(&stream);
+
+    int32_t vectors;
+    stream >> vectors;
+
+    if (vectors < 0 || vectors > output.frames())
+        return UNDEFINED;
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    /* Souvislá matice je přečtena jedním blokem, jinak po blocích přes pracovní buffer. */
+    if (output.hasContiguousFrames() && output.frameStride() == MFCC_COUNT) {
+        qint64 bytes = static_cast<qint64>(vectors) * MFCC_COUNT * static_cast<qint64>(sizeof(float));
+        if (file.read(reinterpret_cast<char *>(output.data()), bytes) != bytes)
+            return UNDEFINED;
+    }
+    else {
+        const int blockVectors = 256;
+        QVector<float> block(blockVectors * MFCC_COUNT);
+
+        for (int begin = 0; begin < vectors; begin += blockVectors) {
+            int count = qMin(blockVectors, vectors - begin);
+            qint64 bytes = static_cast<qint64>(count) * MFCC_COUNT * static_cast<qint64>(sizeof(float));
+
+            if (file.read(reinterpret_cast<char *>(block.data()), bytes) != bytes)
+                return UNDEFINED;
+
+            for (int i = 0; i < count; i++)
+                output.store(begin + i, block.constData() + i * MFCC_COUNT);
+        }
+    }
+#else
+    float values[MFCC_COUNT];
+
+    for (int i = 0; i < vectors; i++) {
+        for (int j = 0; j < MFCC_COUNT; j++)
+            stream >> values[j];
+
+        output.store(i, values);
+    }
+
+    if (stream.status() != QDataStream::Ok)
+        return UNDEFINED;
+#endif
+
+    output.fill(vectors, output.frames());
+    return vectors;
+}
+
 void MfccFile::initStream(QDataStream *stream) {
     if (!stream) return;
 
@@ -10,6 +10,8 @@
 #include <QDebug>
 
 #include "pe_config.h"
+#include "instrumentation.h"
+#include "tensorview.h"
 
 /*!
  * \brief Třída MfccFile
@@ -93,6 +95,15 @@ public:
      */
     bool write(const QVector<QVector<float>> &mfccs);
 
+    /*!
+     * \brief write Přetížená metoda, která do souboru zapíše souvislou matici MFCC koeficientů (vektory po MFCC_COUNT
+     *              koeficientech uložené za sebou). Na platformách s malým endianem jsou data zapsána jedním blokem.
+     * \param mfccs Ukazatel na vectors * MFCC_COUNT koeficientů.
+     * \param vectors Počet vektorů.
+     * \return True, pokud byl zápis úspěšný, jinak false.
+     */
+    bool write(const float *mfccs, int vectors);
+
     /*!
      * \brief append Metoda přidá zadaný vektor na konec MFCC souboru a inkrementuje jejich počet v souboru.
      * \param mfccs Vektor MFCC koeficientů, který bude přidán na konec souboru.
@@ -109,6 +120,22 @@ public:
      */
     QVector<QVector<float>> readAll(bool checkFile = false);
 
+    /*!
+     * \brief vectorsCount Metoda přečte počet vektorů uvedený v hlavičce souboru (např. pro alokaci matice).
+     * \return Počet vektorů MFCC koeficientů nebo UNDEFINED, pokud soubor nelze číst.
+     */
+    int vectorsCount();
+
+    /*!
+     * \brief read Metoda přečte všechny vektory MFCC koeficientů přímo do matice volajícího (bez vektoru vektorů).
+     *             Pro souvislou matici FrameMajor na platformách s malým endianem jsou data přečtena jedním blokem.
+     *             Segmenty matice za posledním vektorem jsou vyplněny nulami.
+     * \param output Výstupní matice s MFCC_COUNT prvky na segment a alespoň vectorsCount() segmenty.
+     * \param checkFile True, pokud má být zkontrolována validita souboru před jeho čtením.
+     * \return Počet přečtených vektorů nebo UNDEFINED při chybě.
+     */
+    int read(const TensorView &output, bool checkFile = false);
+
 
 private:
     QString m_fileName;     //!< Cesta k MFCC souboru.
@@ -0,0 +1,178 @@
+#include "multichannelsegmenter.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+MultiChannelSegmenter::MultiChannelSegmenter(int channels, Mode mode, int segmentSize, int overlap, int bufferSize,
+                                             int selectedChannel, QObject *parent) : QObject(parent) {
+    m_channels = channels;
+    m_mode = mode;
+    m_selectedChannel = selectedChannel;
+    m_segmentSize = segmentSize;
+
+    if (channels <= 0 || (mode == Select && (selectedChannel < 0 || selectedChannel >= channels))) {
+        emit error("MultiChannelSegmenter: Neplatný počet kanálů nebo index zvoleného kanálu.");
+        m_channels = 1;
+        m_selectedChannel = 0;
+    }
+
+    int streams = (m_mode == PerChannel) ? m_channels : 1;
+
+    for (int c = 0; c < streams; c++) {
+        AudioSegmenter *segmenter = new AudioSegmenter(segmentSize, overlap, bufferSize, this);
+        connect(segmenter, &AudioSegmenter::error, this, &MultiChannelSegmenter::error);
+        m_segmenters.append(segmenter);
+    }
+
+    m_streams.resize(streams);
+}
+
+int MultiChannelSegmenter::channels() const {
+    return m_channels;
+}
+
+int MultiChannelSegmenter::outputChannels() const {
+    return m_segmenters.size();
+}
+
+int MultiChannelSegmenter::segmentSize() const {
+    return m_segmentSize;
+}
+
+void MultiChannelSegmenter::writeAudio(const sample *data, int frames) {
+    if (!data || frames <= 0)
+        return;
+
+    for (QVector<sample> &stream : m_streams)
+        stream.resize(frames);
+
+    switch (m_mode) {
+    case Downmix:
+        downmix(data, frames);
+        break;
+    case PerChannel:
+        deinterleave(data, frames);
+        break;
+    case Select: {
+        sample *stream = m_streams[0].data();
+        for (int i = 0; i < frames; i++)
+            stream[i] = data[i * m_channels + m_selectedChannel];
+        break;
+    }
+    }
+
+    for (int c = 0; c < m_segmenters.size(); c++)
+        m_segmenters[c]->writeAudio(m_streams[c]);
+}
+
+void MultiChannelSegmenter::writeAudio(const QVector<sample> &data) {
+    if (data.size() % m_channels != 0) {
+        emit error("MultiChannelSegmenter: Počet vzorků není násobkem počtu kanálů.");
+        return;
+    }
+
+    writeAudio(data.constData(), data.size() / m_channels);
+}
+
+bool MultiChannelSegmenter::hasNextBatch() {
+    // všechny proudy jsou plněny stejně, stačí se zeptat prvního
+    return m_segmenters.first()->hasNextSegment();
+}
+
+QVector<sample> MultiChannelSegmenter::nextBatch() {
+    if (isEmpty())
+        return QVector<sample>();
+
+    QVector<sample> batch;
+    batch.reserve(m_segmenters.size() * m_segmentSize);
+
+    for (AudioSegmenter *segmenter : m_segmenters)
+        batch.append(segmenter->nextSegment());
+
+    return batch;
+}
+
+bool MultiChannelSegmenter::isEmpty() {
+    return m_segmenters.first()->isEmpty();
+}
+
+void MultiChannelSegmenter::deinterleave(const sample *data, int frames) {
+    int i = 0;
+
+    if (m_channels == 1) {
+        std::copy(data, data + frames, m_streams[0].data());
+        return;
+    }
+
+    if (m_channels == 2) {
+        sample *left = m_streams[0].data();
+        sample *right = m_streams[1].data();
+
+#ifdef __SSE2__
+        /* Každý 32bitový prvek obsahuje jeden rámec (R << 16) | L, kanály se oddělí posuny se znaménkem. */
+        for (; i + 8 <= frames; i += 8) {
+            __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 2 * i));
+            __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 2 * i + 8));
+
+            __m128i leftPacked = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(first, 16), 16),
+                                                 _mm_srai_epi32(_mm_slli_epi32(second, 16), 16));
+            __m128i rightPacked = _mm_packs_epi32(_mm_srai_epi32(first, 16), _mm_srai_epi32(second, 16));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(left + i), leftPacked);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(right + i), rightPacked);
+        }
+#endif
+
+        for (; i < frames; i++) {
+            left[i] = data[2 * i];
+            right[i] = data[2 * i + 1];
+        }
+
+        return;
+    }
+
+    for (int c = 0; c < m_channels; c++) {
+        sample *stream = m_streams[c].data();
+
+        for (i = 0; i < frames; i++)
+            stream[i] = data[i * m_channels + c];
+    }
+}
+
+void MultiChannelSegmenter::downmix(const sample *data, int frames) {
+    sample *mono = m_streams[0].data();
+    int i = 0;
+
+    if (m_channels == 2) {
+#ifdef __SSE2__
+        for (; i + 8 <= frames; i += 8) {
+            __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 2 * i));
+            __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 2 * i + 8));
+
+            // součet L + R ve 32 bitech a aritmetický posun = (L + R) / 2 zaokrouhleno dolů
+            __m128i firstSum = _mm_srai_epi32(_mm_add_epi32(_mm_srai_epi32(_mm_slli_epi32(first, 16), 16),
+                                                            _mm_srai_epi32(first, 16)), 1);
+            __m128i secondSum = _mm_srai_epi32(_mm_add_epi32(_mm_srai_epi32(_mm_slli_epi32(second, 16), 16),
+                                                             _mm_srai_epi32(second, 16)), 1);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(mono + i), _mm_packs_epi32(firstSum, secondSum));
+        }
+#endif
+
+        for (; i < frames; i++)
+            mono[i] = mix(data[2 * i] + data[2 * i + 1], 2);
+
+        return;
+    }
+
+    for (; i < frames; i++) {
+        const sample *frame = data + i * m_channels;
+        int sum = 0;
+
+        for (int c = 0; c < m_channels; c++)
+            sum += frame[c];
+
+        mono[i] = mix(sum, m_channels);
+    }
+}
@@ -0,0 +1,140 @@
+#ifndef MULTICHANNELSEGMENTER_H
+#define MULTICHANNELSEGMENTER_H
+
+#include <QObject>
+#include <QVector>
+
+#include "pe_config.h"
+#include "audiosegmenter.h"
+
+/*!
+ * \brief Třída MultiChannelSegmenter
+ *
+ * Třída rozkládá prokládaný (interleaved) vícekanálový PCM signál na segmenty. Vstupem jsou rámce po channels
+ * vzorcích (např. L R L R ... pro stereo), ze kterých je podle zvoleného režimu (viz Mode) vytvořen jeden nebo
+ * více monofonních proudů. Každý proud je dělen na segmenty vlastním objektem AudioSegmenter, takže platí stejná
+ * pravidla pro velikost bufferu a doplňování posledního segmentu nulami.
+ *
+ * Rozdělení kanálů (resp. smíchání do mono) probíhá v jednom průchodu vstupními daty, pro stereo s využitím SSE2.
+ * Segmenty všech proudů jsou vydávány najednou jako jedna dávka uložená souvisle po proudech, kterou lze rovnou
+ * předat výpočtu koeficientů (např. FrameKernel::process pro každý z outputChannels() segmentů).
+ */
+class MultiChannelSegmenter : public QObject {
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief Mode Způsob zpracování kanálů.
+     */
+    enum Mode {
+        Downmix,        //!< Průměr všech kanálů do jednoho proudu (zaokrouhlený dolů, viz mix).
+        PerChannel,     //!< Každý kanál tvoří samostatný proud.
+        Select          //!< Pouze jeden zvolený kanál.
+    };
+
+    /*!
+     * \brief MultiChannelSegmenter Konstruktor třídy.
+     * \param channels Počet prokládaných kanálů vstupního signálu.
+     * \param mode Způsob zpracování kanálů.
+     * \param segmentSize Velikost segmentů.
+     * \param overlap Překryv segmentů.
+     * \param bufferSize Velikost pracovního bufferu každého proudu ve vzorcích (viz AudioSegmenter).
+     * \param selectedChannel Index zpracovávaného kanálu v režimu Select.
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolnění).
+     */
+    explicit MultiChannelSegmenter(int channels, Mode mode, int segmentSize, int overlap, int bufferSize,
+                                   int selectedChannel = 0, QObject *parent = nullptr);
+
+    /*!
+     * \brief channels Vrací počet prokládaných kanálů vstupního signálu.
+     * \return Počet kanálů vstupu.
+     */
+    int channels() const;
+
+    /*!
+     * \brief outputChannels Vrací počet proudů, tj. počet segmentů v jedné dávce.
+     * \return Počet výstupních proudů.
+     */
+    int outputChannels() const;
+
+    /*!
+     * \brief segmentSize Vrací velikost segmentů.
+     * \return Počet vzorků jednoho segmentu.
+     */
+    int segmentSize() const;
+
+    /*!
+     * \brief mix Vrací průměr vzorků kanálů zaokrouhlený dolů (k minus nekonečnu) pro libovolný počet kanálů,
+     *            stejně jako aritmetický posun u sterea (i v SSE2 větvi).
+     * \param sum Součet vzorků všech kanálů rámce.
+     * \param channels Počet kanálů.
+     * \return Smíchaný vzorek.
+     */
+    static inline sample mix(int sum, int channels) {
+        return static_cast<sample>((sum >= 0) ? (sum / channels) : ((sum - channels + 1) / channels));
+    }
+
+    /*!
+     * \brief writeAudio Zapíše prokládaná vstupní data. Počet vzorků musí být násobkem počtu kanálů.
+     * \param data Ukazatel na prokládané vzorky.
+     * \param frames Počet rámců (vzorků jednoho kanálu).
+     */
+    void writeAudio(const sample *data, int frames);
+
+    /*!
+     * \brief writeAudio Přetížená metoda.
+     * \param data Vektor prokládaných vzorků.
+     */
+    void writeAudio(const QVector<sample> &data);
+
+    /*!
+     * \brief hasNextBatch Zjistí, zda je připraven celý segment všech proudů.
+     * \return True, pokud je připravena celá dávka, jinak false.
+     */
+    bool hasNextBatch();
+
+    /*!
+     * \brief nextBatch Vrátí segmenty všech proudů uložené za sebou (outputChannels() * segmentSize() vzorků,
+     *                  segment proudu c začíná na indexu c * segmentSize()). Neúplné segmenty jsou doplněny nulami,
+     *                  v případě prázdného bufferu je vrácen prázdný vektor.
+     * \return Dávka segmentů.
+     */
+    QVector<sample> nextBatch();
+
+    /*!
+     * \brief isEmpty Zjistí, zda jsou v bufferech nějaká data.
+     * \return True, pokud jsou buffery prázdné, jinak false.
+     */
+    bool isEmpty();
+
+private:
+    int m_channels;                             //!< Počet prokládaných kanálů vstupu.
+    Mode m_mode;                                //!< Způsob zpracování kanálů.
+    int m_selectedChannel;                      //!< Index kanálu v režimu Select.
+    int m_segmentSize;                          //!< Velikost segmentů.
+    QVector<AudioSegmenter *> m_segmenters;     //!< Segmentery jednotlivých proudů.
+    QVector<QVector<sample>> m_streams;         //!< Pracovní buffery rozdělených proudů.
+
+    /*!
+     * \brief deinterleave Rozdělí prokládaná data do pracovních bufferů jednotlivých kanálů.
+     * \param data Ukazatel na prokládané vzorky.
+     * \param frames Počet rámců.
+     */
+    void deinterleave(const sample *data, int frames);
+
+    /*!
+     * \brief downmix Smíchá prokládaná data do prvního pracovního bufferu.
+     * \param data Ukazatel na prokládané vzorky.
+     * \param frames Počet rámců.
+     */
+    void downmix(const sample *data, int frames);
+
+signals:
+    /*!
+     * \brief error Signál, který informuje o chybovém stavu.
+     * \param message Obsah chybového hlášení.
+     */
+    void error(const QString& message);
+};
+
+#endif
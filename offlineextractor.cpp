@@ -0,0 +1,591 @@
+#include "offlineextractor.h"
+#include "multichannelsegmenter.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace {
+
+/* Společná data všech vláken jedné extrakce. */
+struct ExtractionJob {
+    const sample *samples;      // prokládané vzorky v namapovaném souboru
+    qint64 samplesCount;        // počet vzorků jednoho kanálu
+    int channels;
+    int segmentSize;
+    int hop;
+    int sampleRate;
+    int filtersCount;
+    int coefsCount;
+    FFT::SizePolicy fftPolicy;
+    float preEmphasis;          // koeficient preemfáze (0 = vypnutá)
+    float ditherAmplitude;
+    quint32 ditherSeed;
+    FilterBank filters;         // banka filtrů pro frekvenci vzorkování souboru (sdílená, jen pro čtení)
+    int lifter;
+    FrameKernel::EnergyTerm energyTerm;
+    int descriptors;            // příznaky spektrálních deskriptorů (0 = žádné)
+    bool pitch;                 // odhad základní frekvence
+    float pitchMinFrequency;
+    float pitchMaxFrequency;
+    PitchTracker::Estimate *estimates;      // odhady základní frekvence segmentů (framesCount)
+    PitchTracker::Candidate *candidates;    // kandidáti segmentů pro vyhlazení (framesCount * PITCH_CANDIDATES)
+    qint64 framesCount;
+    int chunkSize;
+    int chunksCount;
+    QAtomicInt nextChunk;       // index dalšího nezpracovaného bloku
+    TensorView output;          // koeficienty a deskriptory ve výstupní matici (vlastní ji volající nebo metoda extract)
+};
+
+/* Vlákno si postupně bere bloky segmentů, dokud nějaké zbývají, a pro všechny použije jeden FrameKernel. */
+class ExtractionWorker : public QRunnable {
+public:
+    explicit ExtractionWorker(ExtractionJob *job) : m_job(job) {}
+
+    void run() override {
+        FrameKernel kernel(m_job->segmentSize, m_job->sampleRate, m_job->filtersCount, m_job->coefsCount,
+                           m_job->fftPolicy);
+        QVector<sample> scratch(m_job->segmentSize);
+        kernel.setFilterBank(m_job->filters);
+        kernel.setLifter(m_job->lifter);
+        kernel.setEnergyTerm(m_job->energyTerm);
+
+        SpectralDescriptors descriptors(kernel.espdSize(), m_job->sampleRate, m_job->descriptors);
+        QVector<float> primed;
+        if (m_job->descriptors) {
+            kernel.setSpectralDescriptors(&descriptors);
+            primed.resize(kernel.outputSize());
+        }
+
+        PitchTracker tracker(m_job->segmentSize, m_job->sampleRate, m_job->pitchMinFrequency, m_job->pitchMaxFrequency);
+
+        PreEmphasis preEmphasis(m_job->segmentSize, m_job->hop, m_job->preEmphasis);
+        bool filtered = m_job->preEmphasis > 0.0f || m_job->ditherAmplitude > 0.0f;
+        if (filtered) {
+            preEmphasis.setDither(m_job->ditherAmplitude, m_job->ditherSeed);
+            kernel.setPreEmphasis(&preEmphasis);
+        }
+
+        for (int chunk = m_job->nextChunk.fetchAndAddRelaxed(1); chunk < m_job->chunksCount;
+             chunk = m_job->nextChunk.fetchAndAddRelaxed(1)) {
+            qint64 begin = static_cast<qint64>(chunk) * m_job->chunkSize;
+            qint64 end = qMin(m_job->framesCount, begin + m_job->chunkSize);
+
+            /* Bloky zpracovávají různá vlákna, stav preemfáze je proto nastaven podle pozice bloku v souboru. */
+            /* Flux prvního segmentu bloku potřebuje spektrum předchozího segmentu, ten je proto spočítán znovu. */
+            qint64 first = (m_job->descriptors && begin > 0) ? begin - 1 : begin;
+            descriptors.reset();
+
+            if (filtered) {
+                qint64 start = first * m_job->hop;
+                preEmphasis.reset(start, (start > 0) ? sampleAt(start - 1) : 0);
+            }
+
+            if (first < begin)
+                kernel.process(segmentAt(first, scratch.data()), primed.data());
+
+            for (qint64 frame = begin; frame < end; frame++) {
+                const sample *segment = segmentAt(frame, scratch.data());
+                kernel.process(segment, m_job->output, static_cast<int>(frame));
+
+                // stejný segment, ještě bez preemfáze (FrameKernel ji provádí ve vlastním bufferu)
+                if (m_job->pitch)
+                    m_job->estimates[frame] = tracker.estimate(segment, m_job->candidates + frame * PITCH_CANDIDATES);
+            }
+        }
+    }
+
+private:
+    ExtractionJob *m_job;
+
+    /* Ukazatel na vzorky segmentu, přímo do namapovaného souboru, nebo do pracovního bufferu scratch. */
+    const sample *segmentAt(qint64 frame, sample *scratch) const {
+        qint64 start = frame * m_job->hop;
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        if (m_job->channels == 1 && start + m_job->segmentSize <= m_job->samplesCount)
+            return m_job->samples + start;
+#endif
+
+        gather(start, scratch);
+        return scratch;
+    }
+
+    /* Segment, který nelze číst přímo: konec souboru (doplnění nulami) nebo více kanálů (smíchání do mono). */
+    void gather(qint64 start, sample *segment) const {
+        for (int i = 0; i < m_job->segmentSize; i++)
+            segment[i] = (start + i < m_job->samplesCount) ? sampleAt(start + i) : 0;
+    }
+
+    /* Vzorek na dané pozici (smíchaný do mono). */
+    sample sampleAt(qint64 index) const {
+        int channels = m_job->channels;
+        const sample *frame = m_job->samples + index * channels;
+        int sum = 0;
+
+        for (int c = 0; c < channels; c++)
+            sum += qFromLittleEndian<qint16>(frame + c);
+
+        // stejné zaokrouhlení jako MultiChannelSegmenter::Downmix
+        return MultiChannelSegmenter::mix(sum, channels);
+    }
+};
+
+}
+
+OfflineExtractor::OfflineExtractor(int segmentSize, int overlap, int filtersCount, int coefsCount, QObject *parent)
+        : QObject(parent) {
+    m_segmentSize = segmentSize;
+    m_hop = segmentSize - overlap;
+    m_filtersCount = filtersCount;
+    m_coefsCount = (coefsCount <= 0 || coefsCount > filtersCount) ? filtersCount : coefsCount;
+    m_rawSampleRate = SAMPLE_RATE;
+    m_rawChannels = CHANNEL_COUNT;
+    m_threads = QThread::idealThreadCount();
+    m_chunkSize = 2048;
+    m_fftPolicy = FFT::PowerOfTwo;
+    m_preEmphasis = 0.0f;
+    m_ditherAmplitude = 0.0f;
+    m_ditherSeed = 0;
+    m_filterScale = FilterBank::LegacyMel;
+    m_lowFrequency = 0.0f;
+    m_highFrequency = FILTERBANK_NYQUIST;
+    m_filterNormalization = FilterBank::NoNormalization;
+    m_lifter = 0;
+    m_energyTerm = FrameKernel::LeadingC0;
+    m_descriptors = 0;
+    m_pitch = false;
+    m_pitchSmoothed = true;
+    m_pitchMinFrequency = PITCH_MIN_FREQUENCY;
+    m_pitchMaxFrequency = PITCH_MAX_FREQUENCY;
+    m_deltaOrder = 0;
+    m_deltaWindow = 2;
+    m_cmvn = false;
+    m_cmvnMode = Cmvn::Utterance;
+    m_cmvnVariance = true;
+    m_cmvnWindow = 300;
+    m_sampleRate = 0;
+    m_samplesCount = 0;
+    m_framesCount = 0;
+
+    if (segmentSize <= 1 || m_hop <= 0 || filtersCount <= 0) {
+        emit error("OfflineExtractor::OfflineExtractor: Neplatné parametry segmentace nebo výpočtu.");
+        m_segmentSize = 0;
+    }
+}
+
+void OfflineExtractor::setRawFormat(int sampleRate, int channels) {
+    m_rawSampleRate = sampleRate;
+    m_rawChannels = channels;
+}
+
+void OfflineExtractor::setThreadCount(int threads) {
+    m_threads = qMax(1, threads);
+}
+
+void OfflineExtractor::setChunkSize(int frames) {
+    m_chunkSize = qMax(1, frames);
+}
+
+void OfflineExtractor::setFftSizePolicy(FFT::SizePolicy policy) {
+    m_fftPolicy = policy;
+}
+
+void OfflineExtractor::setPreEmphasis(float coefficient, float ditherAmplitude, quint32 ditherSeed) {
+    m_preEmphasis = qBound(0.0f, coefficient, 1.0f);
+    m_ditherAmplitude = qMax(0.0f, ditherAmplitude);
+    m_ditherSeed = ditherSeed;
+}
+
+void OfflineExtractor::setFilterBank(FilterBank::Scale scale, float lowFrequency, float highFrequency,
+                                     FilterBank::Normalization normalization) {
+    m_filterScale = scale;
+    m_lowFrequency = lowFrequency;
+    m_highFrequency = highFrequency;
+    m_filterNormalization = normalization;
+}
+
+void OfflineExtractor::setCepstralOptions(int lifter, FrameKernel::EnergyTerm term) {
+    m_lifter = qMax(0, lifter);
+    m_energyTerm = term;
+}
+
+void OfflineExtractor::setSpectralDescriptors(int descriptors) {
+    m_descriptors = descriptors & SpectralDescriptors::AllDescriptors;
+}
+
+void OfflineExtractor::setPitchTracking(bool enabled, bool smoothed, float minFrequency, float maxFrequency) {
+    m_pitch = enabled;
+    m_pitchSmoothed = smoothed;
+    m_pitchMinFrequency = minFrequency;
+    m_pitchMaxFrequency = maxFrequency;
+}
+
+void OfflineExtractor::setDeltas(int order, int window) {
+    m_deltaOrder = qBound(0, order, 2);
+    m_deltaWindow = qMax(1, window);
+}
+
+void OfflineExtractor::setCmvn(bool enabled, Cmvn::Mode mode, bool normalizeVariance, const QString &statsFileName,
+                               int windowSize) {
+    m_cmvn = enabled;
+    m_cmvnMode = mode;
+    m_cmvnVariance = normalizeVariance;
+    m_cmvnStatsFileName = statsFileName;
+    m_cmvnWindow = windowSize;
+}
+
+int OfflineExtractor::coefsCount() const {
+    return (1 + m_deltaOrder) * staticsCount();
+}
+
+int OfflineExtractor::staticsCount() const {
+    // základní frekvence a znělost
+    return m_coefsCount + SpectralDescriptors::countOf(m_descriptors) + (m_pitch ? 2 : 0);
+}
+
+int OfflineExtractor::sampleRate() const {
+    return m_sampleRate;
+}
+
+qint64 OfflineExtractor::samplesCount() const {
+    return m_samplesCount;
+}
+
+qint64 OfflineExtractor::framesCount() const {
+    return m_framesCount;
+}
+
+qint64 OfflineExtractor::countFrames(const QString &audioFileName) {
+    if (m_segmentSize == 0)
+        return UNDEFINED;
+
+    QFile file(audioFileName);
+    const uchar *data;
+    qint64 offset, bytes;
+    int sampleRate, channels;
+
+    if (!mapFile(&file, &data, &offset, &bytes, &sampleRate, &channels))
+        return UNDEFINED;
+
+    return framesFor(bytes / (static_cast<qint64>(sizeof(sample)) * channels));
+}
+
+QVector<float> OfflineExtractor::extract(const QString &audioFileName) {
+    QVector<float> coefs;
+
+    if (run(audioFileName, TensorView(), &coefs) == UNDEFINED)
+        return QVector<float>();
+
+    return coefs;
+}
+
+qint64 OfflineExtractor::extract(const QString &audioFileName, const TensorView &output) {
+    if (output.isNull() || output.features() != coefsCount()) {
+        emit error("OfflineExtractor::extract: Výstupní matice nemá coefsCount() prvků na segment.");
+        return UNDEFINED;
+    }
+
+    return run(audioFileName, output, nullptr);
+}
+
+QVector<qint64> OfflineExtractor::extractBatch(const QStringList &audioFileNames, float *batch, int frames,
+                                               TensorView::Layout layout) {
+    QVector<qint64> lengths;
+    lengths.reserve(audioFileNames.size());
+
+    for (int i = 0; i < audioFileNames.size(); i++) {
+        qint64 length = extract(audioFileNames[i], TensorView::batchItem(batch, i, frames, coefsCount(), layout));
+        if (length == UNDEFINED)
+            return QVector<qint64>();
+
+        lengths.append(length);
+    }
+
+    return lengths;
+}
+
+qint64 OfflineExtractor::framesFor(qint64 samplesCount) const {
+    if (samplesCount == 0)
+        return 0;
+
+    if (samplesCount <= m_segmentSize)
+        return 1;
+
+    return 1 + (samplesCount - m_segmentSize + m_hop - 1) / m_hop;
+}
+
+bool OfflineExtractor::mapFile(QFile *file, const uchar **data, qint64 *offset, qint64 *bytes, int *sampleRate,
+                               int *channels) {
+    if (!file->open(QFile::ReadOnly)) {
+        emit error("OfflineExtractor::extract: Soubor " + file->fileName() + " nelze otevřít.");
+        return false;
+    }
+
+    qint64 size = file->size();
+    *data = (size > 0) ? file->map(0, size) : nullptr;
+    if (!*data) {
+        emit error("OfflineExtractor::extract: Soubor " + file->fileName() + " nelze namapovat do paměti.");
+        return false;
+    }
+
+    return parseHeader(*data, size, offset, bytes, sampleRate, channels);
+}
+
+qint64 OfflineExtractor::run(const QString &audioFileName, const TensorView &output, QVector<float> *coefs) {
+    m_sampleRate = 0;
+    m_samplesCount = 0;
+    m_framesCount = 0;
+
+    if (m_segmentSize == 0)
+        return UNDEFINED;
+
+    QFile file(audioFileName);
+    const uchar *data;
+    qint64 offset, bytes;
+    int sampleRate, channels;
+
+    if (!mapFile(&file, &data, &offset, &bytes, &sampleRate, &channels))
+        return UNDEFINED;
+
+    ExtractionJob job;
+    job.samples = reinterpret_cast<const sample *>(data + offset);
+    job.samplesCount = bytes / (static_cast<qint64>(sizeof(sample)) * channels);
+    job.channels = channels;
+    job.segmentSize = m_segmentSize;
+    job.hop = m_hop;
+    job.sampleRate = sampleRate;
+    job.filtersCount = m_filtersCount;
+    job.coefsCount = m_coefsCount;
+    job.fftPolicy = m_fftPolicy;
+    job.preEmphasis = m_preEmphasis;
+    job.ditherAmplitude = m_ditherAmplitude;
+    job.ditherSeed = m_ditherSeed;
+    job.lifter = m_lifter;
+    job.energyTerm = m_energyTerm;
+    job.descriptors = m_descriptors;
+    job.pitch = m_pitch;
+    job.pitchMinFrequency = m_pitchMinFrequency;
+    job.pitchMaxFrequency = m_pitchMaxFrequency;
+    job.filters = FilterBank((FFT::fftSizeFor(m_segmentSize, m_fftPolicy) / 2) + 1, m_filtersCount, sampleRate,
+                             m_filterScale, m_lowFrequency, m_highFrequency, m_filterNormalization);
+
+    if (!job.filters.isValid()) {
+        emit error("OfflineExtractor::extract: Neplatné mezní frekvence banky filtrů pro soubor " + audioFileName + ".");
+        return UNDEFINED;
+    }
+
+    /* Vyhlazení probíhá po dokončení všech bloků, tento objekt slouží jen ke kontrole parametrů a k vyhlazení. */
+    PitchTracker tracker(m_segmentSize, sampleRate, m_pitchMinFrequency, m_pitchMaxFrequency);
+    if (m_pitch && !tracker.isValid()) {
+        emit error("OfflineExtractor::extract: Neplatný rozsah základní frekvence pro soubor " + audioFileName + ".");
+        return UNDEFINED;
+    }
+
+    /* Statistiky režimu Global jsou načteny ještě před výpočtem, aby chybný soubor statistik nic nestál. */
+    Cmvn cmvn(m_coefsCount, m_cmvnMode, m_cmvnVariance, m_cmvnWindow);
+    connect(&cmvn, &Cmvn::error, this, &OfflineExtractor::error);
+
+    if (m_cmvn && m_cmvnMode == Cmvn::Global && !cmvn.loadStats(m_cmvnStatsFileName))
+        return UNDEFINED;
+
+    job.framesCount = framesFor(job.samplesCount);
+    job.chunkSize = m_chunkSize;
+    job.chunksCount = static_cast<int>((job.framesCount + m_chunkSize - 1) / m_chunkSize);
+    job.nextChunk.store(0);
+
+    /* Bez matice volajícího je výstup alokován jako souvislá matice frames x coefsCount. */
+    TensorView matrix = output;
+    if (coefs) {
+        coefs->resize(static_cast<int>(job.framesCount * coefsCount()));
+        matrix = TensorView::frameMajor(coefs->data(), static_cast<int>(job.framesCount), coefsCount());
+    }
+    else if (job.framesCount > output.frames()) {
+        emit error("OfflineExtractor::extract: Soubor " + audioFileName + " má více segmentů, než pojme výstupní matice.");
+        return UNDEFINED;
+    }
+
+    /* FrameKernel zapisuje jen koeficienty a deskriptory, základní frekvence je zapsána až po vyhlazení. */
+    const int pitchColumns = m_pitch ? 2 : 0;
+    job.output = TensorView(matrix.data(), matrix.frames(), staticsCount() - pitchColumns, matrix.frameStride(),
+                            matrix.featureStride());
+
+    QVector<PitchTracker::Estimate> estimates(m_pitch ? static_cast<int>(job.framesCount) : 0);
+    QVector<PitchTracker::Candidate> candidates(estimates.size() * PITCH_CANDIDATES);
+    job.estimates = estimates.data();
+    job.candidates = candidates.data();
+
+    QThreadPool pool;
+    int workers = qMin(m_threads, job.chunksCount);
+    pool.setMaxThreadCount(qMax(1, workers));
+
+    for (int i = 0; i < workers; i++)
+        pool.start(new ExtractionWorker(&job));
+
+    pool.waitForDone();
+
+    if (m_pitch) {
+        if (m_pitchSmoothed)
+            tracker.smooth(estimates.data(), candidates.constData(), estimates.size());
+
+        TensorView pitch(matrix.data() + job.output.features() * matrix.featureStride(), matrix.frames(), pitchColumns,
+                         matrix.frameStride(), matrix.featureStride());
+
+        for (int frame = 0; frame < estimates.size(); frame++) {
+            const float values[2] = {estimates[frame].frequency, estimates[frame].voicing};
+            pitch.store(frame, values);
+        }
+    }
+
+    /* Normalizace potřebuje statistiky celého souboru (Utterance), resp. segmenty v pořadí (Sliding). */
+    if (m_cmvn && job.framesCount > 0) {
+        TensorView coefsView(matrix.data(), static_cast<int>(job.framesCount), m_coefsCount, matrix.frameStride(),
+                             matrix.featureStride());
+
+        if (!cmvn.normalize(coefsView))
+            return UNDEFINED;
+    }
+
+    /* Dynamické koeficienty potřebují sousední segmenty z jiných bloků, jsou proto počítány až nad celou maticí. */
+    if (m_deltaOrder > 0 && job.framesCount > 0) {
+        DeltaFeatures deltas(staticsCount(), m_deltaWindow);
+        connect(&deltas, &DeltaFeatures::error, this, &OfflineExtractor::error);
+
+        if (!deltas.calculate(matrix.mid(0, static_cast<int>(job.framesCount)), m_deltaOrder))
+            return UNDEFINED;
+    }
+
+    // doplnění kratšího proudu v dávce
+    matrix.fill(static_cast<int>(job.framesCount), matrix.frames());
+
+    m_sampleRate = sampleRate;
+    m_samplesCount = job.samplesCount;
+    m_framesCount = job.framesCount;
+    return job.framesCount;
+}
+
+bool OfflineExtractor::extract(const QString &audioFileName, const QString &mfccFileName) {
+    if (coefsCount() != MFCC_COUNT) {
+        emit error("OfflineExtractor::extract: Soubor MFCC vyžaduje MFCC_COUNT koeficientů.");
+        return false;
+    }
+
+    QVector<float> coefs = extract(audioFileName);
+    if (coefs.isEmpty()) {
+        emptyFileError(audioFileName);
+        return false;
+    }
+
+    MfccFile mfccFile(mfccFileName);
+    if (!mfccFile.write(coefs.constData(), coefs.size() / coefsCount())) {
+        emit error("OfflineExtractor::extract: Do souboru " + mfccFileName + " nelze zapisovat.");
+        return false;
+    }
+
+    return true;
+}
+
+bool OfflineExtractor::extractHtk(const QString &audioFileName, const QString &htkFileName) {
+    QVector<float> coefs = extract(audioFileName);
+    if (coefs.isEmpty()) {
+        emptyFileError(audioFileName);
+        return false;
+    }
+
+    // deskriptory a základní frekvence za energií by HTK četlo jako koeficienty, vektory s nimi jsou proto USER
+    int kind = HtkFile::User;
+    bool cepstral = m_descriptors == 0 && !m_pitch;
+    if (cepstral && m_energyTerm == FrameKernel::TrailingLogEnergy)
+        kind = HtkFile::Mfcc | HtkFile::Energy;
+    else if (cepstral && m_energyTerm == FrameKernel::TrailingC0)
+        kind = HtkFile::Mfcc | HtkFile::ZerothCepstral;
+
+    if (m_deltaOrder >= 1)
+        kind |= HtkFile::Delta;
+    if (m_deltaOrder >= 2)
+        kind |= HtkFile::Acceleration;
+
+    HtkFile htkFile(htkFileName);
+    if (!htkFile.write(coefs.constData(), coefs.size() / coefsCount(), coefsCount(),
+                       HtkFile::samplePeriodFor(m_hop, m_sampleRate), kind)) {
+        emit error("OfflineExtractor::extractHtk: Do souboru " + htkFileName + " nelze zapisovat.");
+        return false;
+    }
+
+    return true;
+}
+
+void OfflineExtractor::emptyFileError(const QString &audioFileName) {
+    // sampleRate() je nastavena jen po úspěšném výpočtu, jinak byl signál error již emitován
+    if (m_sampleRate > 0 && m_framesCount == 0)
+        emit error("OfflineExtractor::extract: Soubor " + audioFileName + " neobsahuje žádné vzorky (0 segmentů).");
+}
+
+bool OfflineExtractor::parseHeader(const uchar *data, qint64 size, qint64 *offset, qint64 *bytes, int *sampleRate, int *channels) {
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+        /* Surová data bez hlavičky. */
+        if (m_rawSampleRate <= 0 || m_rawChannels <= 0) {
+            emit error("OfflineExtractor::parseHeader: Formát surových dat není nastaven (setRawFormat).");
+            return false;
+        }
+
+        *offset = 0;
+        *bytes = size;
+        *sampleRate = m_rawSampleRate;
+        *channels = m_rawChannels;
+        return true;
+    }
+
+    bool hasFormat = false;
+    qint64 position = 12;
+
+    while (position + 8 <= size) {
+        const uchar *chunk = data + position;
+        qint64 chunkSize = qFromLittleEndian<quint32>(chunk + 4);
+        const uchar *body = chunk + 8;
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && position + 8 + 16 <= size) {
+            quint16 format = qFromLittleEndian<quint16>(body);
+            quint16 bits = qFromLittleEndian<quint16>(body + 14);
+
+            // WAVE_FORMAT_EXTENSIBLE nese skutečný formát v prvních 2 B GUID podformátu
+            if (format == 0xFFFE && chunkSize >= 40 && position + 8 + 40 <= size)
+                format = qFromLittleEndian<quint16>(body + 24);
+
+            if (format != 1 || bits != 16) {
+                emit error("OfflineExtractor::parseHeader: Podporován je pouze 16bitový PCM WAV.");
+                return false;
+            }
+
+            *channels = qFromLittleEndian<quint16>(body + 2);
+            *sampleRate = static_cast<int>(qFromLittleEndian<quint32>(body + 4));
+            hasFormat = *channels > 0 && *sampleRate > 0;
+        }
+        else if (memcmp(chunk, "data", 4) == 0) {
+            if (!hasFormat)
+                break;
+
+            *offset = position + 8;
+
+            // délka 0 nebo přesahující soubor (nedokončený zápis): data sahají do konce souboru
+            qint64 available = size - *offset;
+            *bytes = (chunkSize == 0 || chunkSize > available) ? available : chunkSize;
+
+            if (*offset % static_cast<qint64>(sizeof(sample)) != 0) {
+                emit error("OfflineExtractor::parseHeader: Vzorky souboru WAV nejsou zarovnány.");
+                return false;
+            }
+
+            return true;
+        }
+
+        position += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    emit error("OfflineExtractor::parseHeader: Soubor WAV neobsahuje platné bloky fmt a data.");
+    return false;
+}
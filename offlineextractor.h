@@ -0,0 +1,331 @@
+#ifndef OFFLINEEXTRACTOR_H
+#define OFFLINEEXTRACTOR_H
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QFile>
+
+#include "pe_config.h"
+#include "framekernel.h"
+#include "mfccfile.h"
+#include "htkfile.h"
+#include "pitchtracker.h"
+#include "deltafeatures.h"
+#include "cmvn.h"
+#include "tensorview.h"
+
+/*!
+ * \brief Třída OfflineExtractor
+ *
+ * Třída počítá MFC koeficienty celých zvukových souborů (WAV nebo surové PCM). Soubor není načítán do paměti,
+ * ale je namapován (QFile::map) a segmenty jsou předávány výpočtu (FrameKernel) přímo jako ukazatele do
+ * namapovaných stránek, bez mezilehlých kopií. Kopie do pracovního bufferu vzniká pouze u posledního neúplného
+ * segmentu (doplnění nulami) a u vícekanálových souborů, které jsou po segmentech smíchány do mono.
+ *
+ * Segmenty jsou rozmístěny stejně jako u třídy AudioSegmenter (posun segmentSize - overlap, poslední neúplný segment
+ * je doplněn nulami). Výpočet je rozdělen na bloky po chunkSize segmentech, které jsou zpracovávány paralelně
+ * ve vláknech QThreadPool. Protože každý segment čte data přímo z celého namapovaného souboru, segmenty na hranicích
+ * bloků obsahují správný překryv a výsledek nezávisí na počtu vláken ani velikosti bloku.
+ *
+ * Koeficienty lze zapisovat přímo do matice volajícího (TensorView) v libovolném rozložení, případně do dávky
+ * více souborů doplněných na stejný počet segmentů (extractBatch), bez mezilehlého pole a přeskládání.
+ *
+ * Podporovány jsou soubory WAV s 16bitovým PCM (včetně WAVE_FORMAT_EXTENSIBLE) a surová 16bitová PCM data
+ * s malým endianem, jejichž frekvenci vzorkování a počet kanálů je nutné nastavit metodou setRawFormat.
+ */
+class OfflineExtractor : public QObject {
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief OfflineExtractor Konstruktor třídy.
+     * \param segmentSize Počet vzorků segmentu.
+     * \param overlap Překryv segmentů.
+     * \param filtersCount Počet filtrů banky melovských filtrů.
+     * \param coefsCount Počet počítaných MFC koeficientů (pro zápis do MfccFile musí být MFCC_COUNT).
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolnění).
+     */
+    explicit OfflineExtractor(int segmentSize, int overlap, int filtersCount, int coefsCount, QObject *parent = nullptr);
+
+    /*!
+     * \brief setRawFormat Nastaví formát souborů bez hlavičky (soubory, které nezačínají hlavičkou RIFF/WAVE).
+     * \param sampleRate Frekvence vzorkování.
+     * \param channels Počet prokládaných kanálů.
+     */
+    void setRawFormat(int sampleRate, int channels = 1);
+
+    /*!
+     * \brief setThreadCount Nastaví počet vláken výpočtu (výchozí QThread::idealThreadCount()).
+     * \param threads Počet vláken.
+     */
+    void setThreadCount(int threads);
+
+    /*!
+     * \brief setChunkSize Nastaví počet segmentů jednoho paralelně zpracovávaného bloku (výchozí 2048).
+     * \param frames Počet segmentů bloku.
+     */
+    void setChunkSize(int frames);
+
+    /*!
+     * \brief setFftSizePolicy Nastaví strategii výběru velikosti transformace (výchozí FFT::PowerOfTwo).
+     * \param policy Strategie výběru velikosti transformace (viz FFT::SizePolicy).
+     */
+    void setFftSizePolicy(FFT::SizePolicy policy);
+
+    /*!
+     * \brief setPreEmphasis Nastaví preemfázi a dither (viz PreEmphasis, výchozí jsou vypnuté). Výsledek nezávisí
+     *                       na počtu vláken ani velikosti bloků.
+     * \param coefficient Koeficient preemfáze (0 až 1, 0 preemfázi vypíná).
+     * \param ditherAmplitude Amplituda ditheru ve vzorcích (0 dither vypíná).
+     * \param ditherSeed Semínko generátoru ditheru.
+     */
+    void setPreEmphasis(float coefficient, float ditherAmplitude = 0.0f, quint32 ditherSeed = 0);
+
+    /*!
+     * \brief setFilterBank Nastaví banku filtrů (výchozí je FilterBank::LegacyMel). Banka je vytvořena pro frekvenci
+     *                      vzorkování každého souboru, horní mezní frekvence proto nesmí překročit jeho Nyquistovu
+     *                      frekvenci (jinak extrakce souboru skončí chybou).
+     * \param scale Frekvenční stupnice a tvar filtrů.
+     * \param lowFrequency Dolní mezní frekvence v Hz.
+     * \param highFrequency Horní mezní frekvence v Hz (FILTERBANK_NYQUIST pro Nyquistovu frekvenci).
+     * \param normalization Normalizace vah filtrů.
+     */
+    void setFilterBank(FilterBank::Scale scale, float lowFrequency = 0.0f, float highFrequency = FILTERBANK_NYQUIST,
+                       FilterBank::Normalization normalization = FilterBank::NoNormalization);
+
+    /*!
+     * \brief setCepstralOptions Nastaví sinusový lifter a energetický člen vektorů (viz FrameKernel::setLifter
+     *                           a FrameKernel::setEnergyTerm, výchozí bez lifteru a s c0 na začátku).
+     * \param lifter Parametr lifteru (0 lifter vypíná, HTK a Kaldi obvykle 22).
+     * \param term Pořadí koeficientů a energetický člen.
+     */
+    void setCepstralOptions(int lifter, FrameKernel::EnergyTerm term = FrameKernel::LeadingC0);
+
+    /*!
+     * \brief setSpectralDescriptors Nastaví spektrální deskriptory připojené za koeficienty každého vektoru (viz
+     *                              SpectralDescriptors, výchozí žádné). Výstupní vektory pak mají coefsCount() prvků
+     *                              včetně deskriptorů a nelze je zapsat do MfccFile. Flux prvního segmentu každého
+     *                              bloku je počítán od předchozího segmentu souboru (jeho spektrum je spočítáno
+     *                              znovu), výsledek tedy nezávisí na počtu vláken ani velikosti bloků.
+     * \param descriptors Kombinace příznaků SpectralDescriptors::Descriptor (0 deskriptory vypíná).
+     */
+    void setSpectralDescriptors(int descriptors);
+
+    /*!
+     * \brief setPitchTracking Zapne odhad základní frekvence (viz PitchTracker, výchozí vypnutý). Za koeficienty
+     *                         a deskriptory každého vektoru jsou pak připojeny dva prvky: základní frekvence v Hz
+     *                         (0 u neznělého segmentu) a znělost (0 až 1). Odhad je počítán ze stejných segmentů
+     *                         jako koeficienty (bez preemfáze), vyhlazení Viterbiho algoritmem probíhá přes celý
+     *                         soubor po dokončení všech bloků.
+     * \param enabled True pro zapnutí odhadu.
+     * \param smoothed True, pokud mají být odhady vyhlazeny.
+     * \param minFrequency Nejnižší hledaná základní frekvence v Hz.
+     * \param maxFrequency Nejvyšší hledaná základní frekvence v Hz.
+     */
+    void setPitchTracking(bool enabled, bool smoothed = true, float minFrequency = PITCH_MIN_FREQUENCY,
+                          float maxFrequency = PITCH_MAX_FREQUENCY);
+
+    /*!
+     * \brief setDeltas Nastaví dynamické koeficienty (viz DeltaFeatures, výchozí žádné). Za statické prvky vektoru
+     *                  (koeficienty, deskriptory a základní frekvenci) jsou připojeny jejich delta, případně
+     *                  i delta-delta koeficienty v rozložení HTK _D a _A. Počítány jsou přes celý soubor po
+     *                  dokončení všech bloků, výsledek tedy nezávisí na počtu vláken ani velikosti bloků.
+     * \param order Řád dynamických koeficientů (0 vypíná, 1 delta, 2 delta a delta-delta).
+     * \param window Poloviční šířka regresního okna N.
+     */
+    void setDeltas(int order, int window = 2);
+
+    /*!
+     * \brief setCmvn Nastaví normalizaci střední hodnoty a rozptylu MFC koeficientů (viz Cmvn, výchozí vypnutá).
+     *                Normalizovány jsou jen koeficienty (ne deskriptory a základní frekvence), a to nad celou
+     *                maticí souboru po dokončení všech bloků a před výpočtem dynamických koeficientů. Statistiky
+     *                režimu Global jsou načteny ze souboru při zpracování každého souboru.
+     * \param enabled True pro zapnutí normalizace.
+     * \param mode Způsob získání statistik (Utterance pro celý soubor, Global ze souboru statistik, Sliding).
+     * \param normalizeVariance True, pokud mají být koeficienty děleny směrodatnou odchylkou.
+     * \param statsFileName Cesta k souboru statistik (viz Cmvn::saveStats, pouze režim Global).
+     * \param windowSize Počet vektorů klouzavého okna (pouze režim Sliding).
+     */
+    void setCmvn(bool enabled, Cmvn::Mode mode = Cmvn::Utterance, bool normalizeVariance = true,
+                 const QString &statsFileName = QString(), int windowSize = 300);
+
+    /*!
+     * \brief coefsCount Vrací počet koeficientů jednoho výstupního vektoru (včetně spektrálních deskriptorů,
+     *                   základní frekvence se znělostí a dynamických koeficientů).
+     * \return Počet koeficientů.
+     */
+    int coefsCount() const;
+
+    /*!
+     * \brief sampleRate Vrací frekvenci vzorkování naposledy zpracovaného souboru.
+     * \return Frekvence vzorkování.
+     */
+    int sampleRate() const;
+
+    /*!
+     * \brief samplesCount Vrací počet vzorků (jednoho kanálu) naposledy zpracovaného souboru.
+     * \return Počet vzorků.
+     */
+    qint64 samplesCount() const;
+
+    /*!
+     * \brief framesCount Vrací počet segmentů (vektorů koeficientů) naposledy zpracovaného souboru.
+     * \return Počet segmentů.
+     */
+    qint64 framesCount() const;
+
+    /*!
+     * \brief extract Vypočítá MFC koeficienty zvukového souboru.
+     * \param audioFileName Cesta ke zvukovému souboru.
+     * \return Souvislá matice koeficientů (vektory po coefsCount() koeficientech za sebou) nebo prázdný vektor při chybě
+     *         a u souboru bez vzorků (framesCount() je pak 0).
+     */
+    QVector<float> extract(const QString &audioFileName);
+
+    /*!
+     * \brief extract Přetížená metoda, která koeficienty zapíše přímo do matice volajícího. Segmenty za koncem
+     *                souboru (do output.frames()) jsou vyplněny nulami.
+     * \param audioFileName Cesta ke zvukovému souboru.
+     * \param output Výstupní matice s coefsCount() prvky na segment a alespoň countFrames() segmenty.
+     * \return Počet zapsaných segmentů nebo UNDEFINED při chybě.
+     */
+    qint64 extract(const QString &audioFileName, const TensorView &output);
+
+    /*!
+     * \brief extractBatch Vypočítá koeficienty více souborů do souvislé dávky batch x frames x coefsCount()
+     *                     (FrameMajor), resp. batch x coefsCount() x frames (CoefficientMajor). Kratší soubory jsou
+     *                     doplněny nulami, počet segmentů dávky je vhodné určit jako největší countFrames() souborů.
+     * \param audioFileNames Cesty ke zvukovým souborům (jeden proud dávky na soubor).
+     * \param batch Ukazatel na audioFileNames.size() * frames * coefsCount() prvků.
+     * \param frames Počet segmentů každého proudu dávky.
+     * \param layout Rozložení matice jednoho proudu.
+     * \return Skutečné počty segmentů jednotlivých souborů nebo prázdný vektor při chybě.
+     */
+    QVector<qint64> extractBatch(const QStringList &audioFileNames, float *batch, int frames,
+                                 TensorView::Layout layout = TensorView::FrameMajor);
+
+    /*!
+     * \brief countFrames Zjistí počet segmentů souboru bez výpočtu (přečte pouze hlavičku), např. pro alokaci matice.
+     * \param audioFileName Cesta ke zvukovému souboru.
+     * \return Počet segmentů nebo UNDEFINED při chybě.
+     */
+    qint64 countFrames(const QString &audioFileName);
+
+    /*!
+     * \brief extract Přetížená metoda, která vypočtené koeficienty zapíše do MFCC souboru.
+     * \param audioFileName Cesta ke zvukovému souboru.
+     * \param mfccFileName Cesta k výstupnímu MFCC souboru.
+     * \return True, pokud výpočet i zápis proběhly, jinak false (i u souboru bez vzorků, který nelze zapsat).
+     */
+    bool extract(const QString &audioFileName, const QString &mfccFileName);
+
+    /*!
+     * \brief extractHtk Vypočítá koeficienty a zapíše je do souboru parametrů HTK (libovolný počet koeficientů).
+     *                   Druh parametrů odpovídá energetickému členu: MFCC_E pro TrailingLogEnergy, MFCC_0 pro
+     *                   TrailingC0 (obojí jen bez spektrálních deskriptorů a základní frekvence), jinak USER (HTK
+     *                   očekává c0 i energii na konci vektoru), s kvalifikátory _D a _A podle řádu dynamických
+     *                   koeficientů. Perioda vektorů je určena posunem segmentů a frekvencí vzorkování souboru.
+     * \param audioFileName Cesta ke zvukovému souboru.
+     * \param htkFileName Cesta k výstupnímu souboru HTK.
+     * \return True, pokud výpočet i zápis proběhly, jinak false (i u souboru bez vzorků, který nelze zapsat).
+     */
+    bool extractHtk(const QString &audioFileName, const QString &htkFileName);
+
+private:
+    int m_segmentSize;          //!< Počet vzorků segmentu.
+    int m_hop;                  //!< Posun segmentů (segmentSize - overlap).
+    int m_filtersCount;         //!< Počet filtrů banky melovských filtrů.
+    int m_coefsCount;           //!< Počet počítaných MFC koeficientů.
+    int m_rawSampleRate;        //!< Frekvence vzorkování surových souborů.
+    int m_rawChannels;          //!< Počet kanálů surových souborů.
+    int m_threads;              //!< Počet vláken výpočtu.
+    int m_chunkSize;            //!< Počet segmentů jednoho bloku.
+    FFT::SizePolicy m_fftPolicy;//!< Strategie výběru velikosti transformace.
+    float m_preEmphasis;        //!< Koeficient preemfáze (0 = vypnutá).
+    float m_ditherAmplitude;    //!< Amplituda ditheru (0 = vypnutý).
+    quint32 m_ditherSeed;       //!< Semínko generátoru ditheru.
+    FilterBank::Scale m_filterScale;                //!< Stupnice banky filtrů.
+    float m_lowFrequency;                           //!< Dolní mezní frekvence banky filtrů.
+    float m_highFrequency;                          //!< Horní mezní frekvence banky filtrů.
+    FilterBank::Normalization m_filterNormalization;//!< Normalizace vah banky filtrů.
+    int m_lifter;                                   //!< Parametr sinusového lifteru (0 = vypnutý).
+    FrameKernel::EnergyTerm m_energyTerm;           //!< Pořadí koeficientů a energetický člen.
+    int m_descriptors;                              //!< Příznaky spektrálních deskriptorů (0 = žádné).
+    bool m_pitch;                                   //!< True, pokud je počítána základní frekvence.
+    bool m_pitchSmoothed;                           //!< True, pokud jsou odhady základní frekvence vyhlazeny.
+    float m_pitchMinFrequency;                      //!< Nejnižší hledaná základní frekvence.
+    float m_pitchMaxFrequency;                      //!< Nejvyšší hledaná základní frekvence.
+    int m_deltaOrder;                               //!< Řád dynamických koeficientů (0 = žádné).
+    int m_deltaWindow;                              //!< Poloviční šířka regresního okna dynamických koeficientů.
+    bool m_cmvn;                                    //!< True, pokud jsou koeficienty normalizovány.
+    Cmvn::Mode m_cmvnMode;                          //!< Způsob získání statistik normalizace.
+    bool m_cmvnVariance;                            //!< True, pokud se normalizuje i rozptyl.
+    QString m_cmvnStatsFileName;                    //!< Soubor statistik normalizace (režim Global).
+    int m_cmvnWindow;                               //!< Počet vektorů klouzavého okna normalizace.
+    int m_sampleRate;           //!< Frekvence vzorkování naposledy zpracovaného souboru.
+    qint64 m_samplesCount;      //!< Počet vzorků naposledy zpracovaného souboru.
+    qint64 m_framesCount;       //!< Počet segmentů naposledy zpracovaného souboru.
+
+    /*!
+     * \brief run Vypočítá koeficienty souboru do dané matice, nebo (pokud je coefs zadán) do nově alokovaného vektoru.
+     * \param audioFileName Cesta ke zvukovému souboru.
+     * \param output Výstupní matice (ignorována, pokud je coefs zadán).
+     * \param coefs Ukazatel na vektor pro souvislou matici frames x coefsCount() nebo nullptr.
+     * \return Počet segmentů souboru nebo UNDEFINED při chybě.
+     */
+    qint64 run(const QString &audioFileName, const TensorView &output, QVector<float> *coefs);
+
+    /*!
+     * \brief staticsCount Vrací počet statických prvků výstupního vektoru (bez dynamických koeficientů).
+     * \return Počet statických prvků.
+     */
+    int staticsCount() const;
+
+    /*!
+     * \brief emptyFileError Emituje signál error, pokud byl naposledy zpracovaný soubor bez chyby, ale bez segmentů.
+     * \param audioFileName Cesta ke zvukovému souboru.
+     */
+    void emptyFileError(const QString &audioFileName);
+
+    /*!
+     * \brief framesFor Vrací počet segmentů signálu o daném počtu vzorků.
+     * \param samplesCount Počet vzorků jednoho kanálu.
+     * \return Počet segmentů.
+     */
+    qint64 framesFor(qint64 samplesCount) const;
+
+    /*!
+     * \brief mapFile Otevře a namapuje soubor a rozpozná jeho formát (viz parseHeader).
+     * \param file Ukazatel na soubor s nastavenou cestou (zůstává otevřený po dobu použití dat).
+     * \param data Výstupní parametr, ukazatel na začátek namapovaného souboru.
+     * \param offset Výstupní parametr, pozice prvního vzorku v bytech.
+     * \param bytes Výstupní parametr, velikost vzorků v bytech.
+     * \param sampleRate Výstupní parametr, frekvence vzorkování.
+     * \param channels Výstupní parametr, počet kanálů.
+     * \return True, pokud je soubor čitelný a formát podporován, jinak false (a je emitován signál error).
+     */
+    bool mapFile(QFile *file, const uchar **data, qint64 *offset, qint64 *bytes, int *sampleRate, int *channels);
+
+    /*!
+     * \brief parseHeader Rozpozná formát namapovaného souboru a najde začátek vzorků.
+     * \param data Ukazatel na začátek namapovaného souboru.
+     * \param size Velikost souboru v bytech.
+     * \param offset Výstupní parametr, pozice prvního vzorku v bytech.
+     * \param bytes Výstupní parametr, velikost vzorků v bytech.
+     * \param sampleRate Výstupní parametr, frekvence vzorkování.
+     * \param channels Výstupní parametr, počet kanálů.
+     * \return True, pokud je formát podporován, jinak false (a je emitován signál error).
+     */
+    bool parseHeader(const uchar *data, qint64 size, qint64 *offset, qint64 *bytes, int *sampleRate, int *channels);
+
+signals:
+    /*!
+     * \brief error Signál, který je emitován při chybě.
+     * \param message Popis chyby.
+     */
+    void error(QString message);
+};
+
+#endif
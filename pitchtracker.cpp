@@ -0,0 +1,261 @@
+#include "pitchtracker.h"
+#include "windowtable.h"
+
+#include <QtMath>
+
+#include <algorithm>
+#include <limits>
+
+PitchTracker::PitchTracker(int segmentSize, int sampleRate, float minFrequency, float maxFrequency, QObject *parent)
+        : QObject(parent), m_fft(2 * qMax(1, segmentSize)) {
+    m_segmentSize = segmentSize;
+    m_sampleRate = sampleRate;
+    m_minLag = m_maxLag = 0;
+    m_voicingThreshold = PITCH_VOICING_THRESHOLD;
+    m_octaveJumpCost = PITCH_OCTAVE_JUMP_COST;
+    m_voicedUnvoicedCost = PITCH_VOICED_UNVOICED_COST;
+    m_silenceEnergy = 32768.0f * 32768.0f * qPow(10.0f, PITCH_SILENCE_THRESHOLD / 10.0f);
+    m_window = nullptr;
+
+    connect(&m_fft, &FFT::error, this, &PitchTracker::error);
+
+    if (segmentSize < 8 || sampleRate <= 0 || !(minFrequency > 0.0f) || !(maxFrequency > minFrequency)) {
+        emit error("PitchTracker::PitchTracker: Neplatné parametry odhadu základní frekvence.");
+        return;
+    }
+
+    /* Perioda nejvýše polovina segmentu, delší periody mají v segmentu méně než dvě opakování. */
+    int minLag = qMax(2, qFloor(sampleRate / maxFrequency));
+    int maxLag = qMin(segmentSize / 2, qCeil(sampleRate / minFrequency));
+
+    if (maxLag <= minLag + 1) {
+        emit error("PitchTracker::PitchTracker: Segment je příliš krátký pro daný rozsah frekvencí.");
+        return;
+    }
+
+    m_minLag = minLag;
+    m_maxLag = maxLag;
+    m_window = WindowTable::get(WindowTable::Hann, segmentSize);
+    m_frame.fill(0.0f, m_fft.fftSize());
+    m_spectrum.resize(m_fft.espdSize());
+
+    /* Autokorelace okna, kterou je dělena autokorelace segmentu (korekce útlumu oknem pro delší periody). */
+    std::copy(m_window, m_window + segmentSize, m_frame.begin());
+    autocorrelate();
+
+    m_windowCorrelation.resize(m_maxLag + 2);
+    for (int lag = 0; lag < m_windowCorrelation.size(); lag++)
+        m_windowCorrelation[lag] = m_frame[lag] / m_frame[0];
+}
+
+bool PitchTracker::isValid() const {
+    return m_maxLag > 0;
+}
+
+int PitchTracker::segmentSize() const {
+    return m_segmentSize;
+}
+
+float PitchTracker::minFrequency() const {
+    return isValid() ? static_cast<float>(m_sampleRate) / m_maxLag : 0.0f;
+}
+
+float PitchTracker::maxFrequency() const {
+    return isValid() ? static_cast<float>(m_sampleRate) / m_minLag : 0.0f;
+}
+
+bool PitchTracker::setVoicingThreshold(float threshold) {
+    if (!(threshold >= 0.0f && threshold <= 1.0f)) {
+        emit error("PitchTracker::setVoicingThreshold: Práh znělosti musí být v rozsahu 0 až 1.");
+        return false;
+    }
+
+    m_voicingThreshold = threshold;
+    return true;
+}
+
+bool PitchTracker::setPathCosts(float octaveJump, float voicedUnvoiced) {
+    if (!(octaveJump >= 0.0f) || !(voicedUnvoiced >= 0.0f)) {
+        emit error("PitchTracker::setPathCosts: Ceny přechodů nesmí být záporné.");
+        return false;
+    }
+
+    m_octaveJumpCost = octaveJump;
+    m_voicedUnvoicedCost = voicedUnvoiced;
+    return true;
+}
+
+PitchTracker::Estimate PitchTracker::estimate(const sample *segment, Candidate *candidates) {
+    Estimate result = {0.0f, 0.0f};
+    Candidate best[PITCH_CANDIDATES] = {};
+    float bestValue = 0.0f;
+
+    if (!segment || !isValid()) {
+        emit error("PitchTracker::estimate: Neplatný segment nebo parametry odhadu.");
+        return result;
+    }
+
+    /* Střední hodnota a energie (rozptyl) segmentu, tichý segment je neznělý bez kandidátů. */
+    qint64 sum = 0, energy = 0;
+    for (int i = 0; i < m_segmentSize; i++) {
+        sum += segment[i];
+        energy += static_cast<qint32>(segment[i]) * segment[i];
+    }
+
+    const float mean = static_cast<float>(sum) / m_segmentSize;
+    const float variance = static_cast<float>(energy) / m_segmentSize - mean * mean;
+
+    if (variance >= m_silenceEnergy) {
+        float *frame = m_frame.data();
+
+        for (int i = 0; i < m_segmentSize; i++)
+            frame[i] = (segment[i] - mean) * m_window[i];
+        std::fill(frame + m_segmentSize, frame + m_frame.size(), 0.0f);
+
+        autocorrelate();
+
+        /* Normalizovaná autokorelace r(lag) = a(lag) / (a(0) * w(lag)), maxima jsou zpřesněna parabolou. */
+        const float *window = m_windowCorrelation.constData();
+        const float scale = 1.0f / frame[0];
+        float previous = frame[m_minLag - 1] * scale / window[m_minLag - 1];
+        float current = frame[m_minLag] * scale / window[m_minLag];
+
+        for (int lag = m_minLag; lag <= m_maxLag; lag++) {
+            const float next = frame[lag + 1] * scale / window[lag + 1];
+
+            if (current > 0.0f && current > previous && current >= next) {
+                const float curvature = previous - 2.0f * current + next;
+                const float shift = (curvature < 0.0f) ? qBound(-0.5f, 0.5f * (previous - next) / curvature, 0.5f) : 0.0f;
+                const float value = current - 0.25f * (previous - next) * shift;
+                const float period = lag + shift;
+
+                // zvýhodnění kratších period (PITCH_OCTAVE_COST na oktávu) proti chybám o oktávu dolů
+                Candidate candidate = {m_sampleRate / period, value - PITCH_OCTAVE_COST * std::log2(period / m_maxLag)};
+
+                int position = PITCH_CANDIDATES;
+                while (position > 0 && (best[position - 1].frequency == 0.0f
+                                        || best[position - 1].strength < candidate.strength))
+                    position--;
+
+                if (position < PITCH_CANDIDATES) {
+                    std::copy_backward(best + position, best + PITCH_CANDIDATES - 1, best + PITCH_CANDIDATES);
+                    best[position] = candidate;
+                }
+
+                bestValue = qMax(bestValue, value);
+            }
+
+            previous = current;
+            current = next;
+        }
+    }
+
+    result.voicing = qBound(0.0f, bestValue, 1.0f);
+    result.frequency = (best[0].frequency > 0.0f && result.voicing >= m_voicingThreshold) ? best[0].frequency : 0.0f;
+
+    if (candidates)
+        std::copy(best, best + PITCH_CANDIDATES, candidates);
+
+    return result;
+}
+
+PitchTracker::Estimate PitchTracker::estimate(const QVector<sample> &segment) {
+    if (segment.size() != m_segmentSize) {
+        emit error("PitchTracker::estimate: Segment nemá segmentSize() vzorků.");
+        Estimate unvoiced = {0.0f, 0.0f};
+        return unvoiced;
+    }
+
+    return estimate(segment.constData());
+}
+
+void PitchTracker::smooth(Estimate *estimates, const Candidate *candidates, int frames) const {
+    if (!estimates || !candidates || frames <= 0)
+        return;
+
+    /* Stav 0 je neznělý (síla rovna prahu znělosti), stavy 1 až PITCH_CANDIDATES jsou kandidáti segmentu. */
+    const int states = PITCH_CANDIDATES + 1;
+    QVector<float> scores(states), nextScores(states);
+    QVector<quint8> backtrack(frames * states);
+
+    auto frequency = [&](int frame, int state) -> float {
+        return (state == 0) ? 0.0f : candidates[frame * PITCH_CANDIDATES + state - 1].frequency;
+    };
+
+    auto local = [&](int frame, int state) -> float {
+        if (state == 0)
+            return m_voicingThreshold;
+
+        const Candidate &candidate = candidates[frame * PITCH_CANDIDATES + state - 1];
+        return (candidate.frequency > 0.0f) ? candidate.strength : -std::numeric_limits<float>::infinity();
+    };
+
+    for (int s = 0; s < states; s++)
+        scores[s] = local(0, s);
+
+    for (int t = 1; t < frames; t++) {
+        for (int s = 0; s < states; s++) {
+            const float f = frequency(t, s);
+            float bestScore = -std::numeric_limits<float>::infinity();
+            int bestState = 0;
+
+            for (int p = 0; p < states; p++) {
+                const float g = frequency(t - 1, p);
+                float cost = 0.0f;
+
+                if ((f > 0.0f) != (g > 0.0f))
+                    cost = m_voicedUnvoicedCost;
+                else if (f > 0.0f)
+                    cost = m_octaveJumpCost * qAbs(std::log2(f / g));
+
+                if (scores[p] - cost > bestScore) {
+                    bestScore = scores[p] - cost;
+                    bestState = p;
+                }
+            }
+
+            nextScores[s] = bestScore + local(t, s);
+            backtrack[t * states + s] = static_cast<quint8>(bestState);
+        }
+
+        scores.swap(nextScores);
+    }
+
+    int state = static_cast<int>(std::max_element(scores.constBegin(), scores.constEnd()) - scores.constBegin());
+
+    for (int t = frames - 1; t >= 0; t--) {
+        estimates[t].frequency = frequency(t, state);
+        state = backtrack[t * states + state];
+    }
+}
+
+QVector<PitchTracker::Estimate> PitchTracker::track(const QVector<QVector<sample>> &segments, bool smoothed) {
+    QVector<Estimate> estimates(segments.size());
+    QVector<Candidate> candidates(segments.size() * PITCH_CANDIDATES);
+
+    for (int i = 0; i < segments.size(); i++) {
+        if (segments[i].size() != m_segmentSize || !isValid()) {
+            emit error("PitchTracker::track: Segment nemá segmentSize() vzorků nebo jsou parametry odhadu neplatné.");
+            return QVector<Estimate>();
+        }
+
+        estimates[i] = estimate(segments[i].constData(), candidates.data() + i * PITCH_CANDIDATES);
+    }
+
+    if (smoothed)
+        smooth(estimates.data(), candidates.constData(), estimates.size());
+
+    return estimates;
+}
+
+void PitchTracker::autocorrelate() {
+    /* Wienerův–Chinčinův teorém: autokorelace je inverzí výkonového spektra. */
+    m_fft.realFFt(m_frame, m_spectrum);
+
+    for (kiss_fft_cpx &value : m_spectrum) {
+        value.r = (value.r * value.r) + (value.i * value.i);
+        value.i = 0.0f;
+    }
+
+    m_fft.invRealFFT(m_spectrum, m_frame);
+}
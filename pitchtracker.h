@@ -0,0 +1,207 @@
+#ifndef PITCHTRACKER_H
+#define PITCHTRACKER_H
+
+#include <QObject>
+#include <QVector>
+
+#include "pe_config.h"
+#include "fft.h"
+
+/*!
+ * Výchozí nejnižší hledaná základní frekvence v Hz.
+ */
+#define PITCH_MIN_FREQUENCY 60.0f
+
+/*!
+ * Výchozí nejvyšší hledaná základní frekvence v Hz.
+ */
+#define PITCH_MAX_FREQUENCY 500.0f
+
+/*!
+ * Počet kandidátů základní frekvence (maxim autokorelace) jednoho segmentu.
+ */
+#define PITCH_CANDIDATES 4
+
+/*!
+ * Výchozí práh znělosti, tj. normalizované autokorelace, od které je segment považován za znělý.
+ */
+#define PITCH_VOICING_THRESHOLD 0.45f
+
+/*!
+ * Energie segmentu v dB vzhledem k plnému rozsahu typu sample, pod kterou je segment považován za ticho.
+ */
+#define PITCH_SILENCE_THRESHOLD -60.0f
+
+/*!
+ * Zvýhodnění vyšších frekvencí na oktávu (proti chybám o oktávu dolů).
+ */
+#define PITCH_OCTAVE_COST 0.01f
+
+/*!
+ * Výchozí cena skoku o oktávu mezi sousedními znělými segmenty při vyhlazování.
+ */
+#define PITCH_OCTAVE_JUMP_COST 0.35f
+
+/*!
+ * Výchozí cena přechodu mezi znělým a neznělým segmentem při vyhlazování.
+ */
+#define PITCH_VOICED_UNVOICED_COST 0.14f
+
+/*!
+ * \brief Třída PitchTracker
+ *
+ * Třída odhaduje základní frekvenci (F0) a znělost segmentů akustického signálu, a to přímo ze segmentů, ze kterých
+ * jsou počítány MFC koeficienty (AudioSegmenter::nextSegment, resp. segmenty OfflineExtractor), bez dalšího
+ * rozdělení signálu. Odhad vychází z normalizované autokorelace (Boersma): segment je zbaven střední hodnoty,
+ * váhován Hannovým oknem a jeho autokorelace je vypočtena pomocí FFT (metody FFT::realFFt a FFT::invRealFFT nad
+ * segmentem doplněným nulami na dvojnásobnou délku, aby nevznikla kruhová autokorelace). Autokorelace je vydělena
+ * autokorelací okna, kterou třída předpočítá při konstrukci.
+ *
+ * Kandidáty základní frekvence jsou nejvyšší lokální maxima autokorelace v rozsahu period odpovídajícím
+ * minFrequency až maxFrequency, jejich poloha i hodnota je zpřesněna parabolickou interpolací. Znělost segmentu
+ * (0 až 1) je hodnota nejvyššího maxima, segment je znělý, pokud překročí práh znělosti. Tiché segmenty mají znělost 0.
+ *
+ * Při dávkovém zpracování (track, smooth) lze odhady vyhladit Viterbiho algoritmem: mezi kandidáty sousedních
+ * segmentů (včetně neznělého stavu) je hledána cesta s největší sílou kandidátů sníženou o ceny skoků frekvence
+ * a přechodů mezi znělými a neznělými segmenty.
+ *
+ * Objekt uchovává pracovní buffery, a proto nesmí být sdílen mezi vlákny.
+ */
+class PitchTracker : public QObject {
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief Struktura Estimate
+     *
+     * Odhad základní frekvence jednoho segmentu.
+     */
+    struct Estimate {
+        float frequency;    //!< Základní frekvence v Hz (0 u neznělého segmentu).
+        float voicing;      //!< Znělost segmentu (0 až 1).
+    };
+
+    /*!
+     * \brief Struktura Candidate
+     *
+     * Kandidát základní frekvence segmentu (maximum autokorelace).
+     */
+    struct Candidate {
+        float frequency;    //!< Frekvence kandidáta v Hz (0 u nevyužitého kandidáta).
+        float strength;     //!< Síla kandidáta (normalizovaná autokorelace se zvýhodněním vyšších frekvencí).
+    };
+
+    /*!
+     * \brief PitchTracker Konstruktor třídy. Alokuje transformaci velikosti alespoň 2 * segmentSize a předpočítá
+     *                     okno a jeho autokorelaci.
+     * \param segmentSize Počet vzorků segmentů.
+     * \param sampleRate Frekvence vzorkování signálu.
+     * \param minFrequency Nejnižší hledaná základní frekvence v Hz. Perioda nesmí přesáhnout polovinu segmentu, nižší
+     *                     hodnota je proto zvýšena (viz minFrequency()).
+     * \param maxFrequency Nejvyšší hledaná základní frekvence v Hz.
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolnění).
+     */
+    explicit PitchTracker(int segmentSize, int sampleRate, float minFrequency = PITCH_MIN_FREQUENCY,
+                          float maxFrequency = PITCH_MAX_FREQUENCY, QObject *parent = nullptr);
+
+    /*!
+     * \brief isValid Zjistí, zda byl objekt vytvořen s platnými parametry.
+     * \return True, pokud je objekt platný, jinak false.
+     */
+    bool isValid() const;
+
+    /*!
+     * \brief segmentSize Vrací počet vzorků segmentů.
+     * \return Počet vzorků segmentu.
+     */
+    int segmentSize() const;
+
+    /*!
+     * \brief minFrequency Vrací skutečnou nejnižší hledanou frekvenci (podle nejdelší periody).
+     * \return Frekvence v Hz.
+     */
+    float minFrequency() const;
+
+    /*!
+     * \brief maxFrequency Vrací skutečnou nejvyšší hledanou frekvenci (podle nejkratší periody).
+     * \return Frekvence v Hz.
+     */
+    float maxFrequency() const;
+
+    /*!
+     * \brief setVoicingThreshold Nastaví práh znělosti (výchozí PITCH_VOICING_THRESHOLD).
+     * \param threshold Práh znělosti (0 až 1).
+     * \return True, pokud byl práh nastaven, jinak false (a je emitován signál error).
+     */
+    bool setVoicingThreshold(float threshold);
+
+    /*!
+     * \brief setPathCosts Nastaví ceny přechodů pro vyhlazování Viterbiho algoritmem.
+     * \param octaveJump Cena skoku o oktávu mezi znělými segmenty (výchozí PITCH_OCTAVE_JUMP_COST).
+     * \param voicedUnvoiced Cena přechodu mezi znělým a neznělým segmentem (výchozí PITCH_VOICED_UNVOICED_COST).
+     * \return True, pokud byly ceny nastaveny, jinak false (a je emitován signál error).
+     */
+    bool setPathCosts(float octaveJump, float voicedUnvoiced);
+
+    /*!
+     * \brief estimate Odhadne základní frekvenci a znělost jednoho segmentu. Metoda nealokuje žádnou paměť.
+     * \param segment Ukazatel na segmentSize() vzorků segmentu.
+     * \param candidates Volitelný ukazatel na pole PITCH_CANDIDATES kandidátů pro pozdější vyhlazení (seřazeny od
+     *                   nejsilnějšího, nevyužité mají frekvenci 0).
+     * \return Odhad segmentu (nejsilnější kandidát, pokud je segment znělý).
+     */
+    Estimate estimate(const sample *segment, Candidate *candidates = nullptr);
+
+    /*!
+     * \brief estimate Přetížená metoda pro segmenty AudioSegmenter::nextSegment.
+     * \param segment Vzorky segmentu (segmentSize() vzorků).
+     * \return Odhad segmentu nebo neznělý odhad s nulovou znělostí při chybě (a je emitován signál error).
+     */
+    Estimate estimate(const QVector<sample> &segment);
+
+    /*!
+     * \brief smooth Vyhladí frekvence odhadů posloupnosti segmentů Viterbiho algoritmem (znělost se nemění).
+     * \param estimates Ukazatel na frames odhadů, frekvence jsou přepsány podle nalezené cesty.
+     * \param candidates Ukazatel na frames * PITCH_CANDIDATES kandidátů z metody estimate.
+     * \param frames Počet segmentů.
+     */
+    void smooth(Estimate *estimates, const Candidate *candidates, int frames) const;
+
+    /*!
+     * \brief track Dávkově odhadne základní frekvenci posloupnosti segmentů (např. všech segmentů AudioSegmenter).
+     * \param segments Segmenty signálu (po segmentSize() vzorcích).
+     * \param smoothed True, pokud mají být odhady vyhlazeny Viterbiho algoritmem.
+     * \return Odhady jednotlivých segmentů nebo prázdný vektor při chybě.
+     */
+    QVector<Estimate> track(const QVector<QVector<sample>> &segments, bool smoothed = true);
+
+private:
+    int m_segmentSize;              //!< Počet vzorků segmentů.
+    int m_sampleRate;               //!< Frekvence vzorkování.
+    int m_minLag;                   //!< Nejkratší hledaná perioda ve vzorcích.
+    int m_maxLag;                   //!< Nejdelší hledaná perioda ve vzorcích.
+    float m_voicingThreshold;       //!< Práh znělosti.
+    float m_octaveJumpCost;         //!< Cena skoku o oktávu.
+    float m_voicedUnvoicedCost;     //!< Cena přechodu mezi znělým a neznělým segmentem.
+    float m_silenceEnergy;          //!< Průměrná energie vzorku odpovídající PITCH_SILENCE_THRESHOLD.
+
+    FFT m_fft;                      //!< Transformace segmentu doplněného nulami na dvojnásobnou délku.
+    const float *m_window;          //!< Hannovo okno (sdílená tabulka WindowTable).
+    QVector<float> m_windowCorrelation; //!< Normalizovaná autokorelace okna (do m_maxLag + 1).
+    QVector<float> m_frame;         //!< Pracovní buffer segmentu doplněného nulami, po inverzi autokorelace.
+    QVector<kiss_fft_cpx> m_spectrum;   //!< Pracovní buffer spektra.
+
+    /*!
+     * \brief autocorrelate Metoda vypočítá autokorelaci obsahu m_frame pomocí FFT (výsledek zůstane v m_frame).
+     */
+    void autocorrelate();
+
+signals:
+    /*!
+     * \brief error Signál, který je emitován při chybě.
+     * \param message Popis chyby.
+     */
+    void error(QString message);
+};
+
+#endif
@@ -0,0 +1,162 @@
+#include "preemphasis.h"
+#include "windowtable.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+#ifdef __SSE2__
+/* Převod osmi vzorků na float (rozšíření 16 -> 32 bitů se znaménkem). */
+inline void loadSamples(const sample *samples, __m128 *low, __m128 *high) {
+    __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples));
+
+    *low = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16));
+    *high = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16));
+}
+#endif
+
+}
+
+PreEmphasis::PreEmphasis(int segmentSize, int hop, float coefficient, QObject *parent) : QObject(parent) {
+    m_segmentSize = segmentSize;
+    m_hop = hop;
+    m_coefficient = 0.0f;
+    m_ditherAmplitude = 0.0f;
+    m_ditherKey = 0;
+
+    if (segmentSize <= 1 || hop <= 0) {
+        emit error("PreEmphasis::PreEmphasis: Neplatná velikost nebo posun segmentů.");
+        m_segmentSize = 0;
+        m_hop = 1;
+    }
+
+    setCoefficient(coefficient);
+    reset();
+}
+
+int PreEmphasis::segmentSize() const {
+    return m_segmentSize;
+}
+
+int PreEmphasis::hop() const {
+    return m_hop;
+}
+
+float PreEmphasis::coefficient() const {
+    return m_coefficient;
+}
+
+qint64 PreEmphasis::position() const {
+    return m_position;
+}
+
+bool PreEmphasis::setCoefficient(float coefficient) {
+    if (!(coefficient >= 0.0f && coefficient <= 1.0f)) {
+        emit error("PreEmphasis::setCoefficient: Koeficient filtru musí být v rozsahu 0 až 1.");
+        return false;
+    }
+
+    m_coefficient = coefficient;
+    return true;
+}
+
+bool PreEmphasis::setDither(float amplitude, quint32 seed) {
+    if (!(amplitude >= 0.0f)) {
+        emit error("PreEmphasis::setDither: Amplituda ditheru nesmí být záporná.");
+        return false;
+    }
+
+    m_ditherAmplitude = amplitude;
+    m_ditherKey = (static_cast<quint64>(seed) + 1) * 0xD1B54A32D192ED03ull;
+    return true;
+}
+
+void PreEmphasis::reset(qint64 position, sample previous) {
+    m_position = qMax<qint64>(0, position);
+    m_previous = previous;
+
+    // při mezerách mezi segmenty je předcházející vzorek použit jen na začátku proudu (stejně jako v advance)
+    m_hasPrevious = m_position == 0 || m_hop <= m_segmentSize;
+}
+
+void PreEmphasis::apply(const float *window, const sample *segment, float *output) {
+    if (m_segmentSize == 0)
+        return;
+
+    if (m_coefficient == 0.0f && m_ditherAmplitude == 0.0f) {
+        WindowTable::apply(window, segment, output, m_segmentSize);
+        advance(segment);
+        return;
+    }
+
+    const float a = m_coefficient;
+    int i = 0;
+
+    if (m_ditherAmplitude > 0.0f) {
+        /* Dither je funkcí pozice, předcházející vzorek tak dostane stejný šum jako v předchozím segmentu. */
+        float previous;
+        if (!m_hasPrevious)
+            previous = segment[0] + dither(m_position);
+        else previous = m_previous + ((m_position > 0) ? dither(m_position - 1) : 0.0f);
+
+        for (; i < m_segmentSize; i++) {
+            float current = segment[i] + dither(m_position + i);
+
+            output[i] = (current - a * previous) * window[i];
+            previous = current;
+        }
+
+        advance(segment);
+        return;
+    }
+
+    float previous = m_hasPrevious ? m_previous : segment[0];
+    output[0] = (segment[0] - a * previous) * window[0];
+    i = 1;
+
+#ifdef __SSE2__
+    const __m128 coefficient = _mm_set1_ps(a);
+
+    for (; i + 8 <= m_segmentSize; i += 8) {
+        __m128 currentLow, currentHigh, previousLow, previousHigh;
+        loadSamples(segment + i, &currentLow, &currentHigh);
+        loadSamples(segment + i - 1, &previousLow, &previousHigh);
+
+        currentLow = _mm_sub_ps(currentLow, _mm_mul_ps(coefficient, previousLow));
+        currentHigh = _mm_sub_ps(currentHigh, _mm_mul_ps(coefficient, previousHigh));
+
+        _mm_storeu_ps(output + i, _mm_mul_ps(currentLow, _mm_loadu_ps(window + i)));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(currentHigh, _mm_loadu_ps(window + i + 4)));
+    }
+#endif
+
+    for (; i < m_segmentSize; i++)
+        output[i] = (segment[i] - a * static_cast<float>(segment[i - 1])) * window[i];
+
+    advance(segment);
+}
+
+void PreEmphasis::advance(const sample *segment) {
+    m_hasPrevious = m_hop <= m_segmentSize;
+
+    if (m_hasPrevious)
+        m_previous = segment[m_hop - 1];
+
+    m_position += m_hop;
+}
+
+inline float PreEmphasis::dither(qint64 position) const {
+    /* Míchací funkce splitmix64, dvě 24bitová rovnoměrná čísla dávají trojúhelníkové rozdělení. */
+    quint64 z = m_ditherKey + static_cast<quint64>(position) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+
+    const float scale = 1.0f / 16777216.0f;
+    float first = static_cast<float>(z >> 40) * scale;
+    float second = static_cast<float>((z >> 8) & 0xFFFFFF) * scale;
+
+    return (first - second) * m_ditherAmplitude;
+}
@@ -0,0 +1,131 @@
+#ifndef PREEMPHASIS_H
+#define PREEMPHASIS_H
+
+#include <QObject>
+
+#include "pe_config.h"
+
+/*!
+ * Výchozí koeficient filtru preemfáze.
+ */
+#define PREEMPHASIS_COEFFICIENT 0.97f
+
+/*!
+ * \brief Třída PreEmphasis
+ *
+ * Třída představuje preemfázi y[n] = x[n] - a * x[n - 1] s volitelným deterministickým ditheringem, která je
+ * provedena během převodu vzorků segmentu na float a váhování oknem (metoda apply), tedy bez dalšího průchodu
+ * pamětí. Filtr je spojitý přes celý proud: objekt si pamatuje pozici dalšího segmentu a vzorek, který mu
+ * předchází (pro překrývající se segmenty je to vzorek aktuálního segmentu na indexu hop - 1), takže výsledek
+ * nezávisí na tom, jak je proud rozdělen na segmenty ani na bloky dat. Pokud je posun segmentů větší než jejich
+ * velikost, předcházející vzorek není znám a první vzorek každého segmentu (kromě začátku proudu) je filtrován
+ * sám se sebou.
+ *
+ * Dither je trojúhelníkový šum s amplitudou ditherAmplitude (ve vzorcích typu sample) přičtený ke vzorkům před
+ * preemfází. Jeho hodnota je určena pouze semínkem a pozicí vzorku v proudu, je tedy shodná ve všech segmentech,
+ * které daný vzorek překrývají, a výsledek je opakovatelný i při paralelním zpracování bloků (viz reset).
+ *
+ * Objekt uchovává stav proudu, a proto nesmí být sdílen mezi více proudy.
+ */
+class PreEmphasis : public QObject {
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief PreEmphasis Konstruktor třídy.
+     * \param segmentSize Počet vzorků segmentů.
+     * \param hop Posun sousedních segmentů proudu (segmentSize - overlap).
+     * \param coefficient Koeficient filtru (0 až 1, 0 preemfázi vypíná).
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolnění).
+     */
+    explicit PreEmphasis(int segmentSize, int hop, float coefficient = PREEMPHASIS_COEFFICIENT, QObject *parent = nullptr);
+
+    /*!
+     * \brief segmentSize Vrací počet vzorků segmentů.
+     * \return Počet vzorků segmentu.
+     */
+    int segmentSize() const;
+
+    /*!
+     * \brief hop Vrací posun sousedních segmentů.
+     * \return Posun segmentů ve vzorcích.
+     */
+    int hop() const;
+
+    /*!
+     * \brief coefficient Vrací koeficient filtru.
+     * \return Koeficient filtru.
+     */
+    float coefficient() const;
+
+    /*!
+     * \brief position Vrací pozici prvního vzorku dalšího segmentu v proudu.
+     * \return Pozice ve vzorcích.
+     */
+    qint64 position() const;
+
+    /*!
+     * \brief setCoefficient Nastaví koeficient filtru.
+     * \param coefficient Koeficient filtru (0 až 1, 0 preemfázi vypíná).
+     * \return True, pokud byl koeficient nastaven, jinak false (a je emitován signál error).
+     */
+    bool setCoefficient(float coefficient);
+
+    /*!
+     * \brief setDither Nastaví deterministický dither (výchozí je vypnutý).
+     * \param amplitude Amplituda ditheru ve vzorcích typu sample (0 dither vypíná).
+     * \param seed Semínko generátoru.
+     * \return True, pokud byl dither nastaven, jinak false (a je emitován signál error).
+     */
+    bool setDither(float amplitude, quint32 seed = 0);
+
+    /*!
+     * \brief reset Nastaví stav proudu, tj. pozici dalšího segmentu a vzorek, který mu předchází. Bez parametrů
+     *              začíná nový proud (před prvním vzorkem je ticho). Při paralelním zpracování bloků segmentů
+     *              je metodu nutné volat na začátku každého bloku.
+     * \param position Pozice prvního vzorku dalšího segmentu v proudu.
+     * \param previous Vzorek na pozici position - 1 (na začátku proudu 0).
+     */
+    void reset(qint64 position = 0, sample previous = 0);
+
+    /*!
+     * \brief apply Převede vzorky segmentu na float, přičte dither, provede preemfázi a vynásobí výsledek oknem
+     *              v jediném průchodu. Poté posune stav proudu na další segment.
+     * \param window Ukazatel na segmentSize() vzorků okna.
+     * \param segment Ukazatel na segmentSize() vzorků segmentu.
+     * \param output Ukazatel na pole pro segmentSize() výsledných vzorků.
+     */
+    void apply(const float *window, const sample *segment, float *output);
+
+    /*!
+     * \brief advance Posune stav proudu za daný segment bez výpočtu (segment, jehož výstup není potřeba).
+     * \param segment Ukazatel na segmentSize() vzorků segmentu.
+     */
+    void advance(const sample *segment);
+
+private:
+    int m_segmentSize;          //!< Počet vzorků segmentů.
+    int m_hop;                  //!< Posun sousedních segmentů.
+    float m_coefficient;        //!< Koeficient filtru.
+    float m_ditherAmplitude;    //!< Amplituda ditheru (0 = vypnutý).
+    quint64 m_ditherKey;        //!< Klíč generátoru ditheru odvozený ze semínka.
+    qint64 m_position;          //!< Pozice prvního vzorku dalšího segmentu v proudu.
+    sample m_previous;          //!< Vzorek předcházející dalšímu segmentu.
+    bool m_hasPrevious;         //!< False, pokud předcházející vzorek není znám (posun větší než segment).
+
+    /*!
+     * \brief dither Vrátí hodnotu ditheru vzorku na dané pozici proudu.
+     * \param position Pozice vzorku v proudu.
+     * \return Hodnota ditheru v rozsahu (-m_ditherAmplitude, m_ditherAmplitude).
+     */
+    inline float dither(qint64 position) const;
+
+signals:
+    /*!
+     * \brief error Signál, který je emitován při chybě.
+     * \param message Popis chyby.
+     */
+    void error(QString message);
+};
+
+#endif
@@ -1,91 +1,254 @@
 #include "audiocomposer.h"
 
+#include <cstring>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+/*!
+ * Nejmenší hodnota obálky (vzhledem k jejímu maximu), kterou lze normalizovat. Vzorky s menší obálkou jsou nulové.
+ */
+#define AUDIOCOMPOSER_ENVELOPE_FLOOR 1e-4f
+
+namespace {
+
+/* accumulator[i] += values[i] * weights[i] */
+inline void multiplyAdd(float *accumulator, const float *values, const float *weights, int count) {
+    int i = 0;
+
+#ifdef __SSE__
+    for (; i + 4 <= count; i += 4) {
+        __m128 product = _mm_mul_ps(_mm_loadu_ps(values + i), _mm_loadu_ps(weights + i));
+        _mm_storeu_ps(accumulator + i, _mm_add_ps(_mm_loadu_ps(accumulator + i), product));
+    }
+#endif
+
+    for (; i < count; i++)
+        accumulator[i] += values[i] * weights[i];
+}
+
+}
+
 AudioComposer::AudioComposer(int segmentSize, int overlap, bool avgOverlap, QObject *parent) : QObject(parent) {
+    if (segmentSize <= 0 || overlap < 0 || overlap >= segmentSize) {
+        emit error("AudioComposer::AudioComposer: Překryv musí být nezáporný a menší než velikost segmentu.");
+        segmentSize = qMax(0, segmentSize);
+        overlap = 0;
+    }
+
     m_segmentSize = segmentSize;
     m_overlap = overlap;
     m_overlapSupp = segmentSize - overlap;
     m_avgOverlap = avgOverlap;
+    m_streaming = false;
     m_bufferSize = m_segmentSize;
-    m_buffer = new float[m_bufferSize];
-    m_first = m_next = 0;
+    m_buffer = new float[m_bufferSize]();
+    m_first = 0;
+    m_segments = m_position = 0;
+
+    QVector<float> rectangular(m_segmentSize, 1.0f);
+    initWeights(rectangular, rectangular);
 }
 
 AudioComposer::~AudioComposer() {
     delete [] m_buffer;
 }
 
-QVector<float> AudioComposer::getAudio() {
-    QVector<float> result;
+bool AudioComposer::setWindows(const QVector<float> &analysis, const QVector<float> &synthesis) {
+    if (analysis.size() != m_segmentSize || synthesis.size() != m_segmentSize) {
+        emit error("AudioComposer::setWindows: Velikost oken musí odpovídat velikosti segmentu.");
+        return false;
+    }
 
-    result.append(m_audio);
-    result.append(extractAudio(m_overlap));
+    if (!initWeights(analysis, synthesis)) {
+        emit error("AudioComposer::setWindows: Obálka oken je pro daný překryv nulová.");
 
-    return result;
+        QVector<float> rectangular(m_segmentSize, 1.0f);
+        initWeights(rectangular, rectangular);
+        return false;
+    }
+
+    return true;
 }
 
-void AudioComposer::clear() {
-    m_audio.clear();
-    m_first = m_next;
+bool AudioComposer::initWeights(const QVector<float> &analysis, const QVector<float> &synthesis) {
+    m_weights.resize(m_segmentSize);
+    m_firstWeights.resize(m_segmentSize);
+    m_product.resize(m_segmentSize);
+    m_envelope.fill(0.0f, m_overlapSupp);
+    m_headGain.fill(1.0f, m_overlap);
+
+    if (!m_avgOverlap) {
+        /* Nové jsou pouze vzorky za překryvem s předchozím segmentem, první segment je použit celý. */
+        for (int i = 0; i < m_segmentSize; i++) {
+            m_weights[i] = (i < m_overlap) ? 0.0f : 1.0f;
+            m_firstWeights[i] = m_product[i] = 1.0f;
+        }
+
+        m_envelope.fill(1.0f);
+        m_envelopeFloor = 0.0f;
+        return true;
+    }
+
+    for (int i = 0; i < m_segmentSize; i++) {
+        m_product[i] = analysis[i] * synthesis[i];
+        m_envelope[i % m_overlapSupp] += m_product[i];
+    }
+
+    float maxEnvelope = 0.0f;
+    for (int i = 0; i < m_overlapSupp; i++)
+        maxEnvelope = qMax(maxEnvelope, qAbs(m_envelope[i]));
+
+    m_envelopeFloor = maxEnvelope * AUDIOCOMPOSER_ENVELOPE_FLOOR;
+
+    for (int i = 0; i < m_overlapSupp; i++) {
+        if (qAbs(m_envelope[i]) <= m_envelopeFloor || maxEnvelope == 0.0f)
+            return false;
+    }
+
+    for (int i = 0; i < m_segmentSize; i++)
+        m_weights[i] = m_firstWeights[i] = synthesis[i] / m_envelope[i % m_overlapSupp];
+
+    /* Na začátku signálu překrývá vzorek t pouze segmenty, které začínají nejpozději na pozici t. */
+    for (int t = 0; t < m_overlap; t++) {
+        float envelope = 0.0f;
+
+        for (int i = t; i >= 0; i -= m_overlapSupp)
+            envelope += m_product[i];
+
+        m_headGain[t] = (qAbs(envelope) > m_envelopeFloor)
+                ? m_envelope[t % m_overlapSupp] / envelope : 0.0f;
+    }
+
+    return true;
 }
 
-bool AudioComposer::isEmpty() {
-    return m_first == m_next;
+void AudioComposer::setStreaming(bool streaming) {
+    m_streaming = streaming;
+    m_output.resize(streaming ? qMax(m_overlapSupp, m_overlap) : 0);
 }
 
-void AudioComposer::averateSegOverlap(const QVector<float> &segment) {
-    int nextMod;
+float AudioComposer::tailGain(qint64 position) const {
+    if (!m_avgOverlap)
+        return 1.0f;
 
-    for (int i = 0; i < m_overlap; i++) {
-        nextMod = (m_next + i) % m_bufferSize;
+    qint64 firstSegment = (position < m_segmentSize) ? 0 : (position - m_segmentSize) / m_overlapSupp + 1;
+    qint64 lastSegment = qMin<qint64>(m_segments - 1, position / m_overlapSupp);
+    float envelope = 0.0f;
 
-        m_buffer[nextMod] = (m_buffer[nextMod] + segment[i]) / 2;
-    }
+    for (qint64 k = firstSegment; k <= lastSegment; k++)
+        envelope += m_product[static_cast<int>(position - k * m_overlapSupp)];
+
+    return (qAbs(envelope) > m_envelopeFloor)
+            ? m_envelope[position % m_overlapSupp] / envelope : 0.0f;
 }
 
-QVector<float> AudioComposer::extractAudio(int size) {
-    QVector<float> extracted;
-    extracted.reserve(size);
+QVector<float> AudioComposer::getAudio() {
+    QVector<float> result(m_audio);
 
-    if (m_first + size > m_bufferSize) {
-        int rest = m_bufferSize - m_first;
-        int onStart = size - rest;
+    if (m_segments == 0)
+        return result;
 
-        std::copy(m_buffer + m_first, m_buffer + m_first + rest, std::back_inserter(extracted));
-        std::copy(m_buffer, m_buffer + onStart, std::back_inserter(extracted));
-    }
-    else std::copy(m_buffer + m_first, m_buffer + m_first + size, std::back_inserter(extracted));
+    int size = result.size();
+    result.resize(size + m_overlap);
+    extractAudio(m_overlap, result.data() + size);
 
-    return extracted;
+    for (int i = 0; i < m_overlap; i++)
+        result[size + i] *= tailGain(m_position + i);
+
+    return result;
 }
 
-void AudioComposer::write(const QVector<float> &floats) {
-    if (m_next + floats.size() > m_bufferSize) {
-        int toBufferEnd = m_bufferSize - m_next;
-        int remaing = floats.size() - toBufferEnd;
+void AudioComposer::flush() {
+    if (m_segments == 0)
+        return;
+
+    float *output;
 
-        std::copy(floats.begin(), floats.begin() + toBufferEnd, m_buffer + m_next);
-        std::copy(floats.begin() + toBufferEnd, floats.begin() + toBufferEnd + remaing, m_buffer);
+    if (m_streaming) {
+        output = m_output.data();
+    }
+    else {
+        int size = m_audio.size();
+        m_audio.resize(size + m_overlap);
+        output = m_audio.data() + size;
     }
-    else std::copy(floats.begin(), floats.begin() + floats.size(), m_buffer);
+
+    extractAudio(m_overlap, output);
+
+    for (int i = 0; i < m_overlap; i++)
+        output[i] *= tailGain(m_position + i);
+
+    resetBuffer();
+
+    if (m_streaming && m_overlap > 0)
+        emit audioComposed(m_output.constData(), m_overlap);
+}
+
+void AudioComposer::clear() {
+    m_audio.clear();
+    resetBuffer();
+}
+
+void AudioComposer::resetBuffer() {
+    std::fill(m_buffer, m_buffer + m_bufferSize, 0.0f);
+    m_first = 0;
+    m_segments = m_position = 0;
+}
+
+bool AudioComposer::isEmpty() {
+    return m_segments == 0;
+}
+
+void AudioComposer::extractAudio(int size, float *output) const {
+    int rest = qMin(size, m_bufferSize - m_first);
+
+    memcpy(output, m_buffer + m_first, rest * sizeof(float));
+    memcpy(output + rest, m_buffer, (size - rest) * sizeof(float));
+}
+
+void AudioComposer::write(const float *segment, const float *weights) {
+    int toBufferEnd = m_bufferSize - m_first;
+
+    // buffer má velikost segmentu, segment tedy vyplní celý buffer počínaje pozicí m_first
+    multiplyAdd(m_buffer + m_first, segment, weights, toBufferEnd);
+    multiplyAdd(m_buffer, segment + toBufferEnd, weights + toBufferEnd, m_first);
 }
 
 void AudioComposer::add(const QVector<float> &segment) {
-    if (segment.size() != m_segmentSize)
+    if (segment.size() != m_segmentSize || m_segmentSize == 0) {
+        emit error("AudioComposer::add: Velikost segmentu neodpovídá nastavené velikosti.");
         return;
+    }
+
+    write(segment.constData(), (m_segments == 0) ? m_firstWeights.constData() : m_weights.constData());
+    m_segments++;
+
+    /* Prvních m_overlapSupp vzorků od m_first je dokončeno, další segmenty je již nepřekrývají. */
+    float *output;
 
-    if (isEmpty()) {
-        write(segment);
+    if (m_streaming) {
+        output = m_output.data();
     }
     else {
-        if (m_avgOverlap)
-            averateSegOverlap(segment);
-
-        write(segment.mid(m_overlap));
+        int size = m_audio.size();
+        m_audio.resize(size + m_overlapSupp);
+        output = m_audio.data() + size;
     }
 
-    m_next = (m_next + m_overlapSupp) % m_bufferSize;
+    extractAudio(m_overlapSupp, output);
+
+    for (qint64 t = m_position; t < m_overlap && t < m_position + m_overlapSupp; t++)
+        output[t - m_position] *= m_headGain[static_cast<int>(t)];
+
+    int rest = qMin(m_overlapSupp, m_bufferSize - m_first);
+    std::fill(m_buffer + m_first, m_buffer + m_first + rest, 0.0f);
+    std::fill(m_buffer, m_buffer + (m_overlapSupp - rest), 0.0f);
+
+    m_first = (m_first + m_overlapSupp) % m_bufferSize;
+    m_position += m_overlapSupp;
 
-    QVector<float> extracted = extractAudio(m_overlapSupp);
-    m_first = m_next; // same as = (m_first + m_overlapSupp) % m_bufferSize;
-    m_audio.append(extracted);
+    if (m_streaming)
+        emit audioComposed(m_output.constData(), m_overlapSupp);
 }
@@ -8,10 +8,24 @@
 /*!
  * \brief Třída AudioComposer
  *
- * Třída poskytuje možnost zpětného spojování vytvořených segmentů akustického signálu. Pomocí metody write jednotlivé segmenty
- * zapisovány do cyklického bufferu, ze kterého je pak zkompletovaný signál odebrán a předán signálem audioComposed. Mezi další
- * funkcionality třídy patří notifikace při zkompletování určitého množství segmentů nebo průměrování vzorků v překrávajících se
- * částech akustického signálu.
+ * Třída poskytuje možnost zpětného spojování vytvořených segmentů akustického signálu metodou váženého sčítání
+ * s překryvem (weighted overlap-add). Každý segment je vynásoben syntézním oknem a přičten do cyklického bufferu
+ * velikosti segmentu, odkud jsou po každém segmentu odebrány dokončené vzorky (segmentSize - overlap vzorků).
+ * Výsledek je normalizován součtem součinů analyzačního a syntézního okna všech segmentů, které daný vzorek
+ * překrývají (pro stejné okno jde o součet kvadrátů okna). Pro ustálený stav je tato obálka periodická a je
+ * předem vydělena do syntézního okna, takže na každý vzorek segmentu připadá jediné násobení a sčítání.
+ * Začátek signálu (menší počet překrývajících se segmentů) je korigován předem spočtenou tabulkou, konec signálu
+ * při jeho odebrání metodou getAudio. Velikost překryvu je libovolná (0 až segmentSize - 1).
+ *
+ * Sestavený signál je ve výchozím stavu ukládán do vektoru, který roste až do volání metody clear, a celý je vrácen
+ * metodou getAudio. Pro dlouhé nebo nekonečné proudy (přehrávání) je určen proudový režim (setStreaming), ve kterém
+ * je každý dokončený úsek m_overlapSupp vzorků předán signálem audioComposed přímo z interního pole a třída
+ * neuchovává nic kromě cyklického bufferu velikosti segmentu.
+ *
+ * Výchozí analyzační i syntézní okno je obdélníkové, tj. překrývající se vzorky všech segmentů jsou průměrovány.
+ * Segmenty obnovené z koeficientů spočtených s Hammingovým oknem (SegmentRecover) je vhodné spojovat s Hammingovým
+ * oknem nastaveným metodou setWindows jako analyzační i syntézní okno (odhad nejmenších čtverců, bez dělení oknem
+ * jako WindowFunction::denormalize).
  */
 class AudioComposer : public QObject {
     Q_OBJECT
@@ -21,8 +35,8 @@ public:
      * \brief AudioComposer Konstruktor třídy.
      * \param segmentSize Velikost vstupních segmentů akustického signálu.
      * \param overlap Počet vzorků, ve kterých se sousední segmenty překrývají.
-     * \param avgOverlap TRUE, pokud chcete průměrovat hodnoty v překryvech sousedních segmentů. V případě, že bude nastavena hodnota
-     *                   FALSE, budou při překryvu využity vzorky předchozího segmentu.
+     * \param avgOverlap TRUE, pokud chcete průměrovat (vážit okny) hodnoty v překryvech sousedních segmentů. V případě,
+     *                   že bude nastavena hodnota FALSE, budou při překryvu využity vzorky předchozího segmentu.
      * \param parent Ukazatel na rodičovský objekt (kvůli uvoňování).
      */
     explicit AudioComposer(int segmentSize, int overlap, bool avgOverlap = true, QObject *parent = nullptr);
@@ -33,15 +47,40 @@ public:
     ~AudioComposer();
 
     /*!
-     * \brief getComposedAudio Metoda vratí aktuálně sestavený akustický signál.
+     * \brief setWindows Nastaví analyzační okno (kterým jsou segmenty váženy již na vstupu) a syntézní okno (kterým
+     *                   jsou vynásobeny při spojování) a přepočítá normalizační tabulky. Metodu je nutné volat před
+     *                   přidáním prvního segmentu (nebo po metodě clear). Při avgOverlap = false nemají okna vliv.
+     * \param analysis Vzorky analyzačního okna (segmentSize vzorků).
+     * \param synthesis Vzorky syntézního okna (segmentSize vzorků).
+     * \return True, pokud mají okna správnou velikost a jejich obálka je nenulová, jinak false.
+     */
+    bool setWindows(const QVector<float> &analysis, const QVector<float> &synthesis);
+
+    /*!
+     * \brief setStreaming Zapne nebo vypne proudový režim. V proudovém režimu nejsou dokončené vzorky ukládány, ale jsou
+     *                     předány signálem audioComposed (metoda getAudio pak vrací pouze nedokončený konec signálu).
+     * \param streaming True pro proudový režim, false pro ukládání celého signálu (výchozí).
+     */
+    void setStreaming(bool streaming);
+
+    /*!
+     * \brief flush Metoda dokončí sestavovaný signál: nedokončený konec (překryv posledního segmentu) je normalizován
+     *              podle skutečného počtu segmentů a předán signálem audioComposed (v proudovém režimu) nebo připojen
+     *              k sestavenému signálu. Buffer je poté vyprázdněn a další segment začíná nový signál.
+     */
+    void flush();
+
+    /*!
+     * \brief getComposedAudio Metoda vratí aktuálně sestavený akustický signál včetně dosud nedokončeného konce
+     *                         (překryvu posledního segmentu), který je normalizován podle skutečného počtu segmentů.
      * \return Vektor vzorků sestaveného akusticého signálu.
      */
     QVector<float> getAudio();
 
     /*!
      * \brief add Metoda, pomocí které probíhá samotné zpracování vstupního segmentu. Vzorky daného segmentu
-     *            zkopírovány do cyklického bufferu a popřípadě využity při průměrování vzorků v překrývajících
-     *            se částech sousedních polích.
+     *            jsou váženy syntézním oknem a přičteny do cyklického bufferu, dokončené vzorky jsou připojeny
+     *            k sestavenému signálu.
      * \param segment Segment akustického signálu, který je určen ke zkompletování.
      */
     void add(const QVector<float> &segment);
@@ -62,38 +101,70 @@ private:
     int m_overlap;          //!< Počet vzorků, ve kterých se překrývají sousední segmenty.
     int m_overlapSupp;      //!< Počet vzorků, které nejsou překryty s dalším segmentem (m_segmentSize - m_overlap).
     bool m_avgOverlap;      //!< Logická hodnota, která určuje, zda se mají překrávající se hodnoty průměrovat.
+    bool m_streaming;       //!< Logická hodnota, která určuje, zda se dokončené vzorky předávají signálem audioComposed.
 
-    float *m_buffer;        //!< Dynamicky alokovaný cyklický buffer.
+    float *m_buffer;        //!< Dynamicky alokovaný cyklický buffer (součty vážených segmentů).
     int m_bufferSize;       //!< Počet vzorků cyklického bufferu m_buffer.
-    int m_first;            //!< Index prvního prvky aktuálně kompletovaného segmentu.
-    int m_next;             //!< Index prvku, na který se bude zapisovat při dalším volání metody add.
-    QVector<float> m_audio; //!< Vektor, který obsahuje sestavený zvuk.
+    int m_first;            //!< Index prvního nedokončeného vzorku (a začátku dalšího segmentu) v cyklickém bufferu.
+    qint64 m_segments;      //!< Počet přidaných segmentů od vytvoření nebo od volání metody clear.
+    qint64 m_position;      //!< Počet dokončených (odebraných) vzorků od vytvoření nebo od volání metody clear.
+    QVector<float> m_audio; //!< Vektor, který obsahuje sestavený zvuk (mimo proudový režim).
+    QVector<float> m_output;//!< Pole dokončených vzorků předávané signálem audioComposed (proudový režim).
+
+    QVector<float> m_weights;       //!< Syntézní okno vydělené periodickou obálkou (váhy ustáleného stavu).
+    QVector<float> m_firstWeights;  //!< Váhy prvního segmentu (liší se pouze při avgOverlap = false).
+    QVector<float> m_product;       //!< Součin analyzačního a syntézního okna.
+    QVector<float> m_envelope;      //!< Periodická obálka ustáleného stavu (m_overlapSupp vzorků).
+    QVector<float> m_headGain;      //!< Korekce prvních m_overlap vzorků signálu (překryto méně segmenty).
+    float m_envelopeFloor;          //!< Nejmenší hodnota obálky, kterou lze normalizovat.
 
     /*!
-     * \brief averateSegOverlap Metoda provede průměrování překrávajících se vzorků sousedních segmentů.
-     * \details V daném segmentu se iteruje pouze nad prvními m_overlap hodnotami. Tuto hodnoty se průměrují
-     *          s posledními m_overlap vzorky, které jsou zapsány v cyklickém bufferu. Posledních m_overlap
-     *          hodnot v cyklickém bufferu jsou poté nahrazeny výsledky průměrování.
-     * \param window
+     * \brief initWeights Metoda spočítá váhy segmentů, periodickou obálku a korekci začátku signálu z daných oken.
+     * \param analysis Vzorky analyzačního okna.
+     * \param synthesis Vzorky syntézního okna.
+     * \return True, pokud je periodická obálka nenulová, jinak false.
      */
-    void averateSegOverlap(const QVector<float> &segment);
+    bool initWeights(const QVector<float> &analysis, const QVector<float> &synthesis);
 
     /*!
      * \brief extractAudio Metoda extrahuje size vzorků z cykleckého bufferu počínaje pozicí m_first. Metoda nijak neovlivňuje
-     *                     hodnoty řídících proměnných m_first nebo m_next.
+     *                     hodnotu řídící proměnné m_first.
      * \param size Počet vzorků, které metdoa extrahuje.
-     * \return Vektor extrahovaných vzorků.
+     * \param output Ukazatel na pole, do kterého jsou vzorky zapsány.
      */
-    QVector<float> extractAudio(int size);
+    void extractAudio(int size, float *output) const;
 
     /*!
-     * \brief write Metoda provádí samotný zápis daného vektoru do cyklického bufferu. Voláním této metody se
-     *              implicitně nezmění řídící proměnné m_first, m_next a m_written.
+     * \brief write Metoda přičte segment vynásobený danými vahami do cyklického bufferu počínaje pozicí m_first.
+     *              Voláním této metody se nezmění řídící proměnná m_first.
      * \param segment Segment akustického signálu určený k zapsání do cyklického bufferu.
+     * \param weights Váhy vzorků segmentu.
+     */
+    void write(const float *segment, const float *weights);
+
+    /*!
+     * \brief tailGain Metoda vrátí korekci nedokončeného vzorku na konci signálu podle segmentů, které jej skutečně
+     *                 překrývají.
+     * \param position Pozice vzorku v sestaveném signálu.
+     * \return Násobitel vzorku z cyklického bufferu.
+     */
+    float tailGain(qint64 position) const;
+
+    /*!
+     * \brief resetBuffer Metoda vyprázdní cyklický buffer a vynuluje počitadla segmentů a vzorků.
      */
-    void write(const QVector<float> &segment);
+    void resetBuffer();
 
 signals:
+    /*!
+     * \brief audioComposed Signál, který je v proudovém režimu emitován s každým dokončeným úsekem signálu. Pole je platné
+     *                      pouze po dobu zpracování signálu (je nutné přímé spojení, Qt::DirectConnection), data je
+     *                      případně nutné zkopírovat.
+     * \param audio Ukazatel na dokončené vzorky.
+     * \param size Počet vzorků (segmentSize - overlap, při volání flush velikost překryvu).
+     */
+    void audioComposed(const float *audio, int size);
+
     /*!
      * \brief error Signál, který je emitován při chybě.
      * \param message Popis chyby.
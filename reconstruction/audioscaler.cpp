@@ -1,28 +1,322 @@
 #include "audioscaler.h"
 
+#include <algorithm>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+/* Počet vzorků zpracovaných v proudovém režimu najednou (velikost pracovních polí). */
+const int BLOCK_SIZE = 1024;
+
+const float SAMPLE_MAX = std::numeric_limits<sample>::max();
+const float SAMPLE_MIN = std::numeric_limits<sample>::min();
+
+/* Největší absolutní hodnota pole. */
+float maxAbs(const float *values, int count) {
+    float maxValue = 0.0f;
+    int i = 0;
+
+#ifdef __SSE2__
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 acc = _mm_setzero_ps();
+
+    for (; i + 4 <= count; i += 4)
+        acc = _mm_max_ps(acc, _mm_and_ps(absMask, _mm_loadu_ps(values + i)));
+
+    acc = _mm_max_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_max_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    maxValue = _mm_cvtss_f32(acc);
+#endif
+
+    for (; i < count; i++)
+        maxValue = qMax(maxValue, std::fabs(values[i]));
+
+    return maxValue;
+}
+
+/* Nejmenší hodnota pole zesílení (1 pro prázdné pole). */
+float minGain(const float *values, int count) {
+    float minValue = 1.0f;
+    int i = 0;
+
+#ifdef __SSE2__
+    __m128 acc = _mm_set1_ps(1.0f);
+
+    for (; i + 4 <= count; i += 4)
+        acc = _mm_min_ps(acc, _mm_loadu_ps(values + i));
+
+    acc = _mm_min_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_min_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    minValue = _mm_cvtss_f32(acc);
+#endif
+
+    for (; i < count; i++)
+        minValue = qMin(minValue, values[i]);
+
+    return minValue;
+}
+
+/* required[i] = zesílení, se kterým vzorek values[i] nepřeteče (SAMPLE_MAX / |values[i]|, nejvýše 1). */
+void requiredGains(const float *values, int count, float *required) {
+    int i = 0;
+
+#ifdef __SSE2__
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 upper = _mm_set1_ps(SAMPLE_MAX);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    for (; i + 4 <= count; i += 4) {
+        // pro |x| <= SAMPLE_MAX je podíl alespoň 1 (u nuly nekonečno), minimum pak dává přesně 1 jako skalární větev
+        __m128 absValue = _mm_and_ps(absMask, _mm_loadu_ps(values + i));
+        _mm_storeu_ps(required + i, _mm_min_ps(_mm_div_ps(upper, absValue), one));
+    }
+#endif
+
+    for (; i < count; i++) {
+        float absValue = std::fabs(values[i]);
+        required[i] = (absValue > SAMPLE_MAX) ? SAMPLE_MAX / absValue : 1.0f;
+    }
+}
+
+/*
+ * output[i] = saturace(zaokrouhlení(values[i] * factor * gains[i])), gains může být nullptr.
+ * Zaokrouhlení k nejbližšímu sudému odpovídá funkci rint ve výchozím režimu zaokrouhlování.
+ */
+void convert(const float *values, const float *gains, float factor, int count, sample *output) {
+    int i = 0;
+
+#ifdef __SSE2__
+    const __m128 scale = _mm_set1_ps(factor);
+    const __m128 upper = _mm_set1_ps(SAMPLE_MAX);
+    const __m128 lower = _mm_set1_ps(SAMPLE_MIN);
+
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(values + i), scale);
+        __m128 b = _mm_mul_ps(_mm_loadu_ps(values + i + 4), scale);
+
+        if (gains) {
+            a = _mm_mul_ps(a, _mm_loadu_ps(gains + i));
+            b = _mm_mul_ps(b, _mm_loadu_ps(gains + i + 4));
+        }
+
+        // omezení před převodem: hodnoty mimo rozsah int32 by cvtps převedl na 0x80000000
+        a = _mm_min_ps(_mm_max_ps(a, lower), upper);
+        b = _mm_min_ps(_mm_max_ps(b, lower), upper);
+
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), packed);
+    }
+#endif
+
+    for (; i < count; i++) {
+        float value = values[i] * factor * (gains ? gains[i] : 1.0f);
+        output[i] = static_cast<sample>(std::rint(qBound(SAMPLE_MIN, value, SAMPLE_MAX)));
+    }
+}
+
+}
+
 AudioScaler::AudioScaler(QObject *parent) : QObject(parent) {
+    m_blockGains.resize(BLOCK_SIZE);
 
+    setLimiter(AUDIOSCALER_LOOKAHEAD, AUDIOSCALER_RELEASE);
 }
 
 QVector<sample> AudioScaler::scale(const QVector<float> &segment) {
-    float scaleFactor = findScaleFactor(segment);
     QVector<sample> scaled(segment.size());
-
-    for (int i = 0; i < segment.size(); i++)
-        scaled[i] = (sample)rint(segment[i] / scaleFactor);
+    scale(segment.constData(), segment.size(), scaled.data());
 
     return scaled;
 }
 
-float AudioScaler::findScaleFactor(const QVector<float> &segment) {
-    float maxValue = 0;
+void AudioScaler::scale(const float *input, int count, sample *output) {
+    float scaleFactor = findScaleFactor(input, count);
+
+    convert(input, nullptr, 1.0f / scaleFactor, count, output);
+}
+
+float AudioScaler::findScaleFactor(const float *segment, int count) {
+    float maxValue = maxAbs(segment, count);
 
-    for (int i = 0; i < segment.size(); i++) {
-        float absValue = qAbs(segment[i]);
+    return (maxValue > SAMPLE_MAX) ? maxValue / SAMPLE_MAX : 1;
+}
+
+void AudioScaler::setLimiter(int lookAhead, int release) {
+    m_lookAhead = qMax(0, lookAhead);
+    m_windowSize = m_lookAhead + 1;
+    m_windowScale = 1.0 / m_windowSize;
+    m_releaseCoef = (release > 0) ? static_cast<float>(std::exp(-1.0 / release)) : 0.0f;
+
+    m_delay.resize(m_lookAhead + BLOCK_SIZE);
+    m_required.resize(m_lookAhead + BLOCK_SIZE);
+    m_prefixMin.resize(m_lookAhead + BLOCK_SIZE);
+    m_suffixMin.resize(m_lookAhead + BLOCK_SIZE);
+    m_minimums.resize(m_windowSize);
+
+    reset();
+}
 
-        if (absValue > maxValue)
-            maxValue = absValue;
+int AudioScaler::latency() const {
+    return m_lookAhead;
+}
+
+float AudioScaler::gain() const {
+    return m_gain;
+}
+
+void AudioScaler::reset() {
+    // signál před začátkem proudu je ticho, jeho zesílení je 1
+    m_minimums.fill(1.0f);
+    m_minimumsSum = m_windowSize;
+    m_unitMinimums = m_windowSize;
+    m_slot = 0;
+    m_inputCount = 0;
+    m_gain = 1.0f;
+}
+
+void AudioScaler::windowMinimums(int from, int count, float *minimums) {
+    const float *required = m_required.constData() + from;
+    float *prefix = m_prefixMin.data();
+    float *suffix = m_suffixMin.data();
+    int length = count + m_lookAhead;
+
+    /* Minima od začátku a do konce úseků délky okna, obě řady v jednom průchodu (nezávislé závislostní řetězce). */
+    for (int begin = 0; begin < length; begin += m_windowSize) {
+        int last = qMin(length, begin + m_windowSize) - 1;
+
+        float forward = required[begin];
+        float backward = required[last];
+
+        prefix[begin] = forward;
+        suffix[last] = backward;
+
+        for (int i = 1; i <= last - begin; i++) {
+            forward = qMin(forward, required[begin + i]);
+            backward = qMin(backward, required[last - i]);
+            prefix[begin + i] = forward;
+            suffix[last - i] = backward;
+        }
+    }
+
+    /* Okno <k, k + m_lookAhead> leží nejvýše ve dvou sousedních úsecích. */
+    for (int k = 0; k < count; k++)
+        minimums[k] = qMin(suffix[k], prefix[k + m_lookAhead]);
+}
+
+int AudioScaler::processBlock(const float *input, int count, sample *output) {
+    float *samples = m_delay.data() + m_lookAhead;
+    float *required = m_required.data() + m_lookAhead;
+
+    if (input) {
+        std::memcpy(samples, input, count * sizeof(float));
+        requiredGains(input, count, required);
+    }
+    else {
+        std::fill(samples, samples + count, 0.0f);
+        std::fill(required, required + count, 1.0f);
+    }
+
+    /*
+     * Index i polí m_delay a m_required odpovídá pozici m_inputCount - m_lookAhead + i. Vydán je vzorek i, jehož okno
+     * klouzavého minima <i, i + m_lookAhead> je celé známo, tj. vzorky 0 až count - 1 se zápornou pozicí vynechanou.
+     */
+    int from = static_cast<int>(qBound<qint64>(0, m_lookAhead - m_inputCount, count));
+    int outputs = count - from;
+
+    m_inputCount += count;
+
+    if (outputs > 0) {
+        if (m_gain == 1.0f && m_unitMinimums == m_windowSize
+                && minGain(m_required.constData() + from, outputs + m_lookAhead) == 1.0f) {
+            // nic nepřetéká a zesílení je ustálené na 1: stav se nemění, jen se posune cyklický buffer minim
+            convert(m_delay.constData() + from, nullptr, 1.0f, outputs, output);
+            m_slot = (m_slot + outputs) % m_windowSize;
+        }
+        else {
+            float *gains = m_blockGains.data();
+            windowMinimums(from, outputs, gains);
+
+            /* Stav v lokálních proměnných, zápisy do gains by jinak vynucovaly jeho opětovné načítání. */
+            float *minimums = m_minimums.data();
+            double minimumsSum = m_minimumsSum;
+            int unitMinimums = m_unitMinimums;
+            int slot = m_slot;
+            float gain = m_gain;
+
+            /*
+             * Klouzavé minimum přes předstih zaručuje, že zesílení nepřekročí potřebné zesílení žádného vzorku v okně,
+             * klouzavý průměr minim z něj dělá lineární náběh délky předstihu. Návrat k 1 je exponenciální.
+             */
+            for (int k = 0; k < outputs; k++) {
+                float minimum = gains[k];
+
+                minimumsSum += minimum - minimums[slot];
+                minimums[slot] = minimum;
+                slot = (slot + 1 == m_windowSize) ? 0 : slot + 1;
+
+                // po odeznění omezení je součet srovnán přesně, zaokrouhlovací chyby by jinak držely zesílení pod 1
+                unitMinimums = (minimum == 1.0f) ? qMin(unitMinimums + 1, m_windowSize) : 0;
+                if (unitMinimums == m_windowSize)
+                    minimumsSum = m_windowSize;
+
+                float smoothed = static_cast<float>(minimumsSum * m_windowScale);
+                float released = 1.0f - (1.0f - gain) * m_releaseCoef;
+
+                gain = qMin(smoothed, released);
+                gains[k] = gain;
+            }
+
+            m_minimumsSum = minimumsSum;
+            m_unitMinimums = unitMinimums;
+            m_slot = slot;
+            m_gain = gain;
+
+            convert(m_delay.constData() + from, gains, 1.0f, outputs, output);
+        }
     }
 
-    return (maxValue > std::numeric_limits<sample>::max()) ? maxValue / std::numeric_limits<sample>::max() : 1;
+    /* Posledních m_lookAhead vzorků bloku čeká na další blok. */
+    std::memmove(m_delay.data(), m_delay.constData() + count, m_lookAhead * sizeof(float));
+    std::memmove(m_required.data(), m_required.constData() + count, m_lookAhead * sizeof(float));
+
+    return outputs;
+}
+
+int AudioScaler::scaleStream(const float *input, int count, sample *output) {
+    int written = 0;
+
+    for (int begin = 0; begin < count; begin += BLOCK_SIZE)
+        written += processBlock(input + begin, qMin(BLOCK_SIZE, count - begin), output + written);
+
+    return written;
+}
+
+QVector<sample> AudioScaler::scaleStream(const QVector<float> &segment) {
+    QVector<sample> scaled(segment.size());
+    scaled.resize(scaleStream(segment.constData(), segment.size(), scaled.data()));
+
+    return scaled;
+}
+
+int AudioScaler::flush(sample *output) {
+    /* Zbývající vzorky jsou vytlačeny m_lookAhead vzorky ticha. */
+    int pending = static_cast<int>(qMin<qint64>(m_lookAhead, m_inputCount));
+    int written = 0;
+
+    for (int pushed = 0; written < pending; pushed += BLOCK_SIZE)
+        written += processBlock(nullptr, qMin(BLOCK_SIZE, m_lookAhead - pushed), output + written);
+
+    reset();
+    return written;
+}
+
+QVector<sample> AudioScaler::flush() {
+    QVector<sample> scaled(m_lookAhead);
+    scaled.resize(flush(scaled.data()));
+
+    return scaled;
 }
@@ -8,12 +8,37 @@
 
 #include "../pe_config.h"
 
+/*!
+ * Výchozí předstih omezovače v proudovém režimu (počet vzorků, o které je výstup zpožděn).
+ */
+#define AUDIOSCALER_LOOKAHEAD 512
+
+/*!
+ * Výchozí časová konstanta návratu zesílení omezovače k 1 (počet vzorků).
+ */
+#define AUDIOSCALER_RELEASE 4410
+
 /*!
  * \brief Třída AudioScaler
  *
  * Třída poskytuje mechanismus pro přeškálování akustických signálů, jejihž vzorky jsou uloženy
  * jako float do signálu s datovým typem sample. Implicitní konverze by mohla způsobit přetečení
  * vzorků typu sample, proto je nutné v případě potřeby původní vzorky přeškálovat.
+ *
+ * Metoda scale zpracuje celý signál najednou: najde největší absolutní hodnotu a pokud přesahuje rozsah typu
+ * sample, je celý signál zmenšen jedním faktorem. Hledání maxima i převod (násobení převrácenou hodnotou faktoru,
+ * zaokrouhlení a saturující zúžení na 16 bitů) jsou vektorizovány pomocí SSE2.
+ *
+ * Proudový režim (metody scaleStream a flush) zpracovává signál po částech se spojitě se měnícím zesílením.
+ * Omezovač s předstihem (look-ahead) sníží zesílení plynule během lookAhead vzorků před vzorkem, který by přetekl,
+ * a po jeho odeznění se zesílení exponenciálně vrací k 1 s časovou konstantou release. Samostatně zpracované části
+ * tak nezpůsobí skoky v hlasitosti. Výstup je oproti vstupu zpožděn o lookAhead vzorků (latency).
+ *
+ * Signál je zpracováván po blocích: potřebná zesílení vzorků jsou spočítána vektorově (SSE2), klouzavá minima
+ * celého bloku algoritmem van Herk/Gil-Werman (tři porovnání na vzorek bez ohledu na předstih). Blok, v němž žádný
+ * vzorek nepřetéká a zesílení je již 1, se jen zkopíruje a převede (asi dvojnásobek času metody scale). Během
+ * omezování zůstává sekvenční klouzavý průměr minim a rekurze návratu zesílení (čtyři na sobě závislé operace na
+ * vzorek), proudový režim je pak zhruba o řád pomalejší než scale (viz bmAudioScaler v pe_bench).
  */
 class AudioScaler : public QObject {
 
@@ -32,15 +57,113 @@ public:
      */
     QVector<sample> scale(const QVector<float> &segment);
 
+    /*!
+     * \brief scale Přetížená metoda pracující s poli.
+     * \param input Vzorky určené ke škálování.
+     * \param count Počet vzorků.
+     * \param output Pole pro count přeškálovaných vzorků.
+     */
+    void scale(const float *input, int count, sample *output);
+
+    /*!
+     * \brief setLimiter Nastaví parametry omezovače proudového režimu a vynuluje jeho stav (viz reset).
+     * \param lookAhead Předstih (a zpoždění výstupu) ve vzorcích, výchozí AUDIOSCALER_LOOKAHEAD.
+     * \param release Časová konstanta návratu zesílení ve vzorcích, výchozí AUDIOSCALER_RELEASE.
+     */
+    void setLimiter(int lookAhead, int release);
+
+    /*!
+     * \brief latency Vrací zpoždění výstupu proudového režimu.
+     * \return Počet vzorků zpoždění.
+     */
+    int latency() const;
+
+    /*!
+     * \brief gain Vrací zesílení naposledy vydaného vzorku proudového režimu.
+     * \return Zesílení (0 až 1).
+     */
+    float gain() const;
+
+    /*!
+     * \brief scaleStream Zpracuje další část signálu v proudovém režimu. Prvních latency() vzorků signálu je
+     *                    pouze uloženo, výstup je tedy o toto množství zpožděn.
+     * \param input Vzorky další části signálu.
+     * \param count Počet vzorků.
+     * \param output Pole pro nejvýše count výstupních vzorků.
+     * \return Počet zapsaných výstupních vzorků.
+     */
+    int scaleStream(const float *input, int count, sample *output);
+
+    /*!
+     * \brief scaleStream Přetížená metoda pracující s vektory.
+     * \param segment Vzorky další části signálu.
+     * \return Výstupní vzorky (zpožděné o latency() vzorků).
+     */
+    QVector<sample> scaleStream(const QVector<float> &segment);
+
+    /*!
+     * \brief flush Vydá zbývající (zpožděné) vzorky proudového režimu a vynuluje jeho stav.
+     * \param output Pole pro nejvýše latency() vzorků.
+     * \return Počet zapsaných vzorků.
+     */
+    int flush(sample *output);
+
+    /*!
+     * \brief flush Přetížená metoda vracející vektor.
+     * \return Zbývající vzorky signálu.
+     */
+    QVector<sample> flush();
+
+    /*!
+     * \brief reset Vynuluje stav proudového režimu (zahodí zpožděné vzorky, zesílení nastaví na 1).
+     */
+    void reset();
+
 private:
+    int m_lookAhead;                //!< Předstih omezovače (délka zpoždění).
+    float m_releaseCoef;            //!< Koeficient exponenciálního návratu zesílení za jeden vzorek.
+    int m_windowSize;               //!< Délka okna klouzavého minima a průměru (m_lookAhead + 1).
+    double m_windowScale;           //!< Převrácená hodnota m_windowSize.
+
+    QVector<float> m_delay;         //!< Zpožděné vzorky (m_lookAhead posledních) následované vzorky bloku.
+    QVector<float> m_required;      //!< Potřebná zesílení vzorků m_delay.
+    QVector<float> m_prefixMin;     //!< Pracovní pole minim od začátku úseků délky m_windowSize (van Herk).
+    QVector<float> m_suffixMin;     //!< Pracovní pole minim do konce úseků délky m_windowSize (van Herk).
+    int m_slot;                     //!< Index vydávaného vzorku v m_minimums.
+    QVector<float> m_minimums;      //!< Cyklický buffer klouzavých minim pro klouzavý průměr.
+    double m_minimumsSum;           //!< Součet prvků m_minimums.
+    int m_unitMinimums;             //!< Počet posledních po sobě jdoucích minim rovných 1 (nejvýše m_windowSize).
+    qint64 m_inputCount;            //!< Počet vzorků přijatých v proudovém režimu.
+    float m_gain;                   //!< Zesílení naposledy vydaného vzorku.
+
+    QVector<float> m_blockGains;    //!< Pracovní pole zesílení jednoho bloku.
+
     /*!
      * \brief findScaleFactor Metoda projde daný segment, nejde v něm vzorek s největší aboslutní hodnotou
      *                        a pokud hodnota tohoto vzorku přesahuje rozsah typu sample, je stanoven výsledný
      *                        škálovací faktor.
-     * \param segment Segment, pro který se bude hledat škálovací faktor.
+     * \param segment Ukazatel na vzorky segmentu, pro který se bude hledat škálovací faktor.
+     * \param count Počet vzorků segmentu.
      * \return Hodnota škálovacího faktoru.
      */
-    float findScaleFactor(const QVector<float> &segment);
+    float findScaleFactor(const float *segment, int count);
+
+    /*!
+     * \brief processBlock Vloží blok vzorků do omezovače a vydá zpožděné vzorky, jejichž zesílení je již známo.
+     * \param input Vstupní vzorky nebo nullptr pro ticho (flush).
+     * \param count Počet vzorků, nejvýše BLOCK_SIZE.
+     * \param output Pole pro nejvýše count výstupních vzorků.
+     * \return Počet zapsaných výstupních vzorků.
+     */
+    int processBlock(const float *input, int count, sample *output);
+
+    /*!
+     * \brief windowMinimums Spočítá klouzavá minima m_required přes okna délky m_windowSize (van Herk/Gil-Werman).
+     * \param from Index začátku prvního okna.
+     * \param count Počet oken.
+     * \param minimums Pole pro count minim.
+     */
+    void windowMinimums(int from, int count, float *minimums);
 };
 
 #endif
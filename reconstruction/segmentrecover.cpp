@@ -38,8 +38,14 @@ QVector<float> SegmentRecover::recover(QVector<float> espd) {
     return segment;
 }
 
+void SegmentRecover::setWhiteNoiseDirectory(const QString &directory) {
+    m_whiteNoiseDirectory = directory;
+    m_whiteNoise.clear();
+}
+
 void SegmentRecover::loadWhiteNoise() {
-    QString filename = QString("%1/noise_%2.raw").arg(QCoreApplication::applicationDirPath()).arg(m_segmentSize);
+    QString directory = m_whiteNoiseDirectory.isEmpty() ? QCoreApplication::applicationDirPath() : m_whiteNoiseDirectory;
+    QString filename = QString("%1/noise_%2.raw").arg(directory).arg(m_segmentSize);
     QFile file(filename);
     sample val;
 
@@ -29,7 +29,7 @@ struct polar_cpx {
  * Třída pomocí algoritmu Iterative Inverse Short-time Fourier Transform Magnitude algorithm dokáže obnovit
  * časový průbět segmentu z jeho odhadu výkonové spektrální hustoty. K jejímu správnému fungování je nutné,
  * aby ve složce, kde se vyskytuje finální spustitelný soubor, byl i soubor s bílým šumem o velikosti
- * m_segmentSize vzorků (např.: whitenoise_1024.raw).
+ * m_segmentSize vzorků (např.: whitenoise_1024.raw). Jiný adresář lze nastavit metodou setWhiteNoiseDirectory.
  */
 class SegmentRecover : public QObject {
     Q_OBJECT
@@ -54,15 +54,24 @@ public:
      */
     QVector<float> recover(QVector<float> espd);
 
+    /*!
+     * \brief setWhiteNoiseDirectory Nastaví adresář, ve kterém je hledán soubor s bílým šumem. Výchozím adresářem
+     *                               je adresář se spustitelným souborem.
+     * \param directory Cesta k adresáři se soubory noise_<velikost>.raw.
+     */
+    void setWhiteNoiseDirectory(const QString &directory);
+
 private:
     int m_segmentSize;              //!< Počet vzorků rekonstruovaných segmentů akustického signálu.
     int m_recoverIterations;        //!< Počet iterací algrogitmu Iterative Inverse Short-time Fourier Transform Magnitude algorithm
     FFT m_fft;                      //!< Objekt, který zabezpečuje výpočet Fourierovy transformace.
     QVector<float> m_whiteNoise;    //!< Vektro, který obsahuje načtený bílý šum.
+    QString m_whiteNoiseDirectory;  //!< Adresář se souborem bílého šumu (prázdný = adresář se spustitelným souborem).
 
     /*!
      * \brief loadWhiteNoise Metoda provádí načtení bílého šumu z externího souboru do vektoru m_whiteNoise,
-     *                       který je hledán v adresáři se spustitelným souborem. Pokud tento soubor není nalezen,
+     *                       který je hledán v adresáři se spustitelným souborem (nebo v adresáři nastaveném
+     *                       metodou setWhiteNoiseDirectory). Pokud tento soubor není nalezen,
      *                       emituje se chybový signál error. Metoda nijak nekontroluje vnitřní sturkturu zdrojového
      *                       souboru.
      */
@@ -0,0 +1,188 @@
+#include "resampler.h"
+#include "windowtable.h"
+
+#include <QtMath>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+/*!
+ * Podíl mezní frekvence propusti a nižší z Nyquistových frekvencí (ponechává místo pro přechodové pásmo).
+ */
+#define RESAMPLER_ROLLOFF 0.95
+
+/*!
+ * Parametr beta okna Kaiser (přibližně 80 dB potlačení v nepropustném pásmu).
+ */
+#define RESAMPLER_KAISER_BETA 8.0
+
+namespace {
+
+int greatestCommonDivisor(int a, int b) {
+    while (b != 0) {
+        int r = a % b;
+        a = b;
+        b = r;
+    }
+
+    return a;
+}
+
+/* Skalární součin dvou polí, délka je násobkem 4. */
+inline float dotProduct(const float *a, const float *b, int count) {
+#ifdef __SSE__
+    __m128 acc = _mm_setzero_ps();
+
+    for (int i = 0; i < count; i += 4)
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    return _mm_cvtss_f32(acc);
+#else
+    float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    for (int i = 0; i < count; i += 4) {
+        acc[0] += a[i] * b[i];
+        acc[1] += a[i + 1] * b[i + 1];
+        acc[2] += a[i + 2] * b[i + 2];
+        acc[3] += a[i + 3] * b[i + 3];
+    }
+
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+}
+
+inline sample toSample(float value) {
+    return static_cast<sample>(qRound(qBound(-32768.0f, value, 32767.0f)));
+}
+
+}
+
+Resampler::Resampler(int inputRate, int outputRate, int zeroCrossings, QObject *parent) : QObject(parent) {
+    m_inputRate = inputRate;
+    m_outputRate = outputRate;
+    m_upFactor = m_downFactor = 1;
+    m_taps = 0;
+
+    if (inputRate <= 0 || outputRate <= 0 || zeroCrossings <= 0) {
+        emit error("Resampler::Resampler: Neplatné frekvence vzorkování nebo délka propusti.");
+        m_inputRate = m_outputRate = 0;
+        return;
+    }
+
+    int divisor = greatestCommonDivisor(inputRate, outputRate);
+    m_upFactor = outputRate / divisor;
+    m_downFactor = inputRate / divisor;
+
+    if (m_upFactor != 1 || m_downFactor != 1)
+        designFilter(zeroCrossings);
+
+    reset();
+}
+
+int Resampler::inputRate() const {
+    return m_inputRate;
+}
+
+int Resampler::outputRate() const {
+    return m_outputRate;
+}
+
+int Resampler::maxOutputSize(int inputCount) const {
+    return static_cast<int>((static_cast<qint64>(inputCount) * m_upFactor) / m_downFactor) + 2;
+}
+
+int Resampler::process(const sample *input, int count, sample *output) {
+    if (!input || !output || count <= 0 || m_inputRate == 0)
+        return 0;
+
+    /* Shodné frekvence: pouze kopie. */
+    if (m_taps == 0) {
+        std::copy(input, input + count, output);
+        return count;
+    }
+
+    int history = m_taps - 1;
+    if (m_buffer.size() < history + count)
+        m_buffer.resize(history + count);
+
+    float *buffer = m_buffer.data();
+    for (int i = 0; i < count; i++)
+        buffer[history + i] = input[i];
+
+    const float *phases = m_phases.constData();
+    int written = 0;
+
+    if (m_upFactor == 1) {
+        /* Celočíselná decimace: jediná fáze, posun o M vstupních vzorků. */
+        for (; m_position < count; m_position += m_downFactor)
+            output[written++] = toSample(dotProduct(phases, buffer + m_position, m_taps));
+    }
+    else {
+        while (m_position < count) {
+            output[written++] = toSample(dotProduct(phases + m_phase * m_taps, buffer + m_position, m_taps));
+
+            m_phase += m_downFactor;
+            m_position += m_phase / m_upFactor;
+            m_phase %= m_upFactor;
+        }
+    }
+
+    /* Posledních m_taps - 1 vzorků zůstává jako historie pro další volání. */
+    m_position -= count;
+    std::copy(buffer + count, buffer + count + history, buffer);
+
+    return written;
+}
+
+QVector<sample> Resampler::process(const QVector<sample> &input) {
+    QVector<sample> output(maxOutputSize(input.size()));
+    output.resize(process(input.constData(), input.size(), output.data()));
+
+    return output;
+}
+
+QVector<sample> Resampler::flush() {
+    QVector<sample> output;
+
+    if (m_taps > 0)
+        output = process(QVector<sample>((m_taps + 1) / 2, 0));
+
+    reset();
+    return output;
+}
+
+void Resampler::reset() {
+    m_buffer.fill(0.0f, qMax(0, m_taps - 1));
+    m_position = 0;
+    m_phase = 0;
+}
+
+void Resampler::designFilter(int zeroCrossings) {
+    /* Prototyp propusti na frekvenci L * inputRate, perioda sinc je max(L, M) vzorků. */
+    int factor = qMax(m_upFactor, m_downFactor);
+    int length = 2 * zeroCrossings * factor + 1;
+    double center = (length - 1) / 2.0;
+    double cutoff = RESAMPLER_ROLLOFF * 0.5 / factor;
+    double norm = WindowTable::besselI0(RESAMPLER_KAISER_BETA);
+
+    int taps = (length + m_upFactor - 1) / m_upFactor;
+    m_taps = (taps + 3) & ~3;
+    m_phases.fill(0.0f, m_upFactor * m_taps);
+
+    for (int n = 0; n < length; n++) {
+        double x = n - center;
+        double sinc = (x == 0.0) ? 1.0 : qSin(2.0 * M_PI * cutoff * x) / (2.0 * M_PI * cutoff * x);
+        double ratio = x / center;
+        double window = WindowTable::besselI0(RESAMPLER_KAISER_BETA * qSqrt(qMax(0.0, 1.0 - ratio * ratio))) / norm;
+
+        // zesílení L kompenzuje vložené nuly
+        double h = m_upFactor * 2.0 * cutoff * sinc * window;
+
+        int phase = n % m_upFactor;
+        int tap = n / m_upFactor;
+        m_phases[phase * m_taps + (m_taps - 1 - tap)] = static_cast<float>(h);
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <QObject>
+#include <QVector>
+
+#include "pe_config.h"
+
+/*!
+ * \brief Třída Resampler
+ *
+ * Polyfázový převodník vzorkovací frekvence v racionálním poměru L/M (L = outputRate / g, M = inputRate / g,
+ * kde g je největší společný dělitel obou frekvencí). Slouží k převodu vstupů s různými frekvencemi vzorkování
+ * (8k, 16k, 44.1k, 48k) na jednu kanonickou frekvenci před rozdělením na segmenty (AudioSegmenter), takže stačí
+ * jediná banka filtrů a příznaky různých vstupů jsou porovnatelné.
+ *
+ * Prototypem je dolní propust s oknem Kaiser (sinc s zeroCrossings průchody nulou na každé straně) a mezní
+ * frekvencí rovnou nižší z obou Nyquistových frekvencí. Propust je rozložena do L fází, každá fáze je uložena
+ * souvisle a v obráceném pořadí, takže výpočet jednoho výstupního vzorku je skalární součin dvou souvislých polí
+ * (s využitím SSE, pokud je k dispozici). Pro celočíselnou decimaci (L = 1) se výpočet fází úplně vynechává
+ * a při shodných frekvencích se data pouze kopírují.
+ *
+ * Objekt si mezi voláními metody process pamatuje konec předchozích dat a pozici ve fázích, takže lze zpracovávat
+ * souvislý proud po libovolně velkých částech. Pro každý proud je nutné použít samostatný objekt. Výstup je oproti
+ * vstupu zpožděn o polovinu délky propusti.
+ */
+class Resampler : public QObject {
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief Resampler Konstruktor třídy. Navrhne propust a rozloží ji do fází.
+     * \param inputRate Frekvence vzorkování vstupního signálu.
+     * \param outputRate Požadovaná frekvence vzorkování výstupního signálu.
+     * \param zeroCrossings Počet průchodů nulou propusti na každé straně (kvalita vs. rychlost, obvykle 8 až 32).
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolnění).
+     */
+    explicit Resampler(int inputRate, int outputRate, int zeroCrossings = 16, QObject *parent = nullptr);
+
+    /*!
+     * \brief inputRate Vrací frekvenci vzorkování vstupního signálu.
+     * \return Frekvence vzorkování vstupu.
+     */
+    int inputRate() const;
+
+    /*!
+     * \brief outputRate Vrací frekvenci vzorkování výstupního signálu.
+     * \return Frekvence vzorkování výstupu.
+     */
+    int outputRate() const;
+
+    /*!
+     * \brief maxOutputSize Vrací nejvyšší možný počet výstupních vzorků pro daný počet vstupních vzorků.
+     * \param inputCount Počet vstupních vzorků.
+     * \return Počet vzorků, pro které musí být místo ve výstupním poli metody process.
+     */
+    int maxOutputSize(int inputCount) const;
+
+    /*!
+     * \brief process Převede další část vstupního proudu.
+     * \param input Ukazatel na vstupní vzorky.
+     * \param count Počet vstupních vzorků.
+     * \param output Ukazatel na pole o velikosti alespoň maxOutputSize(count) vzorků.
+     * \return Počet zapsaných výstupních vzorků.
+     */
+    int process(const sample *input, int count, sample *output);
+
+    /*!
+     * \brief process Přetížená metoda, jejíž výstup lze přímo předat metodě AudioSegmenter::writeAudio.
+     * \param input Vstupní vzorky.
+     * \return Výstupní vzorky.
+     */
+    QVector<sample> process(const QVector<sample> &input);
+
+    /*!
+     * \brief flush Doplní vstup nulami tak, aby byly vydány i vzorky odpovídající konci vstupu zadrženému
+     *              v propusti, a připraví objekt na zpracování dalšího proudu.
+     * \return Zbývající výstupní vzorky.
+     */
+    QVector<sample> flush();
+
+    /*!
+     * \brief reset Zahodí stav proudu (začátek nového proudu).
+     */
+    void reset();
+
+private:
+    int m_inputRate;                //!< Frekvence vzorkování vstupu.
+    int m_outputRate;               //!< Frekvence vzorkování výstupu.
+    int m_upFactor;                 //!< Interpolační faktor L.
+    int m_downFactor;               //!< Decimační faktor M.
+    int m_taps;                     //!< Počet koeficientů jedné fáze (zarovnaný na násobek 4).
+    QVector<float> m_phases;        //!< Koeficienty fází (L x m_taps), každá fáze v obráceném pořadí.
+
+    QVector<float> m_buffer;        //!< Pracovní buffer: m_taps - 1 vzorků historie následovaných novým vstupem.
+    int m_position;                 //!< Index vstupního vzorku dalšího výstupu relativně k začátku nového vstupu.
+    int m_phase;                    //!< Fáze dalšího výstupního vzorku.
+
+    /*!
+     * \brief designFilter Metoda navrhne prototyp propusti a rozloží jej do fází.
+     * \param zeroCrossings Počet průchodů nulou na každé straně.
+     */
+    void designFilter(int zeroCrossings);
+
+signals:
+    /*!
+     * \brief error Signál, který je emitován při chybě.
+     * \param message Popis chyby.
+     */
+    void error(QString message);
+};
+
+#endif
@@ -0,0 +1,217 @@
+#include "spectraldescriptors.h"
+
+#include <QtMath>
+
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+/* Součty jednoho průchodu spektrem. */
+struct SpectrumSums {
+    float magnitude;    // součet magnitud
+    float weighted;     // součet magnitud vážených indexem prvku
+    float flux;         // součet kvadrátů rozdílů magnitud od předchozího segmentu
+    float power;        // součet výkonů
+    double logPower;    // součet logaritmů výkonů s dolní mezí
+};
+
+/* Součin výkonů je udržován jako mantisa <1, 2) a součet exponentů, logaritmus se počítá až na konci průchodu. */
+inline void foldProduct(float *product, int *exponent) {
+    quint32 bits;
+    memcpy(&bits, product, sizeof(bits));
+
+    *exponent += static_cast<int>(bits >> 23) - 127;
+    bits = (bits & 0x007FFFFF) | 0x3F800000;
+    memcpy(product, &bits, sizeof(bits));
+}
+
+/* Jeden průchod spektrem, Power určuje, zda vstup obsahuje výkony (jinak magnitudy). */
+template <bool Power>
+SpectrumSums accumulate(const float *spectrum, float *previous, int size) {
+    SpectrumSums sums = {0.0f, 0.0f, 0.0f, 0.0f, 0.0};
+    float product = 1.0f;
+    int exponent = 0;
+    int k = 0;
+
+#ifdef __SSE2__
+    /* Čtyři prvky najednou, dílčí součty jsou sečteny až po průchodu. */
+    const __m128 floor = _mm_set1_ps(SPECTRAL_FLATNESS_FLOOR);
+    const __m128i mantissaMask = _mm_set1_epi32(0x007FFFFF);
+    const __m128i one = _mm_set1_epi32(0x3F800000);
+    __m128 magnitude = _mm_setzero_ps(), weighted = _mm_setzero_ps(), flux = _mm_setzero_ps();
+    __m128 power = _mm_setzero_ps(), products = _mm_set1_ps(1.0f);
+    __m128 index = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 step = _mm_set1_ps(4.0f);
+    __m128i exponents = _mm_setzero_si128();
+
+    for (; k + 4 <= size; k += 4) {
+        const __m128 value = _mm_loadu_ps(spectrum + k);
+        const __m128 m = Power ? _mm_sqrt_ps(value) : value;
+        const __m128 p = Power ? value : _mm_mul_ps(m, m);
+        const __m128 d = _mm_sub_ps(m, _mm_loadu_ps(previous + k));
+        _mm_storeu_ps(previous + k, m);
+
+        magnitude = _mm_add_ps(magnitude, m);
+        weighted = _mm_add_ps(weighted, _mm_mul_ps(index, m));
+        flux = _mm_add_ps(flux, _mm_mul_ps(d, d));
+        power = _mm_add_ps(power, p);
+        index = _mm_add_ps(index, step);
+
+        const __m128i bits = _mm_castps_si128(_mm_mul_ps(products, _mm_max_ps(p, floor)));
+        exponents = _mm_add_epi32(exponents, _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+        products = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, mantissaMask), one));
+    }
+
+    float lanes[4][4];
+    int lanesExponent[4];
+    _mm_storeu_ps(lanes[0], magnitude);
+    _mm_storeu_ps(lanes[1], weighted);
+    _mm_storeu_ps(lanes[2], flux);
+    _mm_storeu_ps(lanes[3], power);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanesExponent), exponents);
+
+    float lanesProduct[4];
+    _mm_storeu_ps(lanesProduct, products);
+
+    for (int j = 0; j < 4; j++) {
+        sums.magnitude += lanes[0][j];
+        sums.weighted += lanes[1][j];
+        sums.flux += lanes[2][j];
+        sums.power += lanes[3][j];
+        exponent += lanesExponent[j];
+        sums.logPower += qLn(lanesProduct[j]);
+    }
+#endif
+
+    for (; k < size; k++) {
+        const float m = Power ? qSqrt(spectrum[k]) : spectrum[k];
+        const float p = Power ? spectrum[k] : m * m;
+        const float d = m - previous[k];
+        previous[k] = m;
+
+        sums.magnitude += m;
+        sums.weighted += k * m;
+        sums.flux += d * d;
+        sums.power += p;
+
+        product *= qMax(p, SPECTRAL_FLATNESS_FLOOR);
+        foldProduct(&product, &exponent);
+    }
+
+    sums.logPower += qLn(product) + exponent * M_LN2;
+    return sums;
+}
+
+}
+
+SpectralDescriptors::SpectralDescriptors(int espdSize, int sampleRate, int descriptors, float rollOffFraction,
+                                         QObject *parent) : QObject(parent) {
+    m_espdSize = 0;
+    m_descriptors = 0;
+    m_binWidth = 0.0f;
+    m_rollOffFraction = rollOffFraction;
+    m_hasPrevious = false;
+
+    if (espdSize < 2 || sampleRate <= 0 || (descriptors & ~AllDescriptors) || !(rollOffFraction > 0.0f)
+            || rollOffFraction > 1.0f) {
+        emit error("SpectralDescriptors::SpectralDescriptors: Neplatné parametry deskriptorů.");
+        return;
+    }
+
+    m_espdSize = espdSize;
+    m_descriptors = descriptors;
+    m_binWidth = sampleRate / (2.0f * (espdSize - 1));
+    m_previous.fill(0.0f, espdSize);
+}
+
+int SpectralDescriptors::espdSize() const {
+    return m_espdSize;
+}
+
+int SpectralDescriptors::descriptors() const {
+    return m_descriptors;
+}
+
+int SpectralDescriptors::count() const {
+    return countOf(m_descriptors);
+}
+
+int SpectralDescriptors::countOf(int descriptors) {
+    int count = 0;
+
+    for (int flag = Centroid; flag <= Flatness; flag <<= 1) {
+        if (descriptors & flag)
+            count++;
+    }
+
+    return count;
+}
+
+void SpectralDescriptors::reset() {
+    m_hasPrevious = false;
+}
+
+void SpectralDescriptors::compute(const float *spectrum, float *output, bool power) {
+    float *previous = m_previous.data();
+
+    // bez předchozího spektra je flux nulový, rozdíly jsou pak počítány od sebe sama
+    if (!m_hasPrevious) {
+        for (int k = 0; k < m_espdSize; k++)
+            previous[k] = power ? qSqrt(spectrum[k]) : spectrum[k];
+    }
+
+    SpectrumSums sums = power ? accumulate<true>(spectrum, previous, m_espdSize)
+                              : accumulate<false>(spectrum, previous, m_espdSize);
+    m_hasPrevious = true;
+
+    if (m_descriptors & Centroid)
+        *output++ = (sums.magnitude > 0.0f) ? m_binWidth * (sums.weighted / sums.magnitude) : 0.0f;
+
+    if (m_descriptors & Flux)
+        *output++ = qSqrt(sums.flux);
+
+    if (m_descriptors & RollOff) {
+        /* Magnitudy segmentu jsou již uloženy, frekvence je dohledána v nich: nejprve po blocích 8 prvků
+         * (nezávislé součty), poté uvnitř bloku, ve kterém je mez překročena. */
+        const float threshold = m_rollOffFraction * sums.magnitude;
+        float cumulative = 0.0f;
+        int k = 0;
+
+        for (; k + 8 <= m_espdSize; k += 8) {
+            const float *block = previous + k;
+            float sum = ((block[0] + block[1]) + (block[2] + block[3])) + ((block[4] + block[5]) + (block[6] + block[7]));
+
+            if (cumulative + sum >= threshold)
+                break;
+
+            cumulative += sum;
+        }
+
+        while (k < m_espdSize - 1 && (cumulative += previous[k]) < threshold)
+            k++;
+
+        *output++ = (sums.magnitude > 0.0f) ? k * m_binWidth : 0.0f;
+    }
+
+    if (m_descriptors & Flatness) {
+        const double geometric = qExp(sums.logPower / m_espdSize);
+        const double arithmetic = qMax(sums.power / m_espdSize, SPECTRAL_FLATNESS_FLOOR);
+
+        *output = static_cast<float>(qMin(1.0, geometric / arithmetic));
+    }
+}
+
+QVector<float> SpectralDescriptors::compute(const QVector<float> &espd) {
+    if (m_espdSize == 0 || espd.size() != m_espdSize) {
+        emit error("SpectralDescriptors::compute: Velikost spektra neodpovídá nastavení deskriptorů.");
+        return QVector<float>();
+    }
+
+    QVector<float> output(count());
+    compute(espd.constData(), output.data());
+    return output;
+}
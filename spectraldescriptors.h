@@ -0,0 +1,126 @@
+#ifndef SPECTRALDESCRIPTORS_H
+#define SPECTRALDESCRIPTORS_H
+
+#include <QObject>
+#include <QVector>
+
+#include "pe_config.h"
+
+/*!
+ * Výchozí podíl součtu magnitud, pod kterým leží frekvence roll-off.
+ */
+#define SPECTRAL_ROLLOFF_FRACTION 0.85f
+
+/*!
+ * Dolní mez výkonu prvků spektra před logaritmem při výpočtu plochosti spektra.
+ */
+#define SPECTRAL_FLATNESS_FLOOR 1e-10f
+
+/*!
+ * \brief Třída SpectralDescriptors
+ *
+ * Třída počítá spektrální deskriptory segmentu z jeho spektra, tedy ze stejných dat, ze kterých jsou počítány MFC
+ * koeficienty (výstup FFT::transformEucl, resp. spektrum uvnitř FrameKernel), bez další FFT:
+ *
+ * - Centroid: těžiště magnitudového spektra v Hz,
+ * - Flux: eukleidovská vzdálenost magnitudového spektra od spektra předchozího segmentu (u prvního segmentu 0),
+ * - RollOff: frekvence v Hz, pod kterou leží daný podíl (výchozí 85 %) součtu magnitud,
+ * - Flatness: poměr geometrického a aritmetického průměru výkonového spektra (0 až 1).
+ *
+ * Všechny součty jsou počítány v jednom průchodu spektrem (s SSE2 po čtyřech prvcích), ve kterém je zároveň uloženo
+ * spektrum pro flux dalšího segmentu. Geometrický průměr je počítán ze součinu výkonů udržovaného jako mantisa
+ * a součet exponentů, logaritmus je tedy počítán až na konci průchodu. Frekvence roll-off je poté dohledána
+ * v uloženém spektru.
+ *
+ * Výstupem je count() hodnot v pořadí Centroid, Flux, RollOff, Flatness (jen zvolené deskriptory). Objekt uchovává
+ * spektrum předchozího segmentu, a proto nesmí být sdílen mezi více proudy.
+ */
+class SpectralDescriptors : public QObject {
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief Descriptor Příznaky počítaných deskriptorů.
+     */
+    enum Descriptor {
+        Centroid = 0x1,         //!< Spektrální těžiště (Hz).
+        Flux = 0x2,             //!< Spektrální tok.
+        RollOff = 0x4,          //!< Frekvence roll-off (Hz).
+        Flatness = 0x8,         //!< Plochost spektra.
+        AllDescriptors = 0xF    //!< Všechny deskriptory.
+    };
+
+    /*!
+     * \brief SpectralDescriptors Konstruktor třídy.
+     * \param espdSize Počet prvků spektra (fftSize / 2 + 1).
+     * \param sampleRate Frekvence vzorkování signálu.
+     * \param descriptors Kombinace příznaků Descriptor.
+     * \param rollOffFraction Podíl součtu magnitud pro frekvenci roll-off (0 až 1).
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolnění).
+     */
+    explicit SpectralDescriptors(int espdSize, int sampleRate, int descriptors = AllDescriptors,
+                                 float rollOffFraction = SPECTRAL_ROLLOFF_FRACTION, QObject *parent = nullptr);
+
+    /*!
+     * \brief espdSize Vrací počet prvků zpracovávaného spektra.
+     * \return Počet prvků spektra.
+     */
+    int espdSize() const;
+
+    /*!
+     * \brief descriptors Vrací příznaky počítaných deskriptorů.
+     * \return Kombinace příznaků Descriptor.
+     */
+    int descriptors() const;
+
+    /*!
+     * \brief count Vrací počet hodnot, které metoda compute zapisuje.
+     * \return Počet počítaných deskriptorů.
+     */
+    int count() const;
+
+    /*!
+     * \brief countOf Vrací počet deskriptorů dané kombinace příznaků.
+     * \param descriptors Kombinace příznaků Descriptor.
+     * \return Počet deskriptorů.
+     */
+    static int countOf(int descriptors);
+
+    /*!
+     * \brief reset Zahodí uložené spektrum předchozího segmentu (flux dalšího segmentu bude 0).
+     */
+    void reset();
+
+    /*!
+     * \brief compute Vypočítá deskriptory jednoho segmentu a uloží jeho spektrum. Metoda nekontroluje parametry
+     *                a nealokuje žádnou paměť.
+     * \param spectrum Ukazatel na espdSize() prvků magnitudového, případně výkonového spektra.
+     * \param output Ukazatel na pole, do kterého bude zapsáno count() hodnot.
+     * \param power True, pokud spektrum obsahuje kvadráty magnitud (výkonové spektrum), jinak false.
+     */
+    void compute(const float *spectrum, float *output, bool power = false);
+
+    /*!
+     * \brief compute Přetížená metoda pro výstup FFT::transformEucl.
+     * \param espd Magnitudové spektrum segmentu (espdSize() prvků).
+     * \return Vektor count() deskriptorů nebo prázdný vektor při chybě.
+     */
+    QVector<float> compute(const QVector<float> &espd);
+
+private:
+    int m_espdSize;             //!< Počet prvků spektra.
+    int m_descriptors;          //!< Příznaky počítaných deskriptorů.
+    float m_binWidth;           //!< Šířka prvku spektra v Hz.
+    float m_rollOffFraction;    //!< Podíl součtu magnitud pro frekvenci roll-off.
+    QVector<float> m_previous;  //!< Magnitudové spektrum předchozího segmentu.
+    bool m_hasPrevious;         //!< True, pokud je uloženo spektrum předchozího segmentu.
+
+signals:
+    /*!
+     * \brief error Signál, který je emitován při chybě.
+     * \param message Popis chyby.
+     */
+    void error(QString message);
+};
+
+#endif
@@ -0,0 +1,28 @@
+#include "standardwindow.h"
+
+StandardWindow::StandardWindow(WindowTable::Type type, int windowSize, float parameter, QObject *parent)
+        : WindowFunction(windowSize, parent) {
+    m_type = type;
+    m_parameter = parameter;
+
+    initWindow();
+}
+
+WindowTable::Type StandardWindow::type() const {
+    return m_type;
+}
+
+void StandardWindow::initWindow() {
+    if (m_window.size() <= 1) { // kvůli dělení nulou
+        emit error("StandardWindow::initWindow: Velikost okna nesmí být menší nebo rovna než 1.");
+        return;
+    }
+
+    const float *table = WindowTable::get(m_type, m_window.size(), m_parameter);
+    if (!table) {
+        emit error("StandardWindow::initWindow: Neznámý typ okna.");
+        return;
+    }
+
+    std::copy(table, table + m_window.size(), m_window.begin());
+}
@@ -0,0 +1,47 @@
+#ifndef STANDARDWINDOW_H
+#define STANDARDWINDOW_H
+
+#include <QObject>
+
+#include "windowfunction.h"
+#include "windowtable.h"
+
+/*!
+ * \brief Třída StandardWindow
+ *
+ * Třída je konkrétní implementací virtuální třídy WindowFunction pro všechna vestavěná okna (WindowTable::Type),
+ * tj. obdélníkové, Hammingovo, Hannovo, Blackmanovo, Poveyho a Kaiserovo okno. Vzorky okna jsou zkopírovány
+ * ze sdílené tabulky WindowTable, vytvoření dalšího okna stejného typu a velikosti tedy nepočítá žádné kosiny.
+ */
+class StandardWindow : public WindowFunction {
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief StandardWindow Konstruktor třídy.
+     * \param type Typ okna.
+     * \param windowSize Velikost vstupního segmentu.
+     * \param parameter Parametr okna (viz WindowTable::Type), WINDOW_DEFAULT_PARAMETER pro výchozí hodnotu.
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolňování).
+     */
+    explicit StandardWindow(WindowTable::Type type, int windowSize, float parameter = WINDOW_DEFAULT_PARAMETER,
+                            QObject *parent = nullptr);
+
+    /*!
+     * \brief type Vrací typ okna.
+     * \return Typ okna.
+     */
+    WindowTable::Type type() const;
+
+private:
+    WindowTable::Type m_type;   //!< Typ okna.
+    float m_parameter;          //!< Parametr okna.
+
+    /*!
+     * \brief initWindow Konkrétní implementace virtuální metody initWindow. Zkopíruje vzorky okna ze sdílené
+     *                   tabulky WindowTable.
+     */
+    void initWindow();
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "tensorview.h"
+
+#include <algorithm>
+
+TensorView::TensorView() {
+    m_data = nullptr;
+    m_frames = m_features = 0;
+    m_frameStride = m_featureStride = 0;
+}
+
+TensorView::TensorView(float *data, int frames, int features, qptrdiff frameStride, qptrdiff featureStride) {
+    m_data = data;
+    m_frames = qMax(0, frames);
+    m_features = qMax(0, features);
+    m_frameStride = frameStride;
+    m_featureStride = featureStride;
+}
+
+TensorView TensorView::frameMajor(float *data, int frames, int features) {
+    return TensorView(data, frames, features, features, 1);
+}
+
+TensorView TensorView::coefficientMajor(float *data, int frames, int features) {
+    return TensorView(data, frames, features, 1, frames);
+}
+
+TensorView TensorView::batchItem(float *data, int index, int frames, int features, Layout layout) {
+    if (!data || index < 0)
+        return TensorView();
+
+    float *item = data + static_cast<qptrdiff>(index) * frames * features;
+
+    return (layout == FrameMajor) ? frameMajor(item, frames, features) : coefficientMajor(item, frames, features);
+}
+
+bool TensorView::isNull() const {
+    return !m_data || m_frames == 0 || m_features == 0;
+}
+
+float *TensorView::data() const {
+    return m_data;
+}
+
+int TensorView::frames() const {
+    return m_frames;
+}
+
+int TensorView::features() const {
+    return m_features;
+}
+
+qptrdiff TensorView::frameStride() const {
+    return m_frameStride;
+}
+
+qptrdiff TensorView::featureStride() const {
+    return m_featureStride;
+}
+
+bool TensorView::hasContiguousFrames() const {
+    return m_featureStride == 1;
+}
+
+float *TensorView::frame(int t) const {
+    return m_data + t * m_frameStride;
+}
+
+TensorView TensorView::mid(int from, int count) const {
+    if (from < 0 || from > m_frames || count < 0)
+        return TensorView();
+
+    return TensorView(frame(from), qMin(count, m_frames - from), m_features, m_frameStride, m_featureStride);
+}
+
+void TensorView::store(int t, const float *values) const {
+    float *output = frame(t);
+
+    if (m_featureStride == 1) {
+        std::copy(values, values + m_features, output);
+        return;
+    }
+
+    for (int f = 0; f < m_features; f++)
+        output[f * m_featureStride] = values[f];
+}
+
+void TensorView::fill(int from, int to, float value) const {
+    from = qMax(0, from);
+    to = qMin(m_frames, to);
+
+    /* Souvislý blok segmentů (FrameMajor bez mezer) je vyplněn najednou. */
+    if (m_featureStride == 1 && m_frameStride == m_features) {
+        if (from < to)
+            std::fill(frame(from), frame(to), value);
+        return;
+    }
+
+    for (int t = from; t < to; t++) {
+        float *output = frame(t);
+
+        for (int f = 0; f < m_features; f++)
+            output[f * m_featureStride] = value;
+    }
+}
@@ -0,0 +1,155 @@
+#ifndef TENSORVIEW_H
+#define TENSORVIEW_H
+
+#include <QtGlobal>
+
+/*!
+ * \brief Třída TensorView
+ *
+ * Třída představuje pohled na souvislé pole typu float, které vlastní volající (např. vstupní tenzor inferenčního
+ * enginu), jako na matici frames x features s explicitními kroky (strides, v prvcích typu float). Výpočty
+ * (FrameKernel, OfflineExtractor, MfccFile) do pohledu zapisují přímo, výstup tak není nutné přeskládávat ani
+ * alokovat zvláštní pole pro každou dávku. Pohled nic nealokuje ani neuvolňuje, a proto jej lze kopírovat hodnotou.
+ *
+ * Podporována jsou rozložení FrameMajor (frames x features, vektor jednoho segmentu je souvislý) a CoefficientMajor
+ * (features x frames, průběh jednoho koeficientu v čase je souvislý). Dávka více proudů doplněných na stejnou délku
+ * (batch x frames x features, případně batch x features x frames) je tvořena pohledy batchItem na jednotlivé proudy.
+ */
+class TensorView {
+
+public:
+    /*!
+     * \brief Layout Rozložení matice v paměti.
+     */
+    enum Layout {
+        FrameMajor,         //!< Řádky jsou segmenty (frames x features).
+        CoefficientMajor    //!< Řádky jsou koeficienty (features x frames).
+    };
+
+    /*!
+     * \brief TensorView Konstruktor prázdného (neplatného) pohledu.
+     */
+    TensorView();
+
+    /*!
+     * \brief TensorView Konstruktor pohledu s obecnými kroky.
+     * \param data Ukazatel na prvek [0, 0].
+     * \param frames Počet segmentů (řádků pro FrameMajor).
+     * \param features Počet prvků vektoru jednoho segmentu.
+     * \param frameStride Vzdálenost sousedních segmentů v prvcích.
+     * \param featureStride Vzdálenost sousedních prvků vektoru v prvcích.
+     */
+    TensorView(float *data, int frames, int features, qptrdiff frameStride, qptrdiff featureStride);
+
+    /*!
+     * \brief frameMajor Vytvoří pohled na souvislou matici frames x features.
+     * \param data Ukazatel na frames * features prvků.
+     * \param frames Počet segmentů.
+     * \param features Počet prvků vektoru jednoho segmentu.
+     * \return Pohled na matici.
+     */
+    static TensorView frameMajor(float *data, int frames, int features);
+
+    /*!
+     * \brief coefficientMajor Vytvoří pohled na souvislou matici features x frames.
+     * \param data Ukazatel na frames * features prvků.
+     * \param frames Počet segmentů.
+     * \param features Počet prvků vektoru jednoho segmentu.
+     * \return Pohled na matici.
+     */
+    static TensorView coefficientMajor(float *data, int frames, int features);
+
+    /*!
+     * \brief batchItem Vytvoří pohled na jeden proud souvislé dávky batch x frames x features (FrameMajor), resp.
+     *                  batch x features x frames (CoefficientMajor).
+     * \param data Ukazatel na začátek dávky.
+     * \param index Index proudu v dávce.
+     * \param frames Počet segmentů každého proudu (délka, na kterou jsou proudy doplněny).
+     * \param features Počet prvků vektoru jednoho segmentu.
+     * \param layout Rozložení matice jednoho proudu.
+     * \return Pohled na matici proudu index.
+     */
+    static TensorView batchItem(float *data, int index, int frames, int features, Layout layout = FrameMajor);
+
+    /*!
+     * \brief isNull Zjistí, zda je pohled prázdný (bez dat nebo s nulovým rozměrem).
+     * \return True, pokud je pohled prázdný, jinak false.
+     */
+    bool isNull() const;
+
+    /*!
+     * \brief data Vrací ukazatel na prvek [0, 0].
+     * \return Ukazatel na data.
+     */
+    float *data() const;
+
+    /*!
+     * \brief frames Vrací počet segmentů.
+     * \return Počet segmentů.
+     */
+    int frames() const;
+
+    /*!
+     * \brief features Vrací počet prvků vektoru jednoho segmentu.
+     * \return Počet prvků vektoru.
+     */
+    int features() const;
+
+    /*!
+     * \brief frameStride Vrací vzdálenost sousedních segmentů v prvcích.
+     * \return Krok segmentů.
+     */
+    qptrdiff frameStride() const;
+
+    /*!
+     * \brief featureStride Vrací vzdálenost sousedních prvků vektoru v prvcích.
+     * \return Krok prvků vektoru.
+     */
+    qptrdiff featureStride() const;
+
+    /*!
+     * \brief hasContiguousFrames Zjistí, zda jsou prvky vektoru jednoho segmentu uloženy za sebou (featureStride 1),
+     *                            tj. zda lze výpočet zapisovat přímo na adresu frame(t).
+     * \return True, pokud jsou vektory segmentů souvislé, jinak false.
+     */
+    bool hasContiguousFrames() const;
+
+    /*!
+     * \brief frame Vrací ukazatel na první prvek vektoru daného segmentu.
+     * \param t Index segmentu.
+     * \return Ukazatel na prvek [t, 0].
+     */
+    float *frame(int t) const;
+
+    /*!
+     * \brief mid Vrací pohled na count segmentů počínaje segmentem from (např. pro zápis po blocích).
+     * \param from Index prvního segmentu.
+     * \param count Počet segmentů (omezený koncem pohledu).
+     * \return Pohled na část segmentů nebo prázdný pohled při neplatném rozsahu.
+     */
+    TensorView mid(int from, int count) const;
+
+    /*!
+     * \brief store Zapíše vektor jednoho segmentu podle kroků pohledu.
+     * \param t Index segmentu.
+     * \param values Ukazatel na features() prvků vektoru.
+     */
+    void store(int t, const float *values) const;
+
+    /*!
+     * \brief fill Vyplní segmenty from až to - 1 danou hodnotou (doplnění kratších proudů dávky).
+     * \param from Index prvního vyplněného segmentu.
+     * \param to Index za posledním vyplněným segmentem.
+     * \param value Hodnota výplně.
+     */
+    void fill(int from, int to, float value = 0.0f) const;
+
+private:
+    float *m_data;              //!< Ukazatel na prvek [0, 0] (nevlastněný).
+    int m_frames;               //!< Počet segmentů.
+    int m_features;             //!< Počet prvků vektoru jednoho segmentu.
+    qptrdiff m_frameStride;     //!< Vzdálenost sousedních segmentů v prvcích.
+    qptrdiff m_featureStride;   //!< Vzdálenost sousedních prvků vektoru v prvcích.
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include <QtTest>
+
+#include "testdata.h"
+
+#include "../hammingwindow.h"
+#include "../reconstruction/audiocomposer.h"
+
+/*
+ * Vážené sčítání s překryvem: segmenty nezměněného signálu se musí složit zpět na původní signál, a to pro libovolný
+ * překryv, okna i proudový režim.
+ */
+class AudioComposerTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void invalidWindows();
+    void rectangularReconstruction();
+    void hammingReconstruction();
+    void streamingMatchesStored();
+};
+
+namespace {
+
+const int SEGMENTS = 30;
+
+/* Segmenty signálu s daným překryvem, volitelně vážené analyzačním oknem. */
+QVector<QVector<float>> split(const QVector<sample> &signal, int segmentSize, int overlap,
+                              WindowFunction *window = nullptr) {
+    QVector<QVector<float>> segments;
+
+    for (int from = 0; from + segmentSize <= signal.size(); from += segmentSize - overlap) {
+        QVector<sample> segment = signal.mid(from, segmentSize);
+
+        if (window != nullptr) {
+            segments.append(window->normalize(segment));
+        }
+        else {
+            segments.append(QVector<float>(segmentSize));
+            std::copy(segment.constBegin(), segment.constEnd(), segments.last().begin());
+        }
+    }
+
+    return segments;
+}
+
+/* Ověří, že se sestavený signál shoduje s původním s relativní tolerancí k amplitudě. */
+bool matches(const QVector<float> &audio, const QVector<sample> &signal, float tolerance) {
+    if (audio.size() != signal.size())
+        return false;
+
+    for (int i = 0; i < signal.size(); i++) {
+        if (qAbs(audio[i] - signal[i]) > tolerance * (1.0f + qAbs(signal[i])))
+            return false;
+    }
+
+    return true;
+}
+
+}
+
+void AudioComposerTest::invalidWindows() {
+    AudioComposer composer(SEGMENT_SIZE, OVERLAP);
+    QVector<float> window(SEGMENT_SIZE, 1.0f);
+
+    QVERIFY(!composer.setWindows(window.mid(1), window));
+    QVERIFY(!composer.setWindows(window, QVector<float>(SEGMENT_SIZE, 0.0f)));
+    QVERIFY(composer.setWindows(window, window));
+}
+
+void AudioComposerTest::rectangularReconstruction() {
+    const int overlaps[] = {0, OVERLAP, SEGMENT_SIZE / 2, SEGMENT_SIZE - 1};
+
+    for (int overlap : overlaps) {
+        QVector<sample> signal = testSignal(SEGMENT_SIZE + (SEGMENTS - 1) * (SEGMENT_SIZE - overlap));
+
+        for (bool average : {true, false}) {
+            AudioComposer composer(SEGMENT_SIZE, overlap, average);
+
+            for (const QVector<float> &segment : split(signal, SEGMENT_SIZE, overlap))
+                composer.add(segment);
+
+            QVERIFY2(matches(composer.getAudio(), signal, 1e-5f),
+                     qPrintable(QString("překryv %1, průměrování %2").arg(overlap).arg(average)));
+        }
+    }
+}
+
+void AudioComposerTest::hammingReconstruction() {
+    const int overlaps[] = {OVERLAP, SEGMENT_SIZE / 2, SEGMENT_SIZE / 4};
+
+    for (int overlap : overlaps) {
+        QVector<sample> signal = testSignal(SEGMENT_SIZE + (SEGMENTS - 1) * (SEGMENT_SIZE - overlap));
+
+        // segmenty vážené Hammingovým oknem, stejné okno jako analyzační i syntézní (WOLA)
+        HammingWindow window(SEGMENT_SIZE);
+        AudioComposer composer(SEGMENT_SIZE, overlap);
+        QVERIFY(composer.setWindows(window.coefficients(), window.coefficients()));
+
+        for (const QVector<float> &segment : split(signal, SEGMENT_SIZE, overlap, &window))
+            composer.add(segment);
+
+        composer.flush();
+        QVERIFY2(matches(composer.getAudio(), signal, 1e-4f), qPrintable(QString("překryv %1").arg(overlap)));
+    }
+}
+
+void AudioComposerTest::streamingMatchesStored() {
+    QVector<sample> signal = testSignal(SEGMENT_SIZE + (SEGMENTS - 1) * (SEGMENT_SIZE - OVERLAP));
+    HammingWindow window(SEGMENT_SIZE);
+    QVector<QVector<float>> segments = split(signal, SEGMENT_SIZE, OVERLAP, &window);
+
+    AudioComposer stored(SEGMENT_SIZE, OVERLAP);
+    QVERIFY(stored.setWindows(window.coefficients(), window.coefficients()));
+
+    AudioComposer streaming(SEGMENT_SIZE, OVERLAP);
+    QVERIFY(streaming.setWindows(window.coefficients(), window.coefficients()));
+    streaming.setStreaming(true);
+
+    QVector<float> composed;
+    connect(&streaming, &AudioComposer::audioComposed, [&composed](const float *audio, int size) {
+        for (int i = 0; i < size; i++)
+            composed.append(audio[i]);
+    });
+
+    for (const QVector<float> &segment : segments) {
+        stored.add(segment);
+        streaming.add(segment);
+    }
+
+    // v proudovém režimu zbývá jen nedokončený konec, který předá až flush
+    QCOMPARE(streaming.getAudio().size(), OVERLAP);
+    streaming.flush();
+    stored.flush();
+
+    QCOMPARE(composed, stored.getAudio());
+    QVERIFY(streaming.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(AudioComposerTest)
+
+#include "audiocomposertest.moc"
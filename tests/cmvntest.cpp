@@ -0,0 +1,178 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include <cmath>
+
+#include "testdata.h"
+
+#include "../cmvn.h"
+#include "../tensorview.h"
+
+/*
+ * Normalizace střední hodnoty a rozptylu ve všech režimech, uložení a načtení statistik a normalizace matice.
+ */
+class CmvnTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void utterance();
+    void meanOnly();
+    void globalWithoutStats();
+    void statsRoundTrip();
+    void sliding();
+    void tensorMatchesContiguous();
+};
+
+namespace {
+
+const int FRAMES = 400;
+const int COEFS = 13;
+
+/* Střední hodnota a rozptyl sloupce j souvislé matice. */
+void columnStats(const QVector<float> &matrix, int frames, int j, double *mean, double *variance) {
+    double sum = 0.0, sumSquares = 0.0;
+
+    for (int t = 0; t < frames; t++) {
+        double value = matrix[t * COEFS + j];
+        sum += value;
+        sumSquares += value * value;
+    }
+
+    *mean = sum / frames;
+    *variance = sumSquares / frames - *mean * *mean;
+}
+
+}
+
+void CmvnTest::utterance() {
+    QVector<float> features = testFeatures(FRAMES, COEFS);
+    Cmvn cmvn(COEFS, Cmvn::Utterance);
+    QVERIFY(cmvn.normalize(features.data(), FRAMES));
+
+    for (int j = 0; j < COEFS; j++) {
+        double mean, variance;
+        columnStats(features, FRAMES, j, &mean, &variance);
+
+        QVERIFY(qAbs(mean) < 1e-4);
+        QVERIFY(qAbs(variance - 1.0) < 1e-3);
+    }
+}
+
+void CmvnTest::meanOnly() {
+    QVector<float> original = testFeatures(FRAMES, COEFS);
+    QVector<float> features = original;
+    Cmvn cmvn(COEFS, Cmvn::Utterance, false);
+    QVERIFY(cmvn.normalize(features.data(), FRAMES));
+
+    for (int j = 0; j < COEFS; j++) {
+        double mean, variance, originalMean, originalVariance;
+        columnStats(features, FRAMES, j, &mean, &variance);
+        columnStats(original, FRAMES, j, &originalMean, &originalVariance);
+
+        QVERIFY(qAbs(mean) < 1e-3);
+        QVERIFY(qAbs(variance - originalVariance) < 1e-3 * originalVariance);
+    }
+}
+
+void CmvnTest::globalWithoutStats() {
+    QVector<float> features = testFeatures(FRAMES, COEFS);
+    QVector<float> original = features;
+
+    Cmvn cmvn(COEFS, Cmvn::Global);
+    QString message;
+    connect(&cmvn, &Cmvn::error, [&message](QString error) { message = error; });
+
+    QVERIFY(!cmvn.normalize(features.data()));
+    QVERIFY(!message.isEmpty());
+    QCOMPARE(features, original);
+}
+
+void CmvnTest::statsRoundTrip() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QVector<float> features = testFeatures(FRAMES, COEFS);
+
+    // statistiky nasčítané ze stejných dat odpovídají normalizaci celé promluvy
+    Cmvn accumulator(COEFS, Cmvn::Global);
+    for (int t = 0; t < FRAMES; t++)
+        accumulator.accumulate(features.constData() + t * COEFS);
+    QVERIFY(accumulator.saveStats(dir.filePath("stats.cmvn")));
+
+    Cmvn global(COEFS, Cmvn::Global);
+    QVERIFY(global.loadStats(dir.filePath("stats.cmvn")));
+
+    QVector<float> expected = features;
+    Cmvn utterance(COEFS, Cmvn::Utterance);
+    QVERIFY(utterance.normalize(expected.data(), FRAMES));
+
+    QVERIFY(global.normalize(features.data(), FRAMES));
+    for (int i = 0; i < features.size(); i++)
+        QVERIFY(qAbs(features[i] - expected[i]) < 1e-4f * (1.0f + qAbs(expected[i])));
+
+    // statistiky s jiným počtem koeficientů nelze načíst
+    Cmvn other(COEFS + 1, Cmvn::Global);
+    QVERIFY(!other.loadStats(dir.filePath("stats.cmvn")));
+    QVERIFY(!other.loadStats(dir.filePath("missing.cmvn")));
+}
+
+void CmvnTest::sliding() {
+    const int window = 50;
+    QVector<float> features = testFeatures(FRAMES, COEFS);
+    QVector<float> original = features;
+
+    Cmvn cmvn(COEFS, Cmvn::Sliding, true, window);
+
+    // po zaplnění okna odpovídá normalizace statistikám posledních window vektorů (včetně aktuálního)
+    for (int t = 0; t < FRAMES; t++) {
+        QVERIFY(cmvn.normalize(features.data() + t * COEFS));
+
+        if (t < window - 1 || t % 37 != 0)
+            continue;
+
+        QVector<float> last = original.mid((t - window + 1) * COEFS, window * COEFS);
+
+        for (int j = 0; j < COEFS; j++) {
+            double mean, variance;
+            columnStats(last, window, j, &mean, &variance);
+
+            double expected = (original[t * COEFS + j] - mean) / std::sqrt(variance);
+            QVERIFY2(qAbs(features[t * COEFS + j] - expected) < 1e-3 * (1.0 + qAbs(expected)),
+                     qPrintable(QString("vektor %1, koeficient %2").arg(t).arg(j)));
+        }
+    }
+}
+
+void CmvnTest::tensorMatchesContiguous() {
+    const Cmvn::Mode modes[] = {Cmvn::Utterance, Cmvn::Sliding};
+
+    for (Cmvn::Mode mode : modes) {
+        QVector<float> expected = testFeatures(FRAMES, COEFS);
+        Cmvn contiguous(COEFS, mode, true, 100);
+        QVERIFY(contiguous.normalize(expected.data(), FRAMES));
+
+        // matice po koeficientech se třemi segmenty doplnění navíc, které normalizace nepřepíše
+        QVector<float> transposed((FRAMES + 3) * COEFS, -1.0f);
+        TensorView view = TensorView::coefficientMajor(transposed.data(), FRAMES + 3, COEFS);
+        QVector<float> features = testFeatures(FRAMES, COEFS);
+        for (int t = 0; t < FRAMES; t++)
+            view.store(t, features.constData() + t * COEFS);
+
+        Cmvn tensor(COEFS, mode, true, 100);
+        QVERIFY(tensor.normalize(view.mid(0, FRAMES)));
+
+        for (int t = 0; t < FRAMES + 3; t++) {
+            for (int j = 0; j < COEFS; j++) {
+                float value = view.frame(t)[j * view.featureStride()];
+
+                if (t < FRAMES)
+                    QVERIFY(qAbs(value - expected[t * COEFS + j]) < 1e-5f * (1.0f + qAbs(value)));
+                else QCOMPARE(value, -1.0f);
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(CmvnTest)
+
+#include "cmvntest.moc"
@@ -0,0 +1,152 @@
+#include <QtTest>
+
+#include <algorithm>
+
+#include "testdata.h"
+
+#include "../deltafeatures.h"
+#include "../tensorview.h"
+
+/*
+ * Dynamické koeficienty: proudové zpracování, dávkový výpočet a výpočet na místě v matici dávají stejné výsledky.
+ */
+class DeltaFeaturesTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void invalidInput();
+    void linearRamp();
+    void streamMatchesBatch();
+    void tensorMatchesBatch();
+};
+
+namespace {
+
+const int FRAMES = 50;
+const int COEFS = 13;
+
+}
+
+void DeltaFeaturesTest::invalidInput() {
+    DeltaFeatures deltas(COEFS);
+    QVector<float> matrix(FRAMES * 2 * COEFS);
+
+    // matice musí mít přesně (1 + order) * COEFS prvků na segment
+    QVERIFY(!deltas.calculate(TensorView::frameMajor(matrix.data(), FRAMES, 2 * COEFS), 2));
+    QVERIFY(!deltas.calculate(TensorView::frameMajor(matrix.data(), FRAMES, 2 * COEFS), 3));
+    QVERIFY(deltas.calculate(TensorView::frameMajor(matrix.data(), FRAMES, 2 * COEFS), 1));
+
+    QVector<QVector<float>> wrongSize(3, QVector<float>(COEFS - 1));
+    QVERIFY(deltas.calculate(wrongSize).isEmpty());
+}
+
+void DeltaFeaturesTest::linearRamp() {
+    DeltaFeatures deltas(COEFS);
+    QVector<float> coefs(FRAMES * COEFS);
+
+    // c[t] = (j + 1) * t: uvnitř promluvy je delta rovna j + 1 a delta-delta nulová
+    for (int t = 0; t < FRAMES; t++) {
+        for (int j = 0; j < COEFS; j++)
+            coefs[t * COEFS + j] = (j + 1.0f) * t;
+    }
+
+    QVector<float> output(FRAMES * deltas.outputSize());
+    QVERIFY(deltas.calculate(coefs.constData(), FRAMES, output.data()));
+
+    for (int t = 2 * deltas.latency(); t < FRAMES - 2 * deltas.latency(); t++) {
+        const float *vector = output.constData() + t * deltas.outputSize();
+
+        for (int j = 0; j < COEFS; j++) {
+            QCOMPARE(vector[j], coefs[t * COEFS + j]);
+            QCOMPARE(vector[COEFS + j], j + 1.0f);
+            QVERIFY(qAbs(vector[2 * COEFS + j]) < 1e-4f);
+        }
+    }
+}
+
+void DeltaFeaturesTest::streamMatchesBatch() {
+    QVector<float> coefs = testFeatures(FRAMES, COEFS);
+
+    for (int window = 1; window <= 3; window++) {
+        DeltaFeatures deltas(COEFS, window);
+        int size = deltas.outputSize();
+
+        QVector<float> expected(FRAMES * size);
+        QVERIFY(deltas.calculate(coefs.constData(), FRAMES, expected.data()));
+
+        QVector<float> output(FRAMES * size);
+        int written = 0;
+
+        for (int t = 0; t < FRAMES; t++) {
+            if (deltas.push(coefs.constData() + t * COEFS, output.data() + written * size))
+                written++;
+        }
+
+        QCOMPARE(written, FRAMES - deltas.latency());
+        written += deltas.flush(output.data() + written * size);
+        QCOMPARE(written, FRAMES);
+        QCOMPARE(output, expected);
+
+        // přetížení nad vektory vektorů
+        QVector<QVector<float>> vectors;
+        for (int t = 0; t < FRAMES; t++)
+            vectors.append(coefs.mid(t * COEFS, COEFS));
+
+        QVector<QVector<float>> result = deltas.calculate(vectors);
+        QCOMPARE(result.size(), FRAMES);
+
+        for (int t = 0; t < FRAMES; t++)
+            QVERIFY(std::equal(result[t].constBegin(), result[t].constEnd(), expected.constBegin() + t * size));
+    }
+}
+
+void DeltaFeaturesTest::tensorMatchesBatch() {
+    QVector<float> coefs = testFeatures(FRAMES, COEFS);
+    DeltaFeatures deltas(COEFS);
+    int size = deltas.outputSize();
+
+    QVector<float> expected(FRAMES * size);
+    QVERIFY(deltas.calculate(coefs.constData(), FRAMES, expected.data()));
+
+    QVector<float> frameMajor(FRAMES * size);
+    QVector<float> coefficientMajor(FRAMES * size);
+    QVector<float> strided(FRAMES * (size + 2), -1.0f);
+
+    TensorView views[] = {TensorView::frameMajor(frameMajor.data(), FRAMES, size),
+                          TensorView::coefficientMajor(coefficientMajor.data(), FRAMES, size),
+                          TensorView(strided.data(), FRAMES, size, size + 2, 1)};
+
+    for (const TensorView &view : views) {
+        // statické koeficienty v prvních COEFS prvcích, zbytek se dopočítá na místě
+        for (int t = 0; t < FRAMES; t++) {
+            for (int j = 0; j < COEFS; j++)
+                view.frame(t)[j * view.featureStride()] = coefs[t * COEFS + j];
+        }
+
+        QVERIFY(deltas.calculate(view));
+
+        for (int t = 0; t < FRAMES; t++) {
+            for (int j = 0; j < size; j++)
+                QCOMPARE(view.frame(t)[j * view.featureStride()], expected[t * size + j]);
+        }
+    }
+
+    // pouze delta koeficienty (rozložení _D)
+    QVector<float> first(FRAMES * 2 * COEFS);
+    TensorView view = TensorView::coefficientMajor(first.data(), FRAMES, 2 * COEFS);
+    for (int t = 0; t < FRAMES; t++) {
+        for (int j = 0; j < COEFS; j++)
+            view.frame(t)[j * view.featureStride()] = coefs[t * COEFS + j];
+    }
+
+    QVERIFY(deltas.calculate(view, 1));
+
+    for (int t = 0; t < FRAMES; t++) {
+        for (int j = 0; j < 2 * COEFS; j++)
+            QCOMPARE(view.frame(t)[j * view.featureStride()], expected[t * size + j]);
+    }
+}
+
+QTEST_APPLESS_MAIN(DeltaFeaturesTest)
+
+#include "deltafeaturestest.moc"
@@ -0,0 +1,133 @@
+#include <QtTest>
+
+#include "testdata.h"
+
+#include "../fft.h"
+#include "../framekernel.h"
+#include "../hammingwindow.h"
+#include "../mfcc.h"
+#include "../tensorview.h"
+
+/*
+ * FrameKernel musí ve všech výstupních režimech dávat přesně stejné výsledky jako postupný výpočet
+ * (HammingWindow, FFT, MFCC), a to pro libovolné rozložení výstupní matice.
+ */
+class FrameKernelTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void outputSize();
+    void fusedMatchesStaged();
+    void tensorMatchesContiguous();
+
+private:
+    QVector<float> staged(const QVector<sample> &segment, FrameKernel::OutputMode mode, FFT::SizePolicy policy,
+                          int filtersCount, int coefsCount);
+};
+
+QVector<float> FrameKernelTest::staged(const QVector<sample> &segment, FrameKernel::OutputMode mode,
+                                       FFT::SizePolicy policy, int filtersCount, int coefsCount) {
+    HammingWindow window(segment.size());
+    FFT fft(segment.size(), policy);
+    MFCC mfcc(SAMPLE_RATE, filtersCount, fft.espdSize());
+
+    QVector<float> windowed = window.normalize(segment);
+
+    switch (mode) {
+    case FrameKernel::Magnitude:
+        return fft.transformEucl(windowed);
+    case FrameKernel::Power:
+        return fft.transformPower(windowed);
+    case FrameKernel::LogMel:
+        return mfcc.calculateLogMel(fft.transformPower(windowed));
+    default:
+        return mfcc.calculate(fft.transformEucl(windowed), coefsCount);
+    }
+}
+
+void FrameKernelTest::outputSize() {
+    FrameKernel kernel(SEGMENT_SIZE, SAMPLE_RATE, NUM_FILTERS, MFCC_COUNT);
+    QCOMPARE(kernel.outputMode(), FrameKernel::Mfcc);
+    QCOMPARE(kernel.outputSize(), MFCC_COUNT);
+
+    QVERIFY(kernel.setOutputMode(FrameKernel::Magnitude));
+    QCOMPARE(kernel.outputSize(), kernel.espdSize());
+
+    QVERIFY(kernel.setOutputMode(FrameKernel::Power));
+    QCOMPARE(kernel.outputSize(), kernel.espdSize());
+
+    QVERIFY(kernel.setOutputMode(FrameKernel::LogMel));
+    QCOMPARE(kernel.outputSize(), NUM_FILTERS);
+}
+
+void FrameKernelTest::fusedMatchesStaged() {
+    const FrameKernel::OutputMode modes[] = {FrameKernel::Magnitude, FrameKernel::Power, FrameKernel::LogMel,
+                                             FrameKernel::Mfcc};
+    // velikost segmentu, překryv, velikost FFT
+    const int configs[][3] = {{256, 128, FFT::PowerOfTwo}, {SEGMENT_SIZE, OVERLAP, FFT::PowerOfTwo},
+                              {1103, 662, FFT::NextFastSize}};
+
+    for (const auto &config : configs) {
+        int segmentSize = config[0];
+        int hop = segmentSize - config[1];
+        FFT::SizePolicy policy = static_cast<FFT::SizePolicy>(config[2]);
+        QVector<sample> signal = testSignal(segmentSize + 8 * hop);
+
+        for (FrameKernel::OutputMode mode : modes) {
+            FrameKernel kernel(segmentSize, SAMPLE_RATE, NUM_FILTERS, MFCC_COUNT, policy);
+            QVERIFY(kernel.setOutputMode(mode));
+
+            QVector<float> fused(kernel.outputSize());
+
+            for (int f = 0; f <= 8; f++) {
+                QVector<sample> segment = signal.mid(f * hop, segmentSize);
+                QVERIFY(kernel.process(segment.constData(), fused.data()));
+
+                QVector<float> expected = staged(segment, mode, policy, NUM_FILTERS, MFCC_COUNT);
+                QCOMPARE(fused, expected);
+            }
+        }
+    }
+}
+
+void FrameKernelTest::tensorMatchesContiguous() {
+    const int frames = 12;
+    const int hop = SEGMENT_SIZE - OVERLAP;
+    QVector<sample> signal = testSignal(SEGMENT_SIZE + (frames - 1) * hop);
+
+    FrameKernel kernel(SEGMENT_SIZE, SAMPLE_RATE, NUM_FILTERS, MFCC_COUNT);
+    int features = kernel.outputSize();
+
+    QVector<float> expected(frames * features);
+    for (int f = 0; f < frames; f++)
+        QVERIFY(kernel.process(signal.constData() + f * hop, expected.data() + f * features));
+
+    // souvislé segmenty, segmenty po sloupcích a segmenty s mezerou mezi řádky
+    QVector<float> frameMajor(frames * features);
+    QVector<float> coefficientMajor(frames * features);
+    QVector<float> padded(frames * (features + 3), -1.0f);
+
+    TensorView views[] = {TensorView::frameMajor(frameMajor.data(), frames, features),
+                          TensorView::coefficientMajor(coefficientMajor.data(), frames, features),
+                          TensorView(padded.data(), frames, features, features + 3, 1)};
+
+    for (const TensorView &view : views) {
+        for (int f = 0; f < frames; f++)
+            QVERIFY(kernel.process(signal.constData() + f * hop, view, f));
+
+        for (int f = 0; f < frames; f++) {
+            for (int j = 0; j < features; j++)
+                QCOMPARE(view.frame(f)[j * view.featureStride()], expected[f * features + j]);
+        }
+    }
+
+    // mezery mezi řádky zůstávají nedotčeny
+    for (int f = 0; f < frames; f++) {
+        for (int j = features; j < features + 3; j++)
+            QCOMPARE(padded[f * (features + 3) + j], -1.0f);
+    }
+}
+
+QTEST_GUILESS_MAIN(FrameKernelTest)
+
+#include "framekerneltest.moc"
@@ -0,0 +1,101 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "testdata.h"
+
+#include "../htkfile.h"
+#include "../tensorview.h"
+
+/*
+ * Zápis a zpětné čtení souborů parametrů HTK (hlavička, hodnoty, matice s libovolnými kroky).
+ */
+class HtkFileTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void kindName();
+    void roundTrip();
+    void tensorRoundTrip();
+    void invalidFile();
+
+private:
+    QTemporaryDir m_dir;
+};
+
+namespace {
+
+// více vektorů, než se převádí najednou (HtkFile čte po blocích)
+const int VECTORS = 500;
+const int SIZE = 39;
+const int KIND = HtkFile::Mfcc | HtkFile::Energy | HtkFile::Delta | HtkFile::Acceleration;
+
+}
+
+void HtkFileTest::kindName() {
+    QCOMPARE(HtkFile::kindName(KIND), QString("MFCC_E_D_A"));
+    QCOMPARE(HtkFile::kindName(HtkFile::Mfcc | HtkFile::ZerothCepstral), QString("MFCC_0"));
+    QCOMPARE(HtkFile::kindName(HtkFile::User), QString("USER"));
+}
+
+void HtkFileTest::roundTrip() {
+    QVector<float> features = testFeatures(VECTORS, SIZE);
+    qint32 period = HtkFile::samplePeriodFor(SEGMENT_SIZE - OVERLAP, SAMPLE_RATE);
+    QCOMPARE(period, qint32(116100));
+
+    HtkFile writer(m_dir.filePath("features.htk"));
+    QVERIFY(writer.write(features.constData(), VECTORS, SIZE, period, KIND));
+
+    HtkFile reader(m_dir.filePath("features.htk"));
+    QVERIFY(reader.readHeader());
+    QCOMPARE(reader.vectorsCount(), VECTORS);
+    QCOMPARE(reader.vectorSize(), SIZE);
+    QCOMPARE(reader.samplePeriod(), period);
+    QCOMPARE(reader.parameterKind(), KIND);
+    QCOMPARE(reader.readAll(), features);
+}
+
+void HtkFileTest::tensorRoundTrip() {
+    QVector<float> features = testFeatures(VECTORS, SIZE);
+
+    // zápis z matice po koeficientech, čtení do matice s doplněním a mezerou mezi řádky
+    QVector<float> transposed(VECTORS * SIZE);
+    TensorView source = TensorView::coefficientMajor(transposed.data(), VECTORS, SIZE);
+    for (int t = 0; t < VECTORS; t++)
+        source.store(t, features.constData() + t * SIZE);
+
+    HtkFile writer(m_dir.filePath("tensor.htk"));
+    QVERIFY(writer.write(source, 100000, HtkFile::User));
+
+    const int padding = 3;
+    QVector<float> output((VECTORS + padding) * (SIZE + 1), -1.0f);
+    TensorView view(output.data(), VECTORS + padding, SIZE, SIZE + 1, 1);
+
+    HtkFile reader(m_dir.filePath("tensor.htk"));
+    QCOMPARE(reader.read(view), VECTORS);
+    QCOMPARE(reader.parameterKind(), int(HtkFile::User));
+
+    for (int t = 0; t < VECTORS + padding; t++) {
+        for (int j = 0; j < SIZE; j++)
+            QCOMPARE(view.frame(t)[j], (t < VECTORS) ? features[t * SIZE + j] : 0.0f);
+    }
+}
+
+void HtkFileTest::invalidFile() {
+    QString fileName = m_dir.filePath("truncated.htk");
+    QVector<float> features = testFeatures(10, SIZE);
+
+    HtkFile writer(fileName);
+    QVERIFY(writer.write(features.constData(), 10, SIZE, 100000, KIND));
+
+    // zkrácený soubor neodpovídá hlavičce
+    QFile file(fileName);
+    QVERIFY(file.resize(file.size() - 4));
+
+    HtkFile reader(fileName);
+    QVERIFY(!reader.readHeader());
+    QVERIFY(reader.readAll().isEmpty());
+}
+
+QTEST_APPLESS_MAIN(HtkFileTest)
+
+#include "htkfiletest.moc"
@@ -0,0 +1,161 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include <algorithm>
+
+#include "testdata.h"
+
+#include "../offlineextractor.h"
+#include "../spectraldescriptors.h"
+#include "../wavfile.h"
+
+/*
+ * Výstup OfflineExtractor nezávisí na rozložení výstupní matice ani na počtu vláken a velikosti bloků segmentů
+ * (včetně stavových kroků: preemfáze s ditherem, spektrální tok, základní frekvence, dynamické koeficienty).
+ */
+class OfflineExtractorTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void tensorLayouts();
+    void batchPadding();
+    void threadIndependence();
+    void emptyFile();
+
+private:
+    QTemporaryDir m_dir;
+    QStringList m_files;    //!< Testovací soubory různé délky.
+};
+
+namespace {
+
+const int HOP = SEGMENT_SIZE - OVERLAP;
+
+/* Ověří, že matice view obsahuje vektory reference a za nimi nuly. */
+bool matches(const TensorView &view, const QVector<float> &reference, int frames) {
+    for (int t = 0; t < view.frames(); t++) {
+        for (int j = 0; j < view.features(); j++) {
+            float expected = (t < frames) ? reference[t * view.features() + j] : 0.0f;
+
+            if (view.frame(t)[j * view.featureStride()] != expected)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+void OfflineExtractorTest::initTestCase() {
+    QVERIFY(m_dir.isValid());
+
+    const int lengths[] = {40, 25, 3};
+    for (int i = 0; i < 3; i++) {
+        m_files.append(m_dir.filePath(QString("signal%1.wav").arg(i)));
+        QVERIFY(WavFile(m_files.last()).write(testSignal(SEGMENT_SIZE + lengths[i] * HOP, 100 + i)));
+    }
+}
+
+void OfflineExtractorTest::tensorLayouts() {
+    OfflineExtractor extractor(SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT);
+    extractor.setThreadCount(2);
+
+    QVector<float> reference = extractor.extract(m_files[0]);
+    int frames = static_cast<int>(extractor.framesCount());
+    int features = extractor.coefsCount();
+
+    QVERIFY(frames > 0);
+    QCOMPARE(reference.size(), frames * features);
+    QCOMPARE(extractor.countFrames(m_files[0]), qint64(frames));
+
+    // přesná velikost, po koeficientech s doplněním a segmenty s mezerou mezi řádky
+    const int padding = 4;
+    QVector<float> frameMajor(frames * features);
+    QVector<float> coefficientMajor((frames + padding) * features, -1.0f);
+    QVector<float> strided((frames + padding) * (features + 2), -1.0f);
+
+    TensorView views[] = {TensorView::frameMajor(frameMajor.data(), frames, features),
+                          TensorView::coefficientMajor(coefficientMajor.data(), frames + padding, features),
+                          TensorView(strided.data(), frames + padding, features, features + 2, 1)};
+
+    for (const TensorView &view : views) {
+        QCOMPARE(extractor.extract(m_files[0], view), qint64(frames));
+        QVERIFY(matches(view, reference, frames));
+    }
+}
+
+void OfflineExtractorTest::batchPadding() {
+    OfflineExtractor extractor(SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT);
+    extractor.setThreadCount(3);
+
+    int features = extractor.coefsCount();
+    QVector<QVector<float>> references;
+    QVector<qint64> counts;
+    int frames = 0;
+
+    for (const QString &file : m_files) {
+        references.append(extractor.extract(file));
+        counts.append(extractor.framesCount());
+        frames = qMax(frames, static_cast<int>(extractor.countFrames(file)));
+    }
+
+    for (int layout = TensorView::FrameMajor; layout <= TensorView::CoefficientMajor; layout++) {
+        QVector<float> batch(m_files.size() * frames * features, -1.0f);
+
+        QVector<qint64> result = extractor.extractBatch(m_files, batch.data(), frames,
+                                                        static_cast<TensorView::Layout>(layout));
+        QCOMPARE(result, counts);
+
+        for (int i = 0; i < m_files.size(); i++) {
+            TensorView item = TensorView::batchItem(batch.data(), i, frames, features,
+                                                    static_cast<TensorView::Layout>(layout));
+            QVERIFY2(matches(item, references[i], static_cast<int>(counts[i])), qPrintable(m_files[i]));
+        }
+    }
+}
+
+void OfflineExtractorTest::threadIndependence() {
+    const int threads[] = {1, 2, 4};
+    const int chunks[] = {1, 5, 16};
+    QVector<float> reference;
+
+    for (int threadCount : threads) {
+        for (int chunkSize : chunks) {
+            OfflineExtractor extractor(SEGMENT_SIZE, OVERLAP, NUM_FILTERS, 13);
+            extractor.setThreadCount(threadCount);
+            extractor.setChunkSize(chunkSize);
+            extractor.setPreEmphasis(0.97f, 1.0f, 5);
+            extractor.setSpectralDescriptors(SpectralDescriptors::AllDescriptors);
+            extractor.setPitchTracking(true);
+            extractor.setDeltas(2);
+
+            QVector<float> features = extractor.extract(m_files[0]);
+            QCOMPARE(features.size(), static_cast<int>(extractor.framesCount()) * extractor.coefsCount());
+
+            if (reference.isEmpty())
+                reference = features;
+            else QVERIFY2(features == reference, qPrintable(QString("%1 vláken, bloky po %2 segmentech")
+                                                            .arg(threadCount).arg(chunkSize)));
+        }
+    }
+}
+
+void OfflineExtractorTest::emptyFile() {
+    QString empty = m_dir.filePath("empty.wav");
+    QVERIFY(WavFile(empty).write(QVector<sample>()));
+
+    OfflineExtractor extractor(SEGMENT_SIZE, OVERLAP, NUM_FILTERS, MFCC_COUNT);
+    QString message;
+    connect(&extractor, &OfflineExtractor::error, [&message](QString error) { message = error; });
+
+    QVERIFY(extractor.extract(empty).isEmpty());
+    QCOMPARE(extractor.framesCount(), qint64(0));
+    QVERIFY(!extractor.extract(empty, m_dir.filePath("empty.mfcc")));
+    QVERIFY(!message.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(OfflineExtractorTest)
+
+#include "offlineextractortest.moc"
@@ -0,0 +1,127 @@
+#include <QtTest>
+
+#include <algorithm>
+
+#include "testdata.h"
+
+#include "../preemphasis.h"
+#include "../windowtable.h"
+
+/*
+ * Preemfáze počítaná po překrývajících se segmentech musí odpovídat filtraci celého proudu předem, a to i při
+ * zpracování po blocích (reset na začátku bloku), jako v OfflineExtractor.
+ */
+class PreEmphasisTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void invalidParameters();
+    void matchesWholeStream();
+    void blocksMatchStream();
+    void ditherFollowsPosition();
+};
+
+namespace {
+
+const int SEGMENT = 256;
+const int HOP = 96;
+const int FRAMES = 20;
+const float COEFFICIENT = 0.97f;
+
+}
+
+void PreEmphasisTest::invalidParameters() {
+    PreEmphasis filter(SEGMENT, HOP);
+    QVERIFY(!filter.setCoefficient(1.5f));
+    QVERIFY(!filter.setCoefficient(-0.1f));
+    QCOMPARE(filter.coefficient(), PREEMPHASIS_COEFFICIENT);
+    QVERIFY(!filter.setDither(-1.0f));
+    QVERIFY(filter.setCoefficient(0.0f));
+}
+
+void PreEmphasisTest::matchesWholeStream() {
+    QVector<sample> signal = testSignal(SEGMENT + (FRAMES - 1) * HOP);
+    const float *window = WindowTable::get(WindowTable::Hamming, SEGMENT);
+
+    // y[n] = x[n] - a * x[n - 1], před začátkem proudu je ticho
+    QVector<float> filtered(signal.size());
+    for (int n = 0; n < signal.size(); n++)
+        filtered[n] = signal[n] - COEFFICIENT * ((n > 0) ? signal[n - 1] : 0.0f);
+
+    PreEmphasis filter(SEGMENT, HOP, COEFFICIENT);
+    QVector<float> output(SEGMENT);
+
+    for (int f = 0; f < FRAMES; f++) {
+        QCOMPARE(filter.position(), qint64(f) * HOP);
+        filter.apply(window, signal.constData() + f * HOP, output.data());
+
+        for (int i = 0; i < SEGMENT; i++) {
+            float expected = filtered[f * HOP + i] * window[i];
+            QVERIFY2(qAbs(output[i] - expected) <= 1e-5f * (1.0f + qAbs(expected)),
+                     qPrintable(QString("segment %1, vzorek %2").arg(f).arg(i)));
+        }
+    }
+}
+
+void PreEmphasisTest::blocksMatchStream() {
+    QVector<sample> signal = testSignal(SEGMENT + (FRAMES - 1) * HOP);
+    const float *window = WindowTable::get(WindowTable::Hamming, SEGMENT);
+
+    for (float dither : {0.0f, 2.0f}) {
+        PreEmphasis stream(SEGMENT, HOP, COEFFICIENT);
+        QVERIFY(stream.setDither(dither, 7));
+
+        QVector<float> expected(FRAMES * SEGMENT);
+        for (int f = 0; f < FRAMES; f++)
+            stream.apply(window, signal.constData() + f * HOP, expected.data() + f * SEGMENT);
+
+        // bloky po 3 segmentech, každý začíná resetem na pozici bloku (jako vlákna OfflineExtractor)
+        PreEmphasis blocks(SEGMENT, HOP, COEFFICIENT);
+        QVERIFY(blocks.setDither(dither, 7));
+
+        QVector<float> output(SEGMENT);
+        for (int f = 0; f < FRAMES; f++) {
+            if (f % 3 == 0) {
+                qint64 position = qint64(f) * HOP;
+                blocks.reset(position, (position > 0) ? signal[position - 1] : 0);
+            }
+
+            blocks.apply(window, signal.constData() + f * HOP, output.data());
+            QVERIFY(std::equal(output.constBegin(), output.constEnd(), expected.constBegin() + f * SEGMENT));
+        }
+    }
+}
+
+void PreEmphasisTest::ditherFollowsPosition() {
+    QVector<sample> signal = testSignal(SEGMENT + (FRAMES - 1) * HOP);
+    QVector<float> ones(SEGMENT, 1.0f);
+
+    // se vstupem vynásobeným jedničkami musí mít překrývající se části sousedních segmentů stejné hodnoty
+    PreEmphasis filter(SEGMENT, HOP, COEFFICIENT);
+    QVERIFY(filter.setDither(1.0f, 3));
+
+    QVector<float> previous(SEGMENT), current(SEGMENT);
+    filter.apply(ones.constData(), signal.constData(), previous.data());
+
+    bool dithered = false;
+
+    for (int f = 1; f < FRAMES; f++) {
+        filter.apply(ones.constData(), signal.constData() + f * HOP, current.data());
+
+        for (int i = 0; i < SEGMENT - HOP; i++)
+            QCOMPARE(current[i], previous[i + HOP]);
+
+        for (int i = 1; i < SEGMENT; i++) {
+            float plain = signal[f * HOP + i] - COEFFICIENT * signal[f * HOP + i - 1];
+            dithered = dithered || qAbs(current[i] - plain) > 1e-3f;
+        }
+
+        previous = current;
+    }
+
+    QVERIFY(dithered);
+}
+
+QTEST_APPLESS_MAIN(PreEmphasisTest)
+
+#include "preemphasistest.moc"
@@ -0,0 +1,126 @@
+#include <QtTest>
+
+#include <cmath>
+
+#include "testdata.h"
+
+#include "../resampler.h"
+
+/*
+ * Převod vzorkovací frekvence: zpracování proudu po částech, počet výstupních vzorků a převod tam a zpět.
+ */
+class ResamplerTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void sameRate();
+    void chunksMatchWhole();
+    void outputLength();
+    void roundTrip();
+};
+
+namespace {
+
+/* Sinusový signál o dané frekvenci a amplitudě. */
+QVector<sample> sine(int size, double frequency, int sampleRate, double amplitude = 8000.0) {
+    QVector<sample> signal(size);
+
+    for (int n = 0; n < size; n++)
+        signal[n] = static_cast<sample>(std::lround(amplitude * std::sin(2.0 * M_PI * frequency * n / sampleRate)));
+
+    return signal;
+}
+
+/* Převede celý signál včetně dokončení proudu. */
+QVector<sample> convert(Resampler &resampler, const QVector<sample> &input) {
+    QVector<sample> output = resampler.process(input);
+    output += resampler.flush();
+
+    return output;
+}
+
+}
+
+void ResamplerTest::sameRate() {
+    QVector<sample> signal = testSignal(1000);
+    Resampler resampler(16000, 16000);
+
+    QCOMPARE(convert(resampler, signal), signal);
+}
+
+void ResamplerTest::chunksMatchWhole() {
+    const int rates[][2] = {{44100, 16000}, {16000, 44100}, {48000, 16000}, {8000, 16000}};
+    QVector<sample> signal = testSignal(20000);
+
+    for (const auto &rate : rates) {
+        Resampler whole(rate[0], rate[1]);
+        QVector<sample> expected = convert(whole, signal);
+
+        // nepravidelné části včetně prázdných a jednovzorkových
+        Resampler chunked(rate[0], rate[1]);
+        QVector<sample> output;
+        QVector<sample> buffer;
+        const int sizes[] = {1, 0, 7, 160, 1023, 3, 4096};
+        int position = 0;
+
+        for (int i = 0; position < signal.size(); i++) {
+            int count = qMin(sizes[i % 7], signal.size() - position);
+            buffer.resize(chunked.maxOutputSize(count));
+
+            int written = chunked.process(signal.constData() + position, count, buffer.data());
+            QVERIFY(written <= buffer.size());
+            output += buffer.mid(0, written);
+            position += count;
+        }
+
+        output += chunked.flush();
+        QVERIFY2(output == expected, qPrintable(QString("%1 -> %2 Hz").arg(rate[0]).arg(rate[1])));
+    }
+}
+
+void ResamplerTest::outputLength() {
+    const int rates[][2] = {{44100, 16000}, {16000, 44100}, {48000, 16000}, {16000, 8000}};
+    const int size = 44100;
+
+    for (const auto &rate : rates) {
+        Resampler resampler(rate[0], rate[1]);
+        int expected = static_cast<int>(qint64(size) * rate[1] / rate[0]);
+        int length = convert(resampler, QVector<sample>(size)).size();
+
+        // výstup obsahuje celý vstup a zpoždění propusti, nejvýše několik desítek vzorků navíc
+        QVERIFY2(length >= expected && length <= expected + 64,
+                 qPrintable(QString("%1 -> %2 Hz: %3 vzorků").arg(rate[0]).arg(rate[1]).arg(length)));
+    }
+}
+
+void ResamplerTest::roundTrip() {
+    const int size = 16000;
+    QVector<sample> signal = sine(size, 440.0, 16000);
+
+    Resampler up(16000, 44100);
+    Resampler down(44100, 16000);
+    QVector<sample> output = convert(down, convert(up, signal));
+
+    // zpoždění obou propustí se najde jako posun s nejmenší chybou
+    const int margin = 1000;
+    double bestError = -1.0;
+
+    for (int delay = 0; delay < 200; delay++) {
+        double error = 0.0;
+
+        for (int n = margin; n < size - margin; n++) {
+            double difference = output.value(n + delay) - signal[n];
+            error += difference * difference;
+        }
+
+        if (bestError < 0.0 || error < bestError)
+            bestError = error;
+    }
+
+    double rms = std::sqrt(bestError / (size - 2 * margin));
+    QVERIFY2(rms < 8000.0 * 1e-3, qPrintable(QString("RMS chyba %1").arg(rms)));
+}
+
+QTEST_APPLESS_MAIN(ResamplerTest)
+
+#include "resamplertest.moc"
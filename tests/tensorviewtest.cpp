@@ -0,0 +1,133 @@
+#include <QtTest>
+
+#include "../tensorview.h"
+
+/*
+ * Adresování prvků matice ve všech rozloženích (po segmentech, po koeficientech, proud dávky, obecné kroky).
+ */
+class TensorViewTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void nullView();
+    void frameMajor();
+    void coefficientMajor();
+    void batchItem();
+    void midAndFill();
+};
+
+namespace {
+
+const int FRAMES = 5;
+const int FEATURES = 3;
+
+/* Zapíše do všech segmentů hodnoty 10 * t + j metodou store. */
+void storePattern(const TensorView &view) {
+    float values[FEATURES];
+
+    for (int t = 0; t < view.frames(); t++) {
+        for (int j = 0; j < FEATURES; j++)
+            values[j] = 10.0f * t + j;
+
+        view.store(t, values);
+    }
+}
+
+}
+
+void TensorViewTest::nullView() {
+    QVERIFY(TensorView().isNull());
+    QVERIFY(TensorView::batchItem(nullptr, 0, FRAMES, FEATURES).isNull());
+
+    float data[FRAMES * FEATURES];
+    QVERIFY(TensorView::batchItem(data, -1, FRAMES, FEATURES).isNull());
+    QVERIFY(!TensorView::frameMajor(data, FRAMES, FEATURES).isNull());
+}
+
+void TensorViewTest::frameMajor() {
+    QVector<float> data(FRAMES * FEATURES);
+    TensorView view = TensorView::frameMajor(data.data(), FRAMES, FEATURES);
+
+    QCOMPARE(view.frameStride(), qptrdiff(FEATURES));
+    QCOMPARE(view.featureStride(), qptrdiff(1));
+    QVERIFY(view.hasContiguousFrames());
+
+    storePattern(view);
+
+    for (int t = 0; t < FRAMES; t++) {
+        QCOMPARE(view.frame(t), data.data() + t * FEATURES);
+
+        for (int j = 0; j < FEATURES; j++)
+            QCOMPARE(data[t * FEATURES + j], 10.0f * t + j);
+    }
+}
+
+void TensorViewTest::coefficientMajor() {
+    QVector<float> data(FRAMES * FEATURES);
+    TensorView view = TensorView::coefficientMajor(data.data(), FRAMES, FEATURES);
+
+    QCOMPARE(view.frameStride(), qptrdiff(1));
+    QCOMPARE(view.featureStride(), qptrdiff(FRAMES));
+    QVERIFY(!view.hasContiguousFrames());
+
+    storePattern(view);
+
+    for (int t = 0; t < FRAMES; t++) {
+        for (int j = 0; j < FEATURES; j++)
+            QCOMPARE(data[j * FRAMES + t], 10.0f * t + j);
+    }
+}
+
+void TensorViewTest::batchItem() {
+    const int batch = 3;
+    QVector<float> data(batch * FRAMES * FEATURES, -1.0f);
+
+    for (int layout = TensorView::FrameMajor; layout <= TensorView::CoefficientMajor; layout++) {
+        TensorView item = TensorView::batchItem(data.data(), 1, FRAMES, FEATURES,
+                                                static_cast<TensorView::Layout>(layout));
+        QCOMPARE(item.data(), data.data() + FRAMES * FEATURES);
+        QCOMPARE(item.hasContiguousFrames(), layout == TensorView::FrameMajor);
+
+        data.fill(-1.0f);
+        storePattern(item);
+
+        // sousední proudy dávky zůstávají nedotčeny
+        for (int i = 0; i < FRAMES * FEATURES; i++) {
+            QCOMPARE(data[i], -1.0f);
+            QCOMPARE(data[2 * FRAMES * FEATURES + i], -1.0f);
+        }
+
+        for (int t = 0; t < FRAMES; t++) {
+            for (int j = 0; j < FEATURES; j++)
+                QCOMPARE(item.frame(t)[j * item.featureStride()], 10.0f * t + j);
+        }
+    }
+}
+
+void TensorViewTest::midAndFill() {
+    QVector<float> data(FRAMES * FEATURES);
+    TensorView views[] = {TensorView::frameMajor(data.data(), FRAMES, FEATURES),
+                          TensorView::coefficientMajor(data.data(), FRAMES, FEATURES)};
+
+    for (const TensorView &view : views) {
+        storePattern(view);
+
+        TensorView middle = view.mid(1, 3);
+        QCOMPARE(middle.frames(), 3);
+        QCOMPARE(middle.features(), FEATURES);
+        QCOMPARE(middle.frame(0), view.frame(1));
+
+        middle.fill(1, 3, 0.5f);
+
+        for (int t = 0; t < FRAMES; t++) {
+            for (int j = 0; j < FEATURES; j++) {
+                float expected = (t == 2 || t == 3) ? 0.5f : 10.0f * t + j;
+                QCOMPARE(view.frame(t)[j * view.featureStride()], expected);
+            }
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(TensorViewTest)
+
+#include "tensorviewtest.moc"
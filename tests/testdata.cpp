@@ -0,0 +1,33 @@
+#include "testdata.h"
+
+#include <QtMath>
+
+QVector<sample> testSignal(int size, quint32 seed) {
+    QVector<sample> signal(size);
+
+    for (int i = 0; i < size; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = static_cast<float>(static_cast<int>(seed >> 16) - 32768) / 32768.0f;
+        float tone = qSin(2.0f * static_cast<float>(M_PI) * 440.0f * i / SAMPLE_RATE);
+
+        signal[i] = static_cast<sample>(8000.0f * tone + 2000.0f * noise);
+    }
+
+    return signal;
+}
+
+QVector<float> testFeatures(int frames, int features) {
+    QVector<float> matrix(frames * features);
+    quint32 seed = 777;
+
+    for (int t = 0; t < frames; t++) {
+        for (int j = 0; j < features; j++) {
+            seed = seed * 1664525u + 1013904223u;
+            float noise = static_cast<float>(static_cast<int>(seed >> 16) - 32768) / 32768.0f;
+
+            matrix[t * features + j] = 3.0f * j - 10.0f + (j + 1) * noise + qSin(0.05f * t * (j + 1));
+        }
+    }
+
+    return matrix;
+}
@@ -0,0 +1,26 @@
+#ifndef TESTDATA_H
+#define TESTDATA_H
+
+#include <QVector>
+#include <QString>
+
+#include "../pe_config.h"
+
+/*!
+ * \brief testSignal Vytvoří deterministický testovací signál (tón 440 Hz s pseudonáhodným šumem).
+ * \param size Počet vzorků signálu.
+ * \param seed Semínko generátoru šumu (různé signály stejné délky).
+ * \return Vektor vzorků signálu.
+ */
+QVector<sample> testSignal(int size, quint32 seed = 12345);
+
+/*!
+ * \brief testFeatures Vytvoří deterministickou matici příznaků (frames x features za sebou) s různou střední
+ *                     hodnotou a rozptylem jednotlivých sloupců.
+ * \param frames Počet vektorů.
+ * \param features Počet prvků vektoru.
+ * \return Souvislá matice příznaků.
+ */
+QVector<float> testFeatures(int frames, int features);
+
+#endif
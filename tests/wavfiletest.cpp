@@ -0,0 +1,92 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QtEndian>
+
+#include "testdata.h"
+
+#include "../wavfile.h"
+
+/*
+ * Zápis souboru WAV: hlavička RIFF/PCM16 a vzorky s malým endianem, včetně prázdného signálu.
+ */
+class WavFileTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void header();
+    void samples();
+    void invalidInput();
+
+private:
+    QTemporaryDir m_dir;
+
+    QByteArray writeAndRead(const QVector<sample> &audio, int sampleRate);
+};
+
+QByteArray WavFileTest::writeAndRead(const QVector<sample> &audio, int sampleRate) {
+    QString fileName = m_dir.filePath("audio.wav");
+
+    if (!WavFile(fileName).write(audio, sampleRate))
+        return QByteArray();
+
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly))
+        return QByteArray();
+
+    return file.readAll();
+}
+
+void WavFileTest::header() {
+    const int sizes[] = {0, 1, 10000};
+
+    for (int size : sizes) {
+        QByteArray data = writeAndRead(testSignal(size), 16000);
+        const uchar *bytes = reinterpret_cast<const uchar *>(data.constData());
+
+        QCOMPARE(data.size(), WAV_HEADER_SIZE + 2 * size);
+        QCOMPARE(data.mid(0, 4), QByteArray("RIFF"));
+        QCOMPARE(qFromLittleEndian<quint32>(bytes + 4), quint32(data.size() - 8));
+        QCOMPARE(data.mid(8, 8), QByteArray("WAVEfmt "));
+        QCOMPARE(qFromLittleEndian<quint32>(bytes + 16), quint32(16));
+        QCOMPARE(qFromLittleEndian<quint16>(bytes + 20), quint16(1));
+        QCOMPARE(qFromLittleEndian<quint16>(bytes + 22), quint16(1));
+        QCOMPARE(qFromLittleEndian<quint32>(bytes + 24), quint32(16000));
+        QCOMPARE(qFromLittleEndian<quint32>(bytes + 28), quint32(32000));
+        QCOMPARE(qFromLittleEndian<quint16>(bytes + 32), quint16(2));
+        QCOMPARE(qFromLittleEndian<quint16>(bytes + 34), quint16(16));
+        QCOMPARE(data.mid(36, 4), QByteArray("data"));
+        QCOMPARE(qFromLittleEndian<quint32>(bytes + 40), quint32(2 * size));
+    }
+}
+
+void WavFileTest::samples() {
+    // více vzorků, než se převádí najednou, včetně krajních hodnot
+    QVector<sample> audio = testSignal(10000);
+    audio[0] = -32768;
+    audio[1] = 32767;
+
+    QByteArray data = writeAndRead(audio, SAMPLE_RATE);
+    QCOMPARE(data.size(), WAV_HEADER_SIZE + 2 * audio.size());
+
+    const uchar *bytes = reinterpret_cast<const uchar *>(data.constData()) + WAV_HEADER_SIZE;
+    for (int i = 0; i < audio.size(); i++)
+        QCOMPARE(qFromLittleEndian<qint16>(bytes + 2 * i), qint16(audio[i]));
+}
+
+void WavFileTest::invalidInput() {
+    WavFile file(m_dir.filePath("invalid.wav"));
+    QString message;
+    connect(&file, &WavFile::error, [&message](QString error) { message = error; });
+
+    QVERIFY(!file.write(testSignal(10), 0));
+    QVERIFY(!message.isEmpty());
+
+    message.clear();
+    file.setWavFile(m_dir.filePath("missing/invalid.wav"));
+    QVERIFY(!file.write(testSignal(10)));
+    QVERIFY(!message.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(WavFileTest)
+
+#include "wavfiletest.moc"
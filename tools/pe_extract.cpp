@@ -0,0 +1,435 @@
+/*
+ * pe-extract: dávkový výpočet MFC koeficientů zvukových souborů (WAV, surové PCM).
+ *
+ * Soubory jsou zpracovávány souběžně ve vláknech QThreadPool, každý pomocí OfflineExtractor (namapovaný soubor,
+ * FrameKernel). Současně je rozpracováno nejvýše tolik souborů, kolik je vláken, paměťová náročnost je tedy
+ * omezena bez ohledu na počet vstupních souborů. Výsledky jsou zapsány jako MfccFile nebo jako soubory parametrů
+ * HTK (--format htk, volba --htk navíc nastaví výchozí hodnoty ostatních voleb podle konvencí HTK).
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDir>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+#include <cstdio>
+
+#include "../pe_config.h"
+#include "../offlineextractor.h"
+
+namespace {
+
+/* Nastavení výpočtu společné všem souborům. */
+struct ExtractSettings {
+    int segmentSize;
+    int overlap;
+    int filters;
+    int coefs;
+    int rawSampleRate;
+    int rawChannels;
+    int threadsPerFile;
+    FFT::SizePolicy fftPolicy;
+    float preEmphasis;
+    float dither;
+    FilterBank::Scale filterScale;
+    FilterBank::Normalization filterNormalization;
+    float lowFrequency;
+    float highFrequency;
+    int lifter;
+    FrameKernel::EnergyTerm energyTerm;
+    bool htkFormat;
+    int descriptors;
+    bool pitch;
+    bool pitchSmoothed;
+    float pitchMinFrequency;
+    float pitchMaxFrequency;
+    int deltaOrder;
+    int deltaWindow;
+    int cmvn;
+    bool cmvnVariance;
+    QString cmvnStats;
+    int cmvnWindow;
+    QString outputDir;
+    bool verbose;
+};
+
+/* Souhrnné výsledky všech souborů. */
+struct ExtractTotals {
+    QMutex mutex;
+    int done = 0;
+    int failed = 0;
+    double audioSeconds = 0.0;
+    qint64 frames = 0;
+};
+
+/* Vstupní soubor a jeho adresář relativně ke kořeni zadanému na příkazové řádce (prázdný pro soubory a kořen). */
+struct InputFile {
+    QString path;
+    QString relativeDir;
+};
+
+/* Výstup vedle vstupu, nebo pod -o se zachováním struktury podadresářů kořene. */
+QString outputFileName(const InputFile &input, const QString &outputDir, bool htkFormat) {
+    QFileInfo info(input.path);
+    QString name = info.completeBaseName() + (htkFormat ? ".htk" : ".mfcc");
+
+    if (outputDir.isEmpty())
+        return info.dir().filePath(name);
+
+    QString dir = QDir::cleanPath(input.relativeDir);
+    return QDir(outputDir).filePath((dir.isEmpty() || dir == ".") ? name : dir + "/" + name);
+}
+
+class ExtractTask : public QRunnable {
+public:
+    ExtractTask(const QString &input, const QString &output, const ExtractSettings *settings, ExtractTotals *totals)
+        : m_input(input), m_output(output), m_settings(settings), m_totals(totals) {}
+
+    void run() override {
+        OfflineExtractor extractor(m_settings->segmentSize, m_settings->overlap, m_settings->filters, m_settings->coefs);
+        extractor.setRawFormat(m_settings->rawSampleRate, m_settings->rawChannels);
+        extractor.setThreadCount(m_settings->threadsPerFile);
+        extractor.setFftSizePolicy(m_settings->fftPolicy);
+        extractor.setPreEmphasis(m_settings->preEmphasis, m_settings->dither);
+        extractor.setFilterBank(m_settings->filterScale, m_settings->lowFrequency, m_settings->highFrequency,
+                                m_settings->filterNormalization);
+        extractor.setCepstralOptions(m_settings->lifter, m_settings->energyTerm);
+        extractor.setSpectralDescriptors(m_settings->descriptors);
+        extractor.setPitchTracking(m_settings->pitch, m_settings->pitchSmoothed, m_settings->pitchMinFrequency,
+                                   m_settings->pitchMaxFrequency);
+        extractor.setDeltas(m_settings->deltaOrder, m_settings->deltaWindow);
+        if (m_settings->cmvn > 0)
+            extractor.setCmvn(true, static_cast<Cmvn::Mode>(m_settings->cmvn - 1), m_settings->cmvnVariance,
+                              m_settings->cmvnStats, m_settings->cmvnWindow);
+
+        QString message;
+        QObject::connect(&extractor, &OfflineExtractor::error, [&message](QString error) { message = error; });
+
+        bool ok = m_settings->htkFormat ? extractor.extractHtk(m_input, m_output) : extractor.extract(m_input, m_output);
+
+        double seconds = (extractor.sampleRate() > 0)
+                ? static_cast<double>(extractor.samplesCount()) / extractor.sampleRate() : 0.0;
+        qint64 frames = extractor.framesCount();
+
+        QMutexLocker locker(&m_totals->mutex);
+
+        if (!ok) {
+            m_totals->failed++;
+            fprintf(stderr, "pe-extract: %s: %s\n", qPrintable(m_input), qPrintable(message));
+            return;
+        }
+
+        m_totals->done++;
+        m_totals->audioSeconds += seconds;
+        m_totals->frames += frames;
+
+        if (m_settings->verbose)
+            printf("%s -> %s (%.1f s)\n", qPrintable(m_input), qPrintable(m_output), seconds);
+    }
+
+private:
+    QString m_input;
+    QString m_output;
+    const ExtractSettings *m_settings;
+    ExtractTotals *m_totals;
+};
+
+QVector<InputFile> collectInputs(const QStringList &paths, bool recursive) {
+    QVector<InputFile> files;
+    QStringList filters = {"*.wav", "*.WAV", "*.raw", "*.pcm"};
+
+    for (const QString &path : paths) {
+        QFileInfo info(path);
+
+        if (info.isDir()) {
+            QDirIterator it(path, filters, QDir::Files,
+                            recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+            QDir root(path);
+            while (it.hasNext()) {
+                QString file = it.next();
+                files.append(InputFile{file, root.relativeFilePath(QFileInfo(file).path())});
+            }
+        }
+        else if (info.isFile()) {
+            files.append(InputFile{path, QString()});
+        }
+        else fprintf(stderr, "pe-extract: %s: soubor nebo adresář neexistuje\n", qPrintable(path));
+    }
+
+    return files;
+}
+
+int intValue(const QCommandLineParser &parser, const QCommandLineOption &option) {
+    bool ok;
+    int value = parser.value(option).toInt(&ok);
+
+    if (!ok) {
+        fprintf(stderr, "pe-extract: neplatná hodnota volby --%s\n", qPrintable(option.names().last()));
+        exit(2);
+    }
+
+    return value;
+}
+
+float floatValue(const QCommandLineParser &parser, const QCommandLineOption &option) {
+    bool ok;
+    float value = parser.value(option).toFloat(&ok);
+
+    if (!ok || value < 0.0f) {
+        fprintf(stderr, "pe-extract: neplatná hodnota volby --%s\n", qPrintable(option.names().last()));
+        exit(2);
+    }
+
+    return value;
+}
+
+/* Příznaky spektrálních deskriptorů ze seznamu názvů oddělených čárkami (pořadí názvů odpovídá bitům příznaků). */
+int descriptorsValue(const QCommandLineParser &parser, const QCommandLineOption &option) {
+    const QStringList names = {"centroid", "flux", "rolloff", "flatness"};
+    int descriptors = 0;
+
+    if (!parser.isSet(option))
+        return 0;
+
+    for (const QString &name : parser.value(option).toLower().split(',')) {
+        int index = names.indexOf(name.trimmed());
+
+        if (name.trimmed() == "all")
+            descriptors |= SpectralDescriptors::AllDescriptors;
+        else if (index >= 0)
+            descriptors |= 1 << index;
+        else {
+            fprintf(stderr, "pe-extract: volba --%s přijímá seznam hodnot %s nebo all\n",
+                    qPrintable(option.names().last()), qPrintable(names.join(", ")));
+            exit(2);
+        }
+    }
+
+    return descriptors;
+}
+
+/* Index hodnoty volby v seznamu povolených názvů (pořadí odpovídá výčtu). */
+int choiceValue(const QCommandLineParser &parser, const QCommandLineOption &option, const QStringList &choices) {
+    int index = choices.indexOf(parser.value(option).toLower());
+
+    if (index < 0) {
+        fprintf(stderr, "pe-extract: volba --%s přijímá hodnoty %s\n", qPrintable(option.names().last()),
+                qPrintable(choices.join(", ")));
+        exit(2);
+    }
+
+    return index;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("pe-extract");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Výpočet MFC koeficientů zvukových souborů (WAV, surové 16bitové PCM).");
+    parser.addHelpOption();
+    parser.addPositionalArgument("inputs", "Vstupní soubory nebo adresáře (*.wav, *.raw, *.pcm).", "inputs...");
+
+    QCommandLineOption outputOption({"o", "output"}, "Adresář výstupních souborů .mfcc nebo .htk (výchozí adresář vstupu), podadresáře zadaných adresářů jsou zachovány.", "dir");
+    QCommandLineOption threadsOption({"j", "threads"}, "Počet vláken.", "n", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption segmentOption("segment", "Počet vzorků segmentu.", "n", QString::number(SEGMENT_SIZE));
+    QCommandLineOption overlapOption("overlap", "Překryv segmentů.", "n", QString::number(OVERLAP));
+    QCommandLineOption filtersOption("filters", "Počet melovských filtrů.", "n", QString::number(NUM_FILTERS));
+    QCommandLineOption coefsOption("coefs", "Počet MFC koeficientů (formát MfccFile vyžaduje MFCC_COUNT).", "n",
+                                   QString::number(MFCC_COUNT));
+    QCommandLineOption rateOption("raw-rate", "Frekvence vzorkování surových souborů.", "hz", QString::number(SAMPLE_RATE));
+    QCommandLineOption channelsOption("raw-channels", "Počet kanálů surových souborů.", "n", QString::number(CHANNEL_COUNT));
+    QCommandLineOption fastFftOption("fast-fft", "Velikost FFT s faktory 2, 3 a 5 místo mocniny 2 (segmenty jiné "
+                                     "velikosti než mocnina 2).");
+    QCommandLineOption preEmphasisOption("preemphasis", "Koeficient preemfáze (0 = vypnutá, obvykle 0.97).", "a", "0");
+    QCommandLineOption ditherOption("dither", "Amplituda deterministického ditheru ve vzorcích (0 = vypnutý).", "amp", "0");
+    QCommandLineOption filterBankOption("filterbank", "Banka filtrů: legacy (původní melovská), htk, slaney, bark "
+                                        "nebo erb (gammatone).", "scale", "legacy");
+    QCommandLineOption lowFreqOption("low-freq", "Dolní mezní frekvence banky filtrů v Hz (kromě legacy).", "hz", "0");
+    QCommandLineOption highFreqOption("high-freq", "Horní mezní frekvence banky filtrů v Hz (kromě legacy, výchozí "
+                                      "Nyquistova frekvence).", "hz");
+    QCommandLineOption filterNormOption("filter-norm", "Normalizace filtrů: none, peak nebo area.", "norm", "none");
+    QCommandLineOption lifterOption("lifter", "Parametr sinusového lifteru (0 = vypnutý, HTK a Kaldi 22).", "n", "0");
+    QCommandLineOption energyOption("energy", "Energetický člen a pořadí koeficientů: c0 (c0 na začátku), loge "
+                                    "(log E místo c0, Kaldi), c0-last (HTK _0) nebo loge-last (HTK _E).", "term", "c0");
+    QCommandLineOption formatOption("format", "Formát výstupu: mfcc (MfccFile) nebo htk (soubory parametrů HTK .htk).",
+                                    "fmt", "mfcc");
+    QCommandLineOption htkOption("htk", "Profil HTK: výchozí hodnoty --format htk, --filterbank htk, --filters 26, "
+                                 "--coefs 13, --lifter 22, --energy loge-last a --preemphasis 0.97.");
+    QCommandLineOption descriptorsOption("descriptors", "Spektrální deskriptory připojené za koeficienty (jen formát htk): "
+                                         "seznam centroid, flux, rolloff, flatness oddělený čárkami nebo all.", "list");
+    QCommandLineOption pitchOption("pitch", "Připojit základní frekvenci v Hz a znělost za koeficienty a deskriptory "
+                                   "(jen formát htk).");
+    QCommandLineOption pitchMinOption("pitch-min", "Nejnižší hledaná základní frekvence v Hz.", "hz",
+                                      QString::number(PITCH_MIN_FREQUENCY));
+    QCommandLineOption pitchMaxOption("pitch-max", "Nejvyšší hledaná základní frekvence v Hz.", "hz",
+                                      QString::number(PITCH_MAX_FREQUENCY));
+    QCommandLineOption pitchRawOption("pitch-unsmoothed", "Nevyhlazovat základní frekvenci Viterbiho algoritmem.");
+    QCommandLineOption deltasOption("deltas", "Dynamické koeficienty připojené za statické prvky vektoru (jen formát "
+                                    "htk): 0 žádné, 1 delta (HTK _D), 2 delta a delta-delta (HTK _D_A).", "n", "0");
+    QCommandLineOption deltaWindowOption("delta-window", "Poloviční šířka regresního okna dynamických koeficientů.",
+                                         "n", "2");
+    QCommandLineOption cmvnOption("cmvn", "Normalizace střední hodnoty a rozptylu koeficientů: none, global (statistiky "
+                                  "ze souboru --cmvn-stats), utterance (celý soubor) nebo sliding.", "mode", "none");
+    QCommandLineOption cmvnStatsOption("cmvn-stats", "Soubor statistik normalizace global (Cmvn::saveStats).", "file");
+    QCommandLineOption cmvnMeanOption("cmvn-mean-only", "Normalizovat jen střední hodnotu (bez rozptylu).");
+    QCommandLineOption cmvnWindowOption("cmvn-window", "Počet vektorů klouzavého okna normalizace sliding.", "n", "300");
+    QCommandLineOption recursiveOption({"r", "recursive"}, "Procházet adresáře rekurzivně.");
+    QCommandLineOption verboseOption({"v", "verbose"}, "Vypisovat každý zpracovaný soubor.");
+
+    parser.addOptions({outputOption, threadsOption, segmentOption, overlapOption, filtersOption, coefsOption,
+                       rateOption, channelsOption, fastFftOption, preEmphasisOption, ditherOption, filterBankOption,
+                       lowFreqOption, highFreqOption, filterNormOption, lifterOption, energyOption, formatOption,
+                       htkOption, descriptorsOption, pitchOption, pitchMinOption, pitchMaxOption, pitchRawOption,
+                       deltasOption, deltaWindowOption, cmvnOption, cmvnStatsOption, cmvnMeanOption, cmvnWindowOption,
+                       recursiveOption, verboseOption});
+
+    parser.process(app);
+
+    ExtractSettings settings;
+    settings.segmentSize = intValue(parser, segmentOption);
+    settings.overlap = intValue(parser, overlapOption);
+    settings.filters = intValue(parser, filtersOption);
+    settings.coefs = intValue(parser, coefsOption);
+    settings.rawSampleRate = intValue(parser, rateOption);
+    settings.rawChannels = intValue(parser, channelsOption);
+    settings.outputDir = parser.value(outputOption);
+    settings.verbose = parser.isSet(verboseOption);
+    settings.fftPolicy = parser.isSet(fastFftOption) ? FFT::NextFastSize : FFT::PowerOfTwo;
+    settings.preEmphasis = floatValue(parser, preEmphasisOption);
+    settings.dither = floatValue(parser, ditherOption);
+    settings.filterScale = static_cast<FilterBank::Scale>(
+                choiceValue(parser, filterBankOption, {"legacy", "htk", "slaney", "bark", "erb"}));
+    settings.filterNormalization = static_cast<FilterBank::Normalization>(
+                choiceValue(parser, filterNormOption, {"none", "peak", "area"}));
+    settings.lowFrequency = floatValue(parser, lowFreqOption);
+    settings.highFrequency = parser.isSet(highFreqOption) ? floatValue(parser, highFreqOption) : FILTERBANK_NYQUIST;
+    settings.lifter = intValue(parser, lifterOption);
+    settings.energyTerm = static_cast<FrameKernel::EnergyTerm>(
+                choiceValue(parser, energyOption, {"c0", "loge", "c0-last", "loge-last"}));
+    settings.htkFormat = choiceValue(parser, formatOption, {"mfcc", "htk"}) == 1;
+    settings.descriptors = descriptorsValue(parser, descriptorsOption);
+    settings.pitch = parser.isSet(pitchOption);
+    settings.pitchSmoothed = !parser.isSet(pitchRawOption);
+    settings.pitchMinFrequency = floatValue(parser, pitchMinOption);
+    settings.pitchMaxFrequency = floatValue(parser, pitchMaxOption);
+    settings.deltaOrder = intValue(parser, deltasOption);
+    settings.deltaWindow = intValue(parser, deltaWindowOption);
+    // pořadí odpovídá Cmvn::Mode posunutému o 1 (0 = vypnutá)
+    settings.cmvn = choiceValue(parser, cmvnOption, {"none", "global", "utterance", "sliding"});
+    settings.cmvnVariance = !parser.isSet(cmvnMeanOption);
+    settings.cmvnStats = parser.value(cmvnStatsOption);
+    settings.cmvnWindow = intValue(parser, cmvnWindowOption);
+    int threads = qMax(1, intValue(parser, threadsOption));
+
+    /* Profil HTK mění jen výchozí hodnoty, explicitně zadané volby mají přednost. */
+    if (parser.isSet(htkOption)) {
+        if (!parser.isSet(formatOption))
+            settings.htkFormat = true;
+        if (!parser.isSet(filterBankOption))
+            settings.filterScale = FilterBank::HtkMel;
+        if (!parser.isSet(filtersOption))
+            settings.filters = 26;
+        if (!parser.isSet(coefsOption))
+            settings.coefs = 13;
+        if (!parser.isSet(lifterOption))
+            settings.lifter = 22;
+        if (!parser.isSet(energyOption))
+            settings.energyTerm = FrameKernel::TrailingLogEnergy;
+        if (!parser.isSet(preEmphasisOption))
+            settings.preEmphasis = PREEMPHASIS_COEFFICIENT;
+    }
+
+    if (settings.deltaOrder < 0 || settings.deltaOrder > 2 || settings.deltaWindow < 1) {
+        fprintf(stderr, "pe-extract: volba --deltas přijímá hodnoty 0 až 2 a --delta-window kladné hodnoty\n");
+        return 2;
+    }
+
+    if ((settings.cmvn == 1 + Cmvn::Global && settings.cmvnStats.isEmpty()) || settings.cmvnWindow < 1) {
+        fprintf(stderr, "pe-extract: normalizace global vyžaduje --cmvn-stats a --cmvn-window kladnou hodnotu\n");
+        return 2;
+    }
+
+    if (!settings.htkFormat && (settings.coefs != MFCC_COUNT || settings.descriptors != 0 || settings.pitch
+                                || settings.deltaOrder != 0)) {
+        fprintf(stderr, "pe-extract: formát MfccFile ukládá právě %d koeficientů (bez deskriptorů, základní "
+                "frekvence a dynamických koeficientů)\n", MFCC_COUNT);
+        return 2;
+    }
+
+    if (!settings.outputDir.isEmpty() && !QDir().mkpath(settings.outputDir)) {
+        fprintf(stderr, "pe-extract: adresář %s nelze vytvořit\n", qPrintable(settings.outputDir));
+        return 2;
+    }
+
+    QVector<InputFile> inputs = collectInputs(parser.positionalArguments(), parser.isSet(recursiveOption));
+    if (inputs.isEmpty()) {
+        fprintf(stderr, "pe-extract: žádné vstupní soubory\n");
+        return 2;
+    }
+
+    /* Kolize výstupů (x.wav a x.raw, stejné jméno v různých kořenech) se odhalí před spuštěním výpočtu. */
+    QStringList outputs;
+    QHash<QString, QString> owners;
+    for (const InputFile &input : inputs) {
+        QString output = outputFileName(input, settings.outputDir, settings.htkFormat);
+        QString key = QFileInfo(output).absoluteFilePath();
+
+        if (owners.contains(key)) {
+            fprintf(stderr, "pe-extract: %s a %s by zapsaly stejný výstupní soubor %s\n",
+                    qPrintable(owners.value(key)), qPrintable(input.path), qPrintable(output));
+            return 2;
+        }
+
+        QString dir = QFileInfo(output).path();
+        if (!QDir().mkpath(dir)) {
+            fprintf(stderr, "pe-extract: adresář %s nelze vytvořit\n", qPrintable(dir));
+            return 2;
+        }
+
+        owners.insert(key, input.path);
+        outputs.append(output);
+    }
+
+    /* Méně souborů než vláken: zbývající vlákna pomáhají uvnitř souborů (po blocích segmentů). */
+    int concurrentFiles = qMin(threads, inputs.size());
+    settings.threadsPerFile = qMax(1, threads / concurrentFiles);
+
+    ExtractTotals totals;
+    QElapsedTimer timer;
+    timer.start();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(concurrentFiles);
+
+    for (int i = 0; i < inputs.size(); i++)
+        pool.start(new ExtractTask(inputs[i].path, outputs[i], &settings, &totals));
+
+    pool.waitForDone();
+
+    double wallSeconds = timer.nsecsElapsed() / 1e9;
+
+    printf("files:      %d processed, %d failed\n", totals.done, totals.failed);
+    printf("audio:      %.1f s, %lld frames\n", totals.audioSeconds, static_cast<long long>(totals.frames));
+    printf("wall time:  %.3f s (%d threads)\n", wallSeconds, threads);
+
+    if (wallSeconds > 0.0) {
+        printf("throughput: %.2f files/s, %.0f frames/s\n", totals.done / wallSeconds, totals.frames / wallSeconds);
+        printf("RTF:        %.5f (%.1fx faster than real time)\n",
+               (totals.audioSeconds > 0.0) ? wallSeconds / totals.audioSeconds : 0.0,
+               totals.audioSeconds / wallSeconds);
+    }
+
+    return totals.failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,239 @@
+/*
+ * pe-reconstruct: rekonstrukce akustického signálu z MFCC souboru (kontrola uložených příznaků poslechem).
+ *
+ * Každý vektor koeficientů je převeden na odhad výkonové spektrální hustoty (ESPDRecover) a z něj je obnoven
+ * časový průběh segmentu (SegmentRecover). Segmenty jsou na sobě nezávislé, a proto jsou počítány paralelně
+ * ve vláknech QThreadPool, každé vlákno s vlastními objekty obnovy. Obnovené segmenty jsou pak v pořadí spojeny
+ * (AudioComposer), přeškálovány (AudioScaler) a zapsány jako 16bitový PCM WAV.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDir>
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+#include <cstdio>
+
+#include "../pe_config.h"
+#include "../fft.h"
+#include "../hammingwindow.h"
+#include "../mfccfile.h"
+#include "../wavfile.h"
+#include "../reconstruction/espdrecover.h"
+#include "../reconstruction/segmentrecover.h"
+#include "../reconstruction/audiocomposer.h"
+#include "../reconstruction/audioscaler.h"
+
+/*!
+ * Adresář nainstalovaných souborů bílého šumu, použije se, pokud šum není vedle spustitelného souboru.
+ */
+#ifndef PE_WHITE_NOISE_DIR
+#define PE_WHITE_NOISE_DIR ""
+#endif
+
+namespace {
+
+/* Počet segmentů, které si vlákno najednou vezme ke zpracování. */
+const int FRAMES_PER_TASK = 8;
+
+struct ReconstructionJob {
+    const QVector<QVector<float>> *mfccs;
+    QVector<QVector<float>> *segments;
+    int segmentSize;
+    int filters;
+    int sampleRate;
+    int iterations;
+    QString noiseDirectory;
+    QAtomicInt nextFrame;       // index dalšího nezpracovaného segmentu
+    QAtomicInt doneFrames;      // počet dokončených segmentů (průběh)
+    QAtomicInt failed;
+};
+
+class ReconstructionWorker : public QRunnable {
+public:
+    explicit ReconstructionWorker(ReconstructionJob *job) : m_job(job) {}
+
+    void run() override {
+        FFT fft(m_job->segmentSize);
+        ESPDRecover espdRecover(fft.espdSize(), m_job->filters, m_job->sampleRate);
+        SegmentRecover segmentRecover(m_job->segmentSize, m_job->iterations);
+
+        if (!m_job->noiseDirectory.isEmpty())
+            segmentRecover.setWhiteNoiseDirectory(m_job->noiseDirectory);
+
+        QObject::connect(&segmentRecover, &SegmentRecover::error, [this](QString message) {
+            if (m_job->failed.fetchAndAddRelaxed(1) == 0)
+                fprintf(stderr, "pe-reconstruct: %s\n", qPrintable(message));
+        });
+
+        int total = m_job->mfccs->size();
+
+        for (int begin = m_job->nextFrame.fetchAndAddRelaxed(FRAMES_PER_TASK); begin < total;
+             begin = m_job->nextFrame.fetchAndAddRelaxed(FRAMES_PER_TASK)) {
+            int end = qMin(total, begin + FRAMES_PER_TASK);
+
+            for (int i = begin; i < end; i++)
+                (*m_job->segments)[i] = segmentRecover.recover(espdRecover.recover(m_job->mfccs->at(i)));
+
+            m_job->doneFrames.fetchAndAddRelaxed(end - begin);
+        }
+    }
+
+private:
+    ReconstructionJob *m_job;
+};
+
+QString defaultNoiseDirectory(int segmentSize) {
+    QString local = QCoreApplication::applicationDirPath();
+    QString name = QString("noise_%1.raw").arg(segmentSize);
+
+    if (QFileInfo(QDir(local).filePath(name)).exists() || QString(PE_WHITE_NOISE_DIR).isEmpty())
+        return local;
+
+    return PE_WHITE_NOISE_DIR;
+}
+
+int intValue(const QCommandLineParser &parser, const QCommandLineOption &option) {
+    bool ok;
+    int value = parser.value(option).toInt(&ok);
+
+    if (!ok) {
+        fprintf(stderr, "pe-reconstruct: neplatná hodnota volby --%s\n", qPrintable(option.names().last()));
+        exit(2);
+    }
+
+    return value;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("pe-reconstruct");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Rekonstrukce akustického signálu z MFCC souboru do 16bitového PCM WAV.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "Vstupní MFCC soubor.");
+
+    QCommandLineOption outputOption({"o", "output"}, "Výstupní soubor WAV (výchozí <vstup>.rec.wav).", "file");
+    QCommandLineOption threadsOption({"j", "threads"}, "Počet vláken.", "n", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption iterationsOption({"i", "iterations"}, "Počet iterací obnovy fáze každého segmentu.", "n",
+                                        QString::number(ESPD_RECOVERY_ITERS));
+    QCommandLineOption segmentOption("segment", "Počet vzorků segmentu.", "n", QString::number(SEGMENT_SIZE));
+    QCommandLineOption overlapOption("overlap", "Překryv segmentů.", "n", QString::number(OVERLAP));
+    QCommandLineOption filtersOption("filters", "Počet melovských filtrů použitých při parametrizaci.", "n",
+                                     QString::number(NUM_FILTERS));
+    QCommandLineOption rateOption("rate", "Frekvence vzorkování.", "hz", QString::number(SAMPLE_RATE));
+    QCommandLineOption noiseOption("noise-dir", "Adresář se soubory bílého šumu noise_<segment>.raw.", "dir");
+    QCommandLineOption quietOption({"q", "quiet"}, "Nevypisovat průběh.");
+
+    parser.addOptions({outputOption, threadsOption, iterationsOption, segmentOption, overlapOption, filtersOption,
+                       rateOption, noiseOption, quietOption});
+
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(2);
+
+    QString input = parser.positionalArguments().first();
+    QString output = parser.isSet(outputOption)
+            ? parser.value(outputOption)
+            : QFileInfo(input).dir().filePath(QFileInfo(input).completeBaseName() + ".rec.wav");
+
+    int threads = qMax(1, intValue(parser, threadsOption));
+    int segmentSize = intValue(parser, segmentOption);
+    int overlap = intValue(parser, overlapOption);
+    int sampleRate = intValue(parser, rateOption);
+    bool quiet = parser.isSet(quietOption);
+
+    if (segmentSize <= 1 || overlap < 0 || overlap >= segmentSize) {
+        fprintf(stderr, "pe-reconstruct: překryv musí být nezáporný a menší než velikost segmentu\n");
+        return 2;
+    }
+
+    MfccFile mfccFile(input);
+    if (!mfccFile.isReadable()) {
+        fprintf(stderr, "pe-reconstruct: %s není čitelný MFCC soubor\n", qPrintable(input));
+        return 1;
+    }
+
+    QVector<QVector<float>> mfccs = mfccFile.readAll();
+    QVector<QVector<float>> segments(mfccs.size());
+
+    ReconstructionJob job;
+    job.mfccs = &mfccs;
+    job.segments = &segments;
+    job.segmentSize = segmentSize;
+    job.filters = intValue(parser, filtersOption);
+    job.sampleRate = sampleRate;
+    job.iterations = qMax(1, intValue(parser, iterationsOption));
+    job.noiseDirectory = parser.isSet(noiseOption) ? parser.value(noiseOption) : defaultNoiseDirectory(segmentSize);
+    job.nextFrame.store(0);
+    job.doneFrames.store(0);
+    job.failed.store(0);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QThreadPool pool;
+    int workers = qMax(1, qMin(threads, (mfccs.size() + FRAMES_PER_TASK - 1) / FRAMES_PER_TASK));
+    pool.setMaxThreadCount(workers);
+
+    for (int i = 0; i < workers; i++)
+        pool.start(new ReconstructionWorker(&job));
+
+    /* Průběh je vypisován, dokud vlákna počítají. */
+    while (!pool.waitForDone(500)) {
+        if (quiet)
+            continue;
+
+        int done = job.doneFrames.load();
+        double seconds = timer.nsecsElapsed() / 1e9;
+        double rate = (seconds > 0.0) ? done / seconds : 0.0;
+
+        fprintf(stderr, "\r%d/%d segments, %.1f segments/s, ETA %.0f s   ", done, mfccs.size(), rate,
+                (rate > 0.0) ? (mfccs.size() - done) / rate : 0.0);
+    }
+
+    if (!quiet)
+        fprintf(stderr, "\n");
+
+    if (job.failed.load() > 0)
+        return 1;
+
+    /* Segmenty odpovídají spektru segmentů váženému Hammingovým oknem, spojují se metodou nejmenších čtverců. */
+    HammingWindow window(segmentSize);
+    AudioComposer composer(segmentSize, overlap);
+    composer.setWindows(window.coefficients(), window.coefficients());
+
+    for (const QVector<float> &segment : segments)
+        composer.add(segment);
+
+    AudioScaler scaler;
+    QVector<sample> audio = scaler.scale(composer.getAudio());
+
+    if (!WavFile(output).write(audio, sampleRate)) {
+        fprintf(stderr, "pe-reconstruct: do souboru %s nelze zapisovat\n", qPrintable(output));
+        return 1;
+    }
+
+    double wallSeconds = timer.nsecsElapsed() / 1e9;
+    double audioSeconds = static_cast<double>(audio.size()) / sampleRate;
+
+    printf("segments:   %d (%d iterations each, %d threads)\n", mfccs.size(), job.iterations, workers);
+    printf("audio:      %.1f s -> %s\n", audioSeconds, qPrintable(output));
+    printf("wall time:  %.3f s\n", wallSeconds);
+
+    if (wallSeconds > 0.0)
+        printf("throughput: %.1f segments/s, RTF %.3f\n", mfccs.size() / wallSeconds,
+               (audioSeconds > 0.0) ? wallSeconds / audioSeconds : 0.0);
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "voiceactivitydetector.h"
+
+#include <QtMath>
+
+#include <limits>
+
+VoiceActivityDetector::VoiceActivityDetector(int segmentSize, QObject *parent) : QObject(parent) {
+    m_segmentSize = segmentSize;
+    m_energyThreshold = -45.0f;
+    m_weakEnergyThreshold = -55.0f;
+    m_zeroCrossingThreshold = 0.25f;
+    m_hangover = 8;
+    m_hangoverLeft = 0;
+    m_lastEnergy = 0.0f;
+    m_lastZeroCrossingRate = 0.0f;
+
+    if (segmentSize <= 1) {
+        emit error("VoiceActivityDetector::VoiceActivityDetector: Neplatná velikost segmentu.");
+        m_segmentSize = 0;
+    }
+}
+
+int VoiceActivityDetector::segmentSize() const {
+    return m_segmentSize;
+}
+
+void VoiceActivityDetector::setEnergyThreshold(float threshold) {
+    m_energyThreshold = threshold;
+}
+
+void VoiceActivityDetector::setWeakEnergyThreshold(float threshold) {
+    m_weakEnergyThreshold = threshold;
+}
+
+void VoiceActivityDetector::setZeroCrossingThreshold(float threshold) {
+    m_zeroCrossingThreshold = threshold;
+}
+
+void VoiceActivityDetector::setHangover(int frames) {
+    m_hangover = qMax(0, frames);
+}
+
+bool VoiceActivityDetector::isVoiced(const sample *segment) {
+    if (!segment || m_segmentSize == 0)
+        return false;
+
+    /* Energie a průchody nulou v jednom průchodu, celočíselně. */
+    qint64 energy = static_cast<qint64>(segment[0]) * segment[0];
+    int crossings = 0;
+
+    for (int i = 1; i < m_segmentSize; i++) {
+        energy += static_cast<qint64>(segment[i]) * segment[i];
+        crossings += (segment[i - 1] < 0) != (segment[i] < 0);
+    }
+
+    const double fullScale = static_cast<double>(std::numeric_limits<sample>::max()) + 1.0;
+    double meanSquare = static_cast<double>(energy) / (m_segmentSize * fullScale * fullScale);
+
+    m_lastEnergy = static_cast<float>(10.0 * std::log10(meanSquare + 1e-20));
+    m_lastZeroCrossingRate = static_cast<float>(crossings) / (m_segmentSize - 1);
+
+    bool active = m_lastEnergy >= m_energyThreshold
+            || (m_lastEnergy >= m_weakEnergyThreshold && m_lastZeroCrossingRate >= m_zeroCrossingThreshold);
+
+    if (active) {
+        m_hangoverLeft = m_hangover;
+        return true;
+    }
+
+    if (m_hangoverLeft > 0) {
+        m_hangoverLeft--;
+        return true;
+    }
+
+    return false;
+}
+
+float VoiceActivityDetector::lastEnergy() const {
+    return m_lastEnergy;
+}
+
+float VoiceActivityDetector::lastZeroCrossingRate() const {
+    return m_lastZeroCrossingRate;
+}
+
+void VoiceActivityDetector::reset() {
+    m_hangoverLeft = 0;
+}
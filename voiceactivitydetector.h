@@ -0,0 +1,105 @@
+#ifndef VOICEACTIVITYDETECTOR_H
+#define VOICEACTIVITYDETECTOR_H
+
+#include <QObject>
+
+#include "pe_config.h"
+
+/*!
+ * \brief Třída VoiceActivityDetector
+ *
+ * Jednoduchý detektor řečové aktivity, který pracuje přímo nad vzorky segmentu před váhováním oknem. V jediném
+ * průchodu segmentem spočítá krátkodobou energii (v dB vzhledem k plnému rozsahu typu sample) a počet průchodů
+ * nulou. Segment je označen za řečový, pokud jeho energie přesáhne energyThreshold, nebo pokud přesáhne nižší
+ * práh weakEnergyThreshold a zároveň je četnost průchodů nulou alespoň zeroCrossingThreshold (neznělé hlásky
+ * mají malou energii, ale mnoho průchodů nulou).
+ *
+ * Aby nebyly ořezávány konce slov a krátké pauzy, je po posledním řečovém segmentu ještě hangover segmentů
+ * označeno za řečové. Detektor si pamatuje stav mezi segmenty, a proto nesmí být sdílen mezi více proudy.
+ */
+class VoiceActivityDetector : public QObject {
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief VoiceActivityDetector Konstruktor třídy.
+     * \param segmentSize Počet vzorků vyhodnocovaných segmentů.
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolnění).
+     */
+    explicit VoiceActivityDetector(int segmentSize, QObject *parent = nullptr);
+
+    /*!
+     * \brief segmentSize Vrací počet vzorků vyhodnocovaných segmentů.
+     * \return Počet vzorků segmentu.
+     */
+    int segmentSize() const;
+
+    /*!
+     * \brief setEnergyThreshold Nastaví práh energie, nad kterým je segment vždy řečový (výchozí -45 dB).
+     * \param threshold Práh v dB vzhledem k plnému rozsahu.
+     */
+    void setEnergyThreshold(float threshold);
+
+    /*!
+     * \brief setWeakEnergyThreshold Nastaví nižší práh energie, který platí pro segmenty s mnoha průchody nulou
+     *                               (výchozí -55 dB).
+     * \param threshold Práh v dB vzhledem k plnému rozsahu.
+     */
+    void setWeakEnergyThreshold(float threshold);
+
+    /*!
+     * \brief setZeroCrossingThreshold Nastaví práh četnosti průchodů nulou (výchozí 0.25 průchodu na vzorek).
+     * \param threshold Podíl počtu průchodů nulou a počtu vzorků segmentu.
+     */
+    void setZeroCrossingThreshold(float threshold);
+
+    /*!
+     * \brief setHangover Nastaví počet segmentů, které jsou po posledním řečovém segmentu ještě považovány za
+     *                    řečové (výchozí 8).
+     * \param frames Počet segmentů.
+     */
+    void setHangover(int frames);
+
+    /*!
+     * \brief isVoiced Vyhodnotí další segment proudu.
+     * \param segment Ukazatel na segmentSize() vzorků segmentu.
+     * \return True, pokud segment obsahuje řeč (nebo spadá do doby hangover), jinak false.
+     */
+    bool isVoiced(const sample *segment);
+
+    /*!
+     * \brief lastEnergy Vrací energii naposledy vyhodnoceného segmentu.
+     * \return Energie v dB vzhledem k plnému rozsahu.
+     */
+    float lastEnergy() const;
+
+    /*!
+     * \brief lastZeroCrossingRate Vrací četnost průchodů nulou naposledy vyhodnoceného segmentu.
+     * \return Podíl počtu průchodů nulou a počtu vzorků segmentu.
+     */
+    float lastZeroCrossingRate() const;
+
+    /*!
+     * \brief reset Zahodí stav hangover (začátek nového proudu).
+     */
+    void reset();
+
+private:
+    int m_segmentSize;                  //!< Počet vzorků vyhodnocovaných segmentů.
+    float m_energyThreshold;            //!< Práh energie v dB.
+    float m_weakEnergyThreshold;        //!< Nižší práh energie v dB pro segmenty s mnoha průchody nulou.
+    float m_zeroCrossingThreshold;      //!< Práh četnosti průchodů nulou.
+    int m_hangover;                     //!< Počet segmentů doby hangover.
+    int m_hangoverLeft;                 //!< Počet zbývajících segmentů aktuální doby hangover.
+    float m_lastEnergy;                 //!< Energie naposledy vyhodnoceného segmentu v dB.
+    float m_lastZeroCrossingRate;       //!< Četnost průchodů nulou naposledy vyhodnoceného segmentu.
+
+signals:
+    /*!
+     * \brief error Signál, který je emitován při chybě.
+     * \param message Popis chyby.
+     */
+    void error(QString message);
+};
+
+#endif
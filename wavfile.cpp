@@ -0,0 +1,78 @@
+#include "wavfile.h"
+
+#include <QFile>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace {
+
+const int BLOCK_SAMPLES = 4096;     // počet vzorků převáděných najednou
+
+}
+
+WavFile::WavFile(const QString &fileName, QObject *parent) : QObject(parent) {
+    setWavFile(fileName);
+}
+
+void WavFile::setWavFile(const QString &fileName) {
+    m_fileName = fileName;
+}
+
+bool WavFile::write(const sample *audio, int count, int sampleRate) {
+    if ((audio == nullptr && count > 0) || count < 0 || sampleRate <= 0) {
+        emit error("WavFile::write: Neplatné vzorky nebo frekvence vzorkování.");
+        return false;
+    }
+
+    PE_STAGE_BEGIN(FileWrite);
+
+    QFile file(m_fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        emit error("WavFile::write: Do souboru " + m_fileName + " nelze zapisovat.");
+        return false;
+    }
+
+    const quint16 blockAlign = sizeof(qint16);
+    const quint32 dataBytes = static_cast<quint32>(count) * blockAlign;
+
+    uchar header[WAV_HEADER_SIZE];
+    memcpy(header, "RIFF", 4);
+    qToLittleEndian<quint32>(WAV_HEADER_SIZE - 8 + dataBytes, header + 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    qToLittleEndian<quint32>(16, header + 16);                                      // velikost bloku fmt
+    qToLittleEndian<quint16>(1, header + 20);                                       // PCM
+    qToLittleEndian<quint16>(1, header + 22);                                       // počet kanálů
+    qToLittleEndian<quint32>(static_cast<quint32>(sampleRate), header + 24);
+    qToLittleEndian<quint32>(static_cast<quint32>(sampleRate) * blockAlign, header + 28);
+    qToLittleEndian<quint16>(blockAlign, header + 32);
+    qToLittleEndian<quint16>(16, header + 34);                                      // bitů na vzorek
+    memcpy(header + 36, "data", 4);
+    qToLittleEndian<quint32>(dataBytes, header + 40);
+
+    bool ok = file.write(reinterpret_cast<const char *>(header), WAV_HEADER_SIZE) == WAV_HEADER_SIZE;
+
+    /* Vzorky jsou převáděny po blocích přes pracovní buffer a zapsány jednou operací na blok. */
+    QVector<qint16> block(qMin(count, BLOCK_SAMPLES));
+
+    for (int begin = 0; ok && begin < count; begin += BLOCK_SAMPLES) {
+        int size = qMin(BLOCK_SAMPLES, count - begin);
+
+        for (int i = 0; i < size; i++)
+            block[i] = qToLittleEndian<qint16>(static_cast<qint16>(audio[begin + i]));
+
+        qint64 bytes = static_cast<qint64>(size) * blockAlign;
+        ok = file.write(reinterpret_cast<const char *>(block.constData()), bytes) == bytes;
+    }
+
+    if (!ok) {
+        emit error("WavFile::write: Zápis do souboru " + m_fileName + " selhal.");
+        return false;
+    }
+
+    return true;
+}
+
+bool WavFile::write(const QVector<sample> &audio, int sampleRate) {
+    return write(audio.constData(), audio.size(), sampleRate);
+}
@@ -0,0 +1,70 @@
+#ifndef WAVFILE_H
+#define WAVFILE_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include "pe_config.h"
+#include "instrumentation.h"
+
+/*!
+ * Velikost hlavičky zapisovaného souboru WAV v bytech (RIFF, fmt a data).
+ */
+#define WAV_HEADER_SIZE 44
+
+/*!
+ * \brief Třída WavFile
+ *
+ * Třída zapisuje jednokanálový akustický signál do souboru WAV (RIFF, 16bitové PCM, malý endian). Hlavička má
+ * nejjednodušší tvar: blok "fmt " o 16 B následovaný blokem "data", celkem WAV_HEADER_SIZE bytů. Vzorky jsou
+ * převáděny do malého endianu po blocích a každý blok je zapsán jednou operací.
+ *
+ * Čtení vstupních souborů (včetně vícekanálových a WAVE_FORMAT_EXTENSIBLE) zajišťuje OfflineExtractor.
+ */
+class WavFile : public QObject {
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief WavFile Konstruktor třídy.
+     * \param fileName Cesta k souboru WAV.
+     * \param parent Ukazatel na rodiče objektu (kvůli dynamickému uvolnění).
+     */
+    explicit WavFile(const QString &fileName, QObject *parent = nullptr);
+
+    /*!
+     * \brief setWavFile Metoda nastaví objektu cestu k souboru.
+     * \param fileName Cesta k souboru WAV.
+     */
+    void setWavFile(const QString &fileName);
+
+    /*!
+     * \brief write Metoda zapíše vzorky signálu do souboru (existující soubor je přepsán).
+     * \param audio Ukazatel na vzorky signálu.
+     * \param count Počet vzorků.
+     * \param sampleRate Frekvence vzorkování.
+     * \return True, pokud byl zápis úspěšný, jinak false (a je emitován signál error).
+     */
+    bool write(const sample *audio, int count, int sampleRate = SAMPLE_RATE);
+
+    /*!
+     * \brief write Přetížená metoda, která zapíše celý vektor vzorků (např. výstup AudioScaler::scale).
+     * \param audio Vzorky signálu.
+     * \param sampleRate Frekvence vzorkování.
+     * \return True, pokud byl zápis úspěšný, jinak false (a je emitován signál error).
+     */
+    bool write(const QVector<sample> &audio, int sampleRate = SAMPLE_RATE);
+
+private:
+    QString m_fileName;     //!< Cesta k souboru WAV.
+
+signals:
+    /*!
+     * \brief error Signál, který je emitován při chybě.
+     * \param message Popis chyby.
+     */
+    void error(QString message);
+};
+
+#endif
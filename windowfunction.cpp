@@ -13,10 +13,10 @@ QVector<float> WindowFunction::normalize(const QVector<sample> &segment) {
     if (segment.size() != m_window.size())
         return QVector<float>();
 
-    QVector<float> normalized(segment.size());
+    PE_STAGE_BEGIN(Windowing);
 
-    for (int i = 0; i < segment.size(); i++)
-        normalized[i] = (float)segment[i] * m_window[i];
+    QVector<float> normalized(segment.size());
+    WindowTable::apply(m_window.constData(), segment.constData(), normalized.data(), segment.size());
 
     return normalized;
 }
@@ -33,3 +33,6 @@ QVector<float> WindowFunction::denormalize(const QVector<float> &segment) {
     return normalized;
 }
 
+const QVector<float> &WindowFunction::coefficients() const {
+    return m_window;
+}
@@ -5,11 +5,14 @@
 #include <QVector>
 
 #include "pe_config.h"
+#include "instrumentation.h"
+#include "windowtable.h"
 
 /*!
  * \brief Třída WindowFunction
  *
- * Třída reprezentuje obecnou váhovací funkci pro normalizaci vstupních segmentů akustického signálu.
+ * Třída reprezentuje obecnou váhovací funkci pro normalizaci vstupních segmentů akustického signálu. Konkrétní
+ * okna (HammingWindow, StandardWindow) kopírují své vzorky ze sdílených tabulek WindowTable.
  */
 class WindowFunction : public QObject {
     Q_OBJECT
@@ -47,6 +50,13 @@ public:
      */
     QVector<float> denormalize(const QVector<float> &segment);
 
+    /*!
+     * \brief coefficients Metoda vrací vzorky váhovacího okna. Využívá se v případech, kdy je okno aplikováno
+     *                     mimo tuto třídu (viz FrameKernel).
+     * \return Konstantní reference na vektor vzorků váhovacího okna.
+     */
+    const QVector<float> &coefficients() const;
+
 protected:
     /*!
      * \brief initWindow Virtuální metoda, jejíž úlohou je vypočítat vzorky daného normalizačního okna
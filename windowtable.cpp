@@ -0,0 +1,162 @@
+#include "windowtable.h"
+#include "hammingwindow.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtMath>
+
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+/* Klíč tabulky ve vyrovnávací paměti. */
+struct WindowKey {
+    int type;
+    int size;
+    float parameter;
+
+    bool operator==(const WindowKey &other) const {
+        return type == other.type && size == other.size && parameter == other.parameter;
+    }
+
+    bool operator<(const WindowKey &other) const {
+        if (type != other.type)
+            return type < other.type;
+
+        return (size != other.size) ? size < other.size : parameter < other.parameter;
+    }
+};
+
+inline uint qHash(const WindowKey &key, uint seed = 0) {
+    quint32 parameterBits;
+    memcpy(&parameterBits, &key.parameter, sizeof(parameterBits));
+
+    return (static_cast<uint>(key.type) * 31u + static_cast<uint>(key.size)) * 2654435761u ^ parameterBits ^ seed;
+}
+
+/* Tabulky jsou uvolněny až při ukončení procesu. */
+struct WindowCache {
+    QMutex mutex;
+    QHash<WindowKey, float *> tables;
+
+    ~WindowCache() {
+        for (float *table : tables.values())
+            qFreeAligned(table);
+    }
+};
+
+WindowCache &windowCache() {
+    static WindowCache cache;
+    return cache;
+}
+
+}
+
+const float *WindowTable::get(Type type, int size, float parameter) {
+    if (size <= 1 || type < Rectangular || type > Kaiser)
+        return nullptr;
+
+    if (type == Rectangular || type == Hamming || type == Hann)
+        parameter = 0.0f; // okna bez parametru
+    else if (parameter == WINDOW_DEFAULT_PARAMETER)
+        parameter = defaultParameter(type);
+
+    WindowKey key = {type, size, parameter};
+    WindowCache &cache = windowCache();
+    QMutexLocker locker(&cache.mutex);
+
+    float *table = cache.tables.value(key, nullptr);
+    if (table)
+        return table;
+
+    table = static_cast<float *>(qMallocAligned(size * sizeof(float), 32));
+    if (!table)
+        return nullptr;
+
+    compute(type, size, parameter, table);
+    cache.tables.insert(key, table);
+    return table;
+}
+
+float WindowTable::defaultParameter(Type type) {
+    switch (type) {
+    case Blackman:
+        return 0.42f;
+    case Povey:
+        return 0.85f;
+    case Kaiser:
+        return 8.6f;
+    default:
+        return 0.0f;
+    }
+}
+
+double WindowTable::besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+
+        if (term < sum * 1e-12)
+            break;
+    }
+
+    return sum;
+}
+
+void WindowTable::compute(Type type, int size, float parameter, float *window) {
+    for (int n = 0; n < size; n++) {
+        double phase = (2 * M_PI * n) / (size - 1);
+
+        switch (type) {
+        case Rectangular:
+            window[n] = 1.0f;
+            break;
+        case Hamming:
+            // stejný výraz jako původní HammingWindow::initWindow
+            window[n] = ALPHA - BETA * qCos(phase);
+            break;
+        case Hann:
+            window[n] = 0.5 - 0.5 * qCos(phase);
+            break;
+        case Blackman:
+            window[n] = parameter - 0.5 * qCos(phase) + (0.5 - parameter) * qCos(2 * phase);
+            break;
+        case Povey:
+            window[n] = qPow(0.5 - 0.5 * qCos(phase), static_cast<double>(parameter));
+            break;
+        case Kaiser: {
+            double ratio = (2.0 * n) / (size - 1) - 1.0;
+            window[n] = besselI0(parameter * qSqrt(qMax(0.0, 1.0 - ratio * ratio))) / besselI0(parameter);
+            break;
+        }
+        }
+    }
+}
+
+void WindowTable::apply(const float *window, const sample *segment, float *output, int size) {
+    int i = 0;
+
+#ifdef __SSE2__
+    for (; i + 8 <= size; i += 8) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(segment + i));
+
+        // rozšíření 16 -> 32 bitů se znaménkem: vzorek do horní poloviny a aritmetický posun zpět
+        __m128 low = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16));
+        __m128 high = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16));
+
+        _mm_storeu_ps(output + i, _mm_mul_ps(low, _mm_loadu_ps(window + i)));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(high, _mm_loadu_ps(window + i + 4)));
+    }
+#endif
+
+    for (; i < size; i++)
+        output[i] = static_cast<float>(segment[i]) * window[i];
+}
@@ -0,0 +1,82 @@
+#ifndef WINDOWTABLE_H
+#define WINDOWTABLE_H
+
+#include <QtGlobal>
+
+#include "pe_config.h"
+
+/*!
+ * Hodnota parametru okna, která označuje výchozí parametr daného typu okna (viz WindowTable::defaultParameter).
+ */
+#define WINDOW_DEFAULT_PARAMETER -1.0f
+
+/*!
+ * \brief Třída WindowTable
+ *
+ * Třída spravuje sdílenou (pro celý proces) vyrovnávací paměť tabulek váhovacích oken. Tabulka je pro každou trojici
+ * (typ, velikost, parametr) spočtena pouze jednou, uložena do paměti zarovnané na 32 B a až do ukončení procesu se
+ * nemění ani neuvolňuje. Všechny instance oken (WindowFunction) a výpočty (FrameKernel) se stejnými parametry tak
+ * sdílejí jedinou tabulku a vytvoření dalšího okna nestojí žádný výpočet kosinů. Metoda get je bezpečná pro volání
+ * z více vláken.
+ *
+ * Všechna okna jsou symetrická (dělení velikostí - 1), stejně jako původní Hammingovo okno knihovny.
+ */
+class WindowTable {
+
+public:
+    /*!
+     * \brief Type Typ váhovacího okna.
+     */
+    enum Type {
+        Rectangular,    //!< Obdélníkové okno (bez váhování).
+        Hamming,        //!< Hammingovo okno s koeficienty ALPHA a BETA (viz hammingwindow.h).
+        Hann,           //!< Hannovo okno.
+        Blackman,       //!< Blackmanovo okno, parametr je koeficient a0 (výchozí 0,42).
+        Povey,          //!< Okno z nástroje Kaldi, Hannovo okno umocněné na parametr (výchozí 0,85).
+        Kaiser          //!< Kaiserovo okno, parametr je beta (výchozí 8,6).
+    };
+
+    /*!
+     * \brief get Vrátí tabulku okna daného typu, velikosti a parametru. Při prvním požadavku je tabulka spočtena.
+     * \param type Typ okna.
+     * \param size Počet vzorků okna (alespoň 2).
+     * \param parameter Parametr okna (WINDOW_DEFAULT_PARAMETER pro výchozí hodnotu, u oken bez parametru se ignoruje).
+     * \return Ukazatel na size vzorků okna platný po celou dobu běhu procesu, nebo nullptr při neplatných parametrech.
+     */
+    static const float *get(Type type, int size, float parameter = WINDOW_DEFAULT_PARAMETER);
+
+    /*!
+     * \brief defaultParameter Vrací výchozí parametr daného typu okna.
+     * \param type Typ okna.
+     * \return Výchozí parametr (0 u oken bez parametru).
+     */
+    static float defaultParameter(Type type);
+
+    /*!
+     * \brief apply Převede vzorky typu sample na float a vynásobí je oknem (SSE2, bez mezilehlého pole).
+     * \param window Ukazatel na vzorky okna.
+     * \param segment Ukazatel na vstupní vzorky.
+     * \param output Ukazatel na pole pro size výsledných vzorků.
+     * \param size Počet vzorků.
+     */
+    static void apply(const float *window, const sample *segment, float *output, int size);
+
+    /*!
+     * \brief besselI0 Modifikovaná Besselova funkce prvního druhu nultého řádu (pro Kaiserovo okno).
+     * \param x Argument funkce.
+     * \return Hodnota funkce.
+     */
+    static double besselI0(double x);
+
+private:
+    /*!
+     * \brief compute Spočítá vzorky okna.
+     * \param type Typ okna.
+     * \param size Počet vzorků okna.
+     * \param parameter Parametr okna (již nahrazený výchozí hodnotou).
+     * \param window Pole pro size vzorků okna.
+     */
+    static void compute(Type type, int size, float parameter, float *window);
+};
+
+#endif